@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSAI/FPSBotController.h"
+
+AFPSBotController::AFPSBotController()
+{
+    // 数百个机器人时逐个 Tick 的开销不可忽略，统一由管理子系统驱动
+    PrimaryActorTick.bCanEverTick = false;
+
+    // 控制旋转由 AFPSCharacter::Look 修改，不随角色朝向或焦点重置
+    bSetControlRotationFromPawnOrientation = false;
+
+    // 机器人不需要 PlayerState，减少服务器上需要复制的 Actor
+    bWantsPlayerState = false;
+}
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AIController.h"
+#include "FPSBotController.generated.h"
+
+/**
+ * AFPSBotController
+ * 压力测试机器人的控制器。
+ * 本身不 Tick，感知、寻路与操控全部由 UFPSBotManagerSubsystem 集中分时执行，
+ * 并通过 AFPSCharacter 的 Move / Look / StartJump / Shoot 与玩家输入走同一条路径。
+ */
+UCLASS()
+class FPSDEMO_API AFPSBotController : public AAIController
+{
+    GENERATED_BODY()
+
+public:
+    AFPSBotController();
+};
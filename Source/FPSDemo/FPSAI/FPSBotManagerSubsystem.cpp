@@ -0,0 +1,694 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSAI/FPSBotManagerSubsystem.h"
+#include "FPSAI/FPSBotController.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSWeapon/FPSBallistics.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "InputActionValue.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NavigationSystem.h"
+
+static TAutoConsoleVariable<float> CVarBotThinkBudgetMs(
+    TEXT("fps.Bots.ThinkBudgetMs"),
+    0.5f,
+    TEXT("机器人思考（视线检测、取点与发起寻路）每帧的时间预算（毫秒）。超出后剩余的机器人顺延到下一帧。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBotThinkInterval(
+    TEXT("fps.Bots.ThinkInterval"),
+    0.25f,
+    TEXT("单个机器人两次思考的间隔（秒）。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarBotMaxPathQueriesPerFrame(
+    TEXT("fps.Bots.MaxPathQueriesPerFrame"),
+    4,
+    TEXT("每帧最多发起的异步寻路请求数。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBotReportInterval(
+    TEXT("fps.Bots.ReportInterval"),
+    5.0f,
+    TEXT("输出机器人 AI 耗时报告的间隔（秒），0 表示不输出。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Bots.Report
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GBotReportCommand(
+    TEXT("fps.Bots.Report"),
+    TEXT("输出机器人数量、AI 耗时及其占游戏线程帧时间的比例。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSBotManagerSubsystem* BotManager = World ? World->GetSubsystem<UFPSBotManagerSubsystem>() : nullptr)
+        {
+            BotManager->LogReport();
+        }
+    }));
+
+namespace FPSBots
+{
+    /* 视线检测与取点半径（cm） */
+    static constexpr float RoamRadius = 3000.0f;
+    static constexpr float PathAcceptRadius = 100.0f;
+
+    /* 每思考一次最多检测视线的候选目标数 */
+    static constexpr int32 MaxSightChecks = 2;
+
+    /* 转向速度（度/秒） */
+    static constexpr float TurnRate = 360.0f;
+
+    /* 每一级开始后跳过的时间，避免把生成机器人的峰值计入结果 */
+    static constexpr double StageSettleSeconds = 1.0;
+
+    /* 攻击性越高，发现目标的距离越远、瞄准越准、越倾向于逼近 */
+    static float EngageRange(float Aggression) { return FMath::Lerp(2000.0f, 6000.0f, Aggression); }
+    static float AimErrorDegrees(float Aggression) { return FMath::Lerp(6.0f, 1.5f, Aggression); }
+    static float FireConeDegrees(float Aggression) { return FMath::Lerp(10.0f, 4.0f, Aggression); }
+    static float HoldDistance(float Aggression) { return FMath::Lerp(2000.0f, 600.0f, Aggression); }
+}
+
+// ------------------------------------------------------------------
+// 仅在命令行带 -FPSBots=N 时创建
+// ------------------------------------------------------------------
+bool UFPSBotManagerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    int32 Count = 0;
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Value(FCommandLine::Get(), TEXT("FPSBots="), Count) && Count > 0;
+}
+
+bool UFPSBotManagerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSBotManagerSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSBotManagerSubsystem, STATGROUP_Tickables);
+}
+
+// ------------------------------------------------------------------
+// 关卡开始：读取参数并生成第一批机器人（客户端上不生成）
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (InWorld.GetNetMode() == NM_Client)
+    {
+        return;
+    }
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+    FParse::Value(CommandLine, TEXT("FPSBots="), TargetBotCount);
+    FParse::Value(CommandLine, TEXT("BotAggression="), Aggression);
+    FParse::Value(CommandLine, TEXT("BotFireRate="), TriggerRate);
+    FParse::Value(CommandLine, TEXT("BotRampStep="), RampStep);
+    FParse::Value(CommandLine, TEXT("BotRampSeconds="), RampStageSeconds);
+    if (!FParse::Value(CommandLine, TEXT("BotCSV="), CSVPath))
+    {
+        CSVPath = FPaths::ProfilingDir() / FString::Printf(TEXT("FPSBots_%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    TargetBotCount = FMath::Max(TargetBotCount, 0);
+    Aggression = FMath::Clamp(Aggression, 0.0f, 1.0f);
+    TriggerRate = FMath::Max(TriggerRate, 0.1f);
+    RampStep = FMath::Clamp(RampStep, 0, TargetBotCount);
+    RampStageSeconds = FMath::Max(RampStageSeconds, static_cast<float>(FPSBots::StageSettleSeconds) + 1.0f);
+
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSBots: map=%s bots=%d aggression=%.2f fireRate=%.1f rampStep=%d rampSeconds=%.1f csv=%s"),
+        *InWorld.GetMapName(), TargetBotCount, Aggression, TriggerRate, RampStep, RampStageSeconds, *CSVPath);
+
+    FCoreDelegates::OnBeginFrame.AddUObject(this, &UFPSBotManagerSubsystem::OnBeginFrame);
+    FCoreDelegates::OnEndFrame.AddUObject(this, &UFPSBotManagerSubsystem::OnEndFrame);
+
+    Bots.Reserve(TargetBotCount);
+    BotCharacters.Reserve(TargetBotCount);
+    SpawnBots(RampStep > 0 ? RampStep : TargetBotCount);
+
+    StageStartTime = LastReportTime = FPlatformTime::Seconds();
+}
+
+void UFPSBotManagerSubsystem::Deinitialize()
+{
+    FCoreDelegates::OnBeginFrame.RemoveAll(this);
+    FCoreDelegates::OnEndFrame.RemoveAll(this);
+
+    // 爬升未完成时也保留已测得的结果
+    if (!bRampFinished && RampRows.Num() > 0)
+    {
+        WriteRampCSV();
+    }
+
+    DEC_DWORD_STAT_BY(STAT_FPSBots, Bots.Num());
+    Bots.Empty();
+    BotCharacters.Empty();
+    PathQueryToBot.Empty();
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 生成机器人：在玩家出生点附近的导航网格上随机取点，由 AFPSBotController 占有
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::SpawnBots(int32 Count)
+{
+    UWorld* World = GetWorld();
+
+    // 优先使用游戏模式配置的默认角色（蓝图中设置了子弹类、网格等）
+    UClass* BotClass = AFPSCharacter::StaticClass();
+    if (const AGameModeBase* GameMode = World->GetAuthGameMode())
+    {
+        if (GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AFPSCharacter::StaticClass()))
+        {
+            BotClass = GameMode->DefaultPawnClass;
+        }
+    }
+
+    TArray<FVector, TInlineAllocator<8>> Origins;
+    for (TActorIterator<APlayerStart> It(World); It; ++It)
+    {
+        Origins.Add(It->GetActorLocation());
+    }
+    if (Origins.Num() == 0)
+    {
+        Origins.Add(FVector(0.0f, 0.0f, 200.0f));
+    }
+
+    const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+    const float HalfHeight = BotClass->GetDefaultObject<AFPSCharacter>()->GetCapsuleComponent()->GetScaledCapsuleHalfHeight();
+    const double Now = World->GetTimeSeconds();
+    const float ThinkInterval = CVarBotThinkInterval.GetValueOnGameThread();
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+    int32 NumSpawned = 0;
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const FVector& Origin = Origins[Bots.Num() % Origins.Num()];
+
+        FVector Location = Origin + FVector(FMath::FRandRange(-1.0f, 1.0f), FMath::FRandRange(-1.0f, 1.0f), 0.0f) * 1000.0f;
+        FNavLocation NavLocation;
+        if (NavSys && NavSys->GetRandomReachablePointInRadius(Origin, FPSBots::RoamRadius, NavLocation))
+        {
+            Location = NavLocation.Location + FVector(0.0f, 0.0f, HalfHeight);
+        }
+
+        const FRotator Rotation(0.0f, FMath::FRandRange(-180.0f, 180.0f), 0.0f);
+        AFPSCharacter* Character = World->SpawnActor<AFPSCharacter>(BotClass, Location, Rotation, SpawnParams);
+        if (!Character)
+        {
+            continue;
+        }
+
+        AFPSBotController* Controller = World->SpawnActor<AFPSBotController>(Location, Rotation, SpawnParams);
+        Controller->Possess(Character);
+        Controller->SetControlRotation(Rotation);
+
+        FBotState& Bot = Bots.AddDefaulted_GetRef();
+        Bot.Character = Character;
+        Bot.Controller = Controller;
+        Bot.StrafeSign = FMath::RandBool() ? 1.0f : -1.0f;
+
+        // 错开各机器人的思考时间，避免同一帧集中思考
+        Bot.NextThinkTime = Now + FMath::FRand() * ThinkInterval;
+
+        BotCharacters.Add(Character);
+        ++NumSpawned;
+    }
+
+    INC_DWORD_STAT_BY(STAT_FPSBots, NumSpawned);
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSBots: spawned %d/%d bots of class %s, total %d"), NumSpawned, Count, *BotClass->GetName(), Bots.Num());
+}
+
+// ------------------------------------------------------------------
+// 每帧：分时思考 -> 操控全部机器人 -> 统计
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (Bots.Num() == 0)
+    {
+        return;
+    }
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    const double Now = GetWorld()->GetTimeSeconds();
+
+    FrameThinks = 0;
+    FramePathQueries = 0;
+
+    ThinkBots(Now);
+    SteerBots(DeltaTime, Now);
+
+    // 寻路结果回调发生在本次 Tick 之外，同样计入 AI 时间
+    const uint64 AICycles = FPlatformTime::Cycles64() - StartCycles + PathCallbackCycles;
+    PathCallbackCycles = 0;
+    AccumulateFrame(FPlatformTime::ToMilliseconds64(AICycles));
+
+    const double WallNow = FPlatformTime::Seconds();
+    if (!bRampFinished && WallNow - StageStartTime >= RampStageSeconds)
+    {
+        FinishRampStage();
+    }
+
+    const float ReportInterval = CVarBotReportInterval.GetValueOnGameThread();
+    if (ReportInterval > 0.0f && WallNow - LastReportTime >= ReportInterval)
+    {
+        LogReport();
+        ReportSample = FWindowSample();
+        LastReportTime = WallNow;
+    }
+}
+
+// ------------------------------------------------------------------
+// 思考：从上一帧停下的位置继续轮转，超出预算即停止（每帧至少处理一个）
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::ThinkBots(double Now)
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSBotThink);
+
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+    const uint64 BudgetCycles = static_cast<uint64>(CVarBotThinkBudgetMs.GetValueOnGameThread() / (FPlatformTime::GetSecondsPerCycle64() * 1000.0));
+    bool bGatheredTargets = false;
+
+    const int32 Num = Bots.Num();
+    for (int32 Visited = 0; Visited < Num; ++Visited)
+    {
+        const int32 Index = ThinkCursor;
+        FBotState& Bot = Bots[Index];
+
+        if (Bot.NextThinkTime <= Now)
+        {
+            if (FrameThinks > 0 && FPlatformTime::Cycles64() - StartCycles >= BudgetCycles)
+            {
+                break;
+            }
+
+            if (!bGatheredTargets)
+            {
+                GatherTargets();
+                bGatheredTargets = true;
+            }
+
+            ThinkBot(Bot, Now);
+            ++FrameThinks;
+        }
+
+        ThinkCursor = (Index + 1) % Num;
+    }
+
+    INC_DWORD_STAT_BY(STAT_FPSBotThinks, FrameThinks);
+}
+
+void UFPSBotManagerSubsystem::GatherTargets()
+{
+    TargetScratch.Reset();
+    for (TActorIterator<AFPSCharacter> It(GetWorld()); It; ++It)
+    {
+        if (IsValid(*It))
+        {
+            TargetScratch.Add(*It);
+        }
+    }
+}
+
+void UFPSBotManagerSubsystem::ThinkBot(FBotState& Bot, double Now)
+{
+    Bot.NextThinkTime = Now + CVarBotThinkInterval.GetValueOnGameThread() * FMath::FRandRange(0.8f, 1.2f);
+
+    AFPSCharacter* Character = Bot.Character.Get();
+    if (!Character || !Bot.Controller.IsValid())
+    {
+        return;
+    }
+
+    const UWorld* World = GetWorld();
+    const FVector Eye = Character->GetPawnViewLocation();
+    const float EngageRangeSq = FMath::Square(FPSBots::EngageRange(Aggression));
+
+    // 由近到远检测少量候选目标的视线
+    AFPSCharacter* NewTarget = nullptr;
+    TArray<const AFPSCharacter*, TInlineAllocator<FPSBots::MaxSightChecks>> Checked;
+    for (int32 Check = 0; Check < FPSBots::MaxSightChecks && !NewTarget; ++Check)
+    {
+        AFPSCharacter* Nearest = nullptr;
+        float NearestDistSq = EngageRangeSq;
+        for (AFPSCharacter* Candidate : TargetScratch)
+        {
+            const float DistSq = FVector::DistSquared(Eye, Candidate->GetActorLocation());
+            if (Candidate != Character && DistSq < NearestDistSq && !Checked.Contains(Candidate))
+            {
+                Nearest = Candidate;
+                NearestDistSq = DistSq;
+            }
+        }
+
+        if (!Nearest)
+        {
+            break;
+        }
+        Checked.Add(Nearest);
+
+        FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSBotSight), false, Character);
+        QueryParams.AddIgnoredActor(Nearest);
+        if (!World->LineTraceTestByChannel(Eye, Nearest->GetPawnViewLocation(), ECC_Visibility, QueryParams))
+        {
+            NewTarget = Nearest;
+        }
+    }
+
+    const AFPSCharacter* LostTarget = NewTarget ? nullptr : Bot.Target.Get();
+    Bot.Target = NewTarget;
+
+    if (NewTarget)
+    {
+        const float AimError = FPSBots::AimErrorDegrees(Aggression);
+        Bot.AimError = FRotator(FMath::FRandRange(-AimError, AimError), FMath::FRandRange(-AimError, AimError), 0.0f);
+        return;
+    }
+
+    // 失去视线：攻击性高的机器人追向目标最后的位置
+    if (LostTarget && FMath::FRand() < Aggression)
+    {
+        RequestPath(Bot, LostTarget->GetActorLocation());
+        return;
+    }
+
+    // 没有目标且已走完路径：随机取点游走
+    if (!Bot.PathPoints.IsValidIndex(Bot.PathIndex) && Bot.PendingPathQuery == 0)
+    {
+        const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+        FNavLocation Destination;
+        if (NavSys && NavSys->GetRandomReachablePointInRadius(Character->GetNavAgentLocation(), FPSBots::RoamRadius, Destination))
+        {
+            RequestPath(Bot, Destination.Location);
+        }
+    }
+}
+
+// ------------------------------------------------------------------
+// 寻路：异步查询，结果在后续帧的回调中写回路径点
+// ------------------------------------------------------------------
+bool UFPSBotManagerSubsystem::RequestPath(FBotState& Bot, const FVector& Destination)
+{
+    // 超出本帧配额时放弃，下一次思考再试
+    if (FramePathQueries >= CVarBotMaxPathQueriesPerFrame.GetValueOnGameThread())
+    {
+        return false;
+    }
+
+    AFPSCharacter* Character = Bot.Character.Get();
+    UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+    if (!Character || !NavSys)
+    {
+        return false;
+    }
+
+    const FNavAgentProperties& AgentProperties = Character->GetNavAgentPropertiesRef();
+    const FVector Start = Character->GetNavAgentLocation();
+    const ANavigationData* NavData = NavSys->GetNavDataForProps(AgentProperties, Start);
+    if (!NavData)
+    {
+        return false;
+    }
+
+    FPathFindingQuery Query(Character, *NavData, Start, Destination);
+    const uint32 QueryId = NavSys->FindPathAsync(AgentProperties, Query,
+        FNavPathQueryDelegate::CreateUObject(this, &UFPSBotManagerSubsystem::OnPathFound), EPathFindingMode::Regular);
+    if (QueryId == INVALID_NAVQUERYID)
+    {
+        return false;
+    }
+
+    if (Bot.PendingPathQuery != 0)
+    {
+        PathQueryToBot.Remove(Bot.PendingPathQuery);
+    }
+
+    Bot.PendingPathQuery = QueryId;
+    PathQueryToBot.Add(QueryId, static_cast<int32>(&Bot - Bots.GetData()));
+
+    ++FramePathQueries;
+    INC_DWORD_STAT(STAT_FPSBotPathQueries);
+    return true;
+}
+
+void UFPSBotManagerSubsystem::OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+    const uint64 StartCycles = FPlatformTime::Cycles64();
+
+    int32 BotIndex = INDEX_NONE;
+    if (!PathQueryToBot.RemoveAndCopyValue(QueryId, BotIndex) || !Bots.IsValidIndex(BotIndex))
+    {
+        return;
+    }
+
+    FBotState& Bot = Bots[BotIndex];
+    Bot.PendingPathQuery = 0;
+
+    if (Result == ENavigationQueryResult::Success && Path.IsValid())
+    {
+        Bot.PathPoints.Reset();
+        for (const FNavPathPoint& Point : Path->GetPathPoints())
+        {
+            Bot.PathPoints.Add(Point.Location);
+        }
+
+        // 第一个点是起点
+        Bot.PathIndex = FMath::Min(1, Bot.PathPoints.Num());
+    }
+
+    PathCallbackCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+// ------------------------------------------------------------------
+// 操控：每帧为每个机器人生成与玩家相同的输入
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::SteerBots(float DeltaTime, double Now)
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSBotSteer);
+
+    for (FBotState& Bot : Bots)
+    {
+        SteerBot(Bot, DeltaTime, Now);
+    }
+}
+
+void UFPSBotManagerSubsystem::SteerBot(FBotState& Bot, float DeltaTime, double Now)
+{
+    AFPSCharacter* Character = Bot.Character.Get();
+    const AController* Controller = Bot.Controller.Get();
+    if (!Character || !Controller || Character->GetController() != Controller)
+    {
+        return;
+    }
+
+    // 上一帧起跳，本帧松开跳跃键
+    if (Bot.bJumping)
+    {
+        Character->StopJump(FInputActionValue(false));
+        Bot.bJumping = false;
+    }
+
+    const FRotator ControlRotation = Controller->GetControlRotation().GetNormalized();
+    FRotator LookDelta = FRotator::ZeroRotator;
+    FVector2D MoveInput = FVector2D::ZeroVector;
+
+    if (const AFPSCharacter* Target = Bot.Target.Get())
+    {
+        // 交战：转向目标（带瞄准偏差），进入射击锥内按节奏扣动扳机，同时横移并保持距离
+        const FVector ViewLocation = Character->GetPawnViewLocation();
+        const FVector ToTarget = Target->GetActorLocation() - ViewLocation;
+
+        // 实体子弹按解析弹道瞄准：移动目标的提前量与重力下坠补偿
+        FRotator AimRotation = ToTarget.Rotation();
+        FFPSBallisticParams Ballistics;
+        FFPSBallisticSolution Solution;
+        if (Character->GetBallisticParams(Ballistics)
+            && FPSBallistics::SolveIntercept(Ballistics, ViewLocation, Target->GetActorLocation(), Target->GetVelocity(), false, Solution))
+        {
+            AimRotation = Solution.Direction.Rotation();
+        }
+        LookDelta = (AimRotation + Bot.AimError - ControlRotation).GetNormalized();
+
+        const float FireCone = FPSBots::FireConeDegrees(Aggression);
+        if (FMath::Abs(LookDelta.Yaw) < FireCone && FMath::Abs(LookDelta.Pitch) < FireCone && Now >= Bot.NextTriggerTime)
+        {
+            Character->Shoot(FInputActionValue(true));
+            Bot.NextTriggerTime = Now + 1.0 / TriggerRate;
+        }
+
+        if (Now >= Bot.NextStrafeSwitchTime)
+        {
+            Bot.StrafeSign = -Bot.StrafeSign;
+            Bot.NextStrafeSwitchTime = Now + FMath::FRandRange(0.5f, 2.0f);
+        }
+
+        const float Distance = ToTarget.Size();
+        const float HoldDistance = FPSBots::HoldDistance(Aggression);
+        MoveInput.X = Bot.StrafeSign * Aggression;
+        MoveInput.Y = Distance > HoldDistance ? 1.0f : (Distance < HoldDistance * 0.5f ? -1.0f : 0.0f);
+    }
+    else if (Bot.PathPoints.IsValidIndex(Bot.PathIndex))
+    {
+        // 游走：转向下一个路径点并前进，视线回到水平
+        FVector ToPoint = Bot.PathPoints[Bot.PathIndex] - Character->GetActorLocation();
+        ToPoint.Z = 0.0f;
+
+        if (ToPoint.SizeSquared() < FMath::Square(FPSBots::PathAcceptRadius))
+        {
+            ++Bot.PathIndex;
+        }
+        else
+        {
+            const float RelativeYaw = FRotator::NormalizeAxis(ToPoint.Rotation().Yaw - ControlRotation.Yaw);
+            LookDelta = FRotator(-ControlRotation.Pitch, RelativeYaw, 0.0f);
+
+            // Move 以控制旋转为参考系：X 为右，Y 为前
+            const float RelativeYawRadians = FMath::DegreesToRadians(RelativeYaw);
+            MoveInput = FVector2D(FMath::Sin(RelativeYawRadians), FMath::Cos(RelativeYawRadians));
+        }
+    }
+
+    if (!LookDelta.IsNearlyZero(0.01f))
+    {
+        const float MaxTurn = FPSBots::TurnRate * DeltaTime;
+        Character->Look(FInputActionValue(FVector2D(
+            FMath::Clamp(LookDelta.Yaw, -MaxTurn, MaxTurn),
+            -FMath::Clamp(LookDelta.Pitch, -MaxTurn, MaxTurn))));
+    }
+
+    if (MoveInput.IsNearlyZero())
+    {
+        Bot.StuckSeconds = 0.0f;
+        return;
+    }
+
+    Character->Move(FInputActionValue(MoveInput));
+
+    // 有移动输入却几乎不动：跳跃越过障碍，并放弃当前路径
+    if (Character->GetVelocity().SizeSquared2D() < FMath::Square(50.0f))
+    {
+        Bot.StuckSeconds += DeltaTime;
+    }
+    else
+    {
+        Bot.StuckSeconds = 0.0f;
+    }
+
+    if (Bot.StuckSeconds > 0.5f)
+    {
+        Character->StartJump(FInputActionValue(true));
+        Bot.bJumping = true;
+        Bot.StuckSeconds = 0.0f;
+        Bot.PathPoints.Reset();
+    }
+}
+
+// ------------------------------------------------------------------
+// 统计：游戏线程帧时间（OnBeginFrame 与 OnEndFrame 之间）
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::OnBeginFrame()
+{
+    BeginFrameCycles = FPlatformTime::Cycles64();
+}
+
+void UFPSBotManagerSubsystem::OnEndFrame()
+{
+    if (BeginFrameCycles != 0)
+    {
+        LastGameThreadMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - BeginFrameCycles);
+    }
+}
+
+void UFPSBotManagerSubsystem::AccumulateFrame(double AIMs)
+{
+    const auto Accumulate = [this, AIMs](FWindowSample& Sample)
+    {
+        ++Sample.Frames;
+        Sample.FrameMsSum += LastGameThreadMs;
+        Sample.AIMsSum += AIMs;
+        Sample.AIMsMax = FMath::Max(Sample.AIMsMax, AIMs);
+        Sample.Thinks += FrameThinks;
+        Sample.PathQueries += FramePathQueries;
+    };
+
+    Accumulate(ReportSample);
+
+    // 每一级开始后的一段时间不计入，避免生成机器人的峰值
+    if (!bRampFinished && FPlatformTime::Seconds() - StageStartTime >= FPSBots::StageSettleSeconds)
+    {
+        Accumulate(StageSample);
+    }
+}
+
+// ------------------------------------------------------------------
+// 逐级爬升：记录本级结果，继续增加机器人或写出 CSV
+// ------------------------------------------------------------------
+void UFPSBotManagerSubsystem::FinishRampStage()
+{
+    FRampRow& Row = RampRows.AddDefaulted_GetRef();
+    Row.Bots = Bots.Num();
+    Row.Sample = StageSample;
+
+    const double Frames = FMath::Max(StageSample.Frames, 1);
+    const double FrameMs = StageSample.FrameMsSum / Frames;
+    const double AIMs = StageSample.AIMsSum / Frames;
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSBots: stage bots=%d frame=%.2fms ai=%.3fms (%.1f%% of frame, %.2fus/bot)"),
+        Row.Bots, FrameMs, AIMs, FrameMs > 0.0 ? AIMs / FrameMs * 100.0 : 0.0, Row.Bots > 0 ? AIMs * 1000.0 / Row.Bots : 0.0);
+
+    StageSample = FWindowSample();
+    StageStartTime = FPlatformTime::Seconds();
+
+    if (RampStep > 0 && Bots.Num() < TargetBotCount)
+    {
+        SpawnBots(FMath::Min(RampStep, TargetBotCount - Bots.Num()));
+        return;
+    }
+
+    bRampFinished = true;
+    WriteRampCSV();
+}
+
+void UFPSBotManagerSubsystem::WriteRampCSV() const
+{
+    FString CSV = TEXT("Bots,Frames,GameThreadMsAvg,AIMsAvg,AIMsMax,AISharePct,AIUsPerBot,ThinksPerFrame,PathQueriesPerFrame\n");
+    for (const FRampRow& Row : RampRows)
+    {
+        const FWindowSample& Sample = Row.Sample;
+        const double Frames = FMath::Max(Sample.Frames, 1);
+        const double FrameMs = Sample.FrameMsSum / Frames;
+        const double AIMs = Sample.AIMsSum / Frames;
+        CSV += FString::Printf(TEXT("%d,%d,%.3f,%.4f,%.4f,%.2f,%.3f,%.2f,%.3f\n"),
+            Row.Bots, Sample.Frames, FrameMs, AIMs, Sample.AIMsMax, FrameMs > 0.0 ? AIMs / FrameMs * 100.0 : 0.0,
+            Row.Bots > 0 ? AIMs * 1000.0 / Row.Bots : 0.0, Sample.Thinks / Frames, Sample.PathQueries / Frames);
+    }
+
+    const bool bWritten = FFileHelper::SaveStringToFile(CSV, *CSVPath);
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSBots: %s %s (%d stages)"), bWritten ? TEXT("wrote") : TEXT("FAILED to write"), *CSVPath, RampRows.Num());
+}
+
+void UFPSBotManagerSubsystem::LogReport() const
+{
+    const double Frames = FMath::Max(ReportSample.Frames, 1);
+    const double FrameMs = ReportSample.FrameMsSum / Frames;
+    const double AIMs = ReportSample.AIMsSum / Frames;
+
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSBots: bots=%d frame=%.2fms ai=%.3fms max=%.3fms (%.1f%% of frame) thinks/frame=%.1f pathQueries/frame=%.2f"),
+        Bots.Num(), FrameMs, AIMs, ReportSample.AIMsMax, FrameMs > 0.0 ? AIMs / FrameMs * 100.0 : 0.0,
+        ReportSample.Thinks / Frames, ReportSample.PathQueries / Frames);
+}
@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "FPSBotManagerSubsystem.generated.h"
+
+class AFPSCharacter;
+class AFPSBotController;
+
+/**
+ * UFPSBotManagerSubsystem
+ * 无人值守的机器人负载生成器：在服务器（或单机）上生成 N 个由 AFPSBotController 控制的 AFPSCharacter，
+ * 让它们寻路游走、互相索敌并开火，用于在没有真人玩家时压测服务器。
+ *
+ * 每帧的 AI 开销分为两部分：
+ *   - 操控（每帧、每个机器人）：沿路径移动、转向目标、按节奏扣动扳机，只做少量向量运算；
+ *   - 思考（分时）：视线检测选择目标、随机取点并发起异步寻路。按轮转顺序执行，
+ *     每帧在 fps.Bots.ThinkBudgetMs 预算内尽量多处理，超出预算的机器人顺延到下一帧。
+ *
+ * 仅在命令行带 -FPSBots=N 时创建，例如：
+ *   UnrealEditor FPSDemo.uproject /Game/001_Maps/FPSMap -server -nullrhi -unattended
+ *       -FPSBots=200 -BotAggression=0.7 -BotFireRate=4 -BotRampStep=25 -BotRampSeconds=10 -BotCSV=Saved/Profiling/Bots.csv
+ * 带 -BotRampStep 时按步长逐级增加机器人，每级结束记录一行 AI 耗时占帧时间的比例并写入 CSV。
+ */
+UCLASS()
+class FPSDEMO_API UFPSBotManagerSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /* 当前机器人数量 */
+    int32 GetNumBots() const { return Bots.Num(); }
+
+    /* 输出当前统计窗口内的 AI 耗时与帧时间 */
+    void LogReport() const;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /* 单个机器人的状态 */
+    struct FBotState
+    {
+        TWeakObjectPtr<AFPSCharacter> Character;
+        TWeakObjectPtr<AFPSBotController> Controller;
+
+        /* 当前目标（思考时更新） */
+        TWeakObjectPtr<AFPSCharacter> Target;
+
+        /* 当前路径点与下一个要到达的点 */
+        TArray<FVector> PathPoints;
+        int32 PathIndex = 0;
+
+        /* 未完成的异步寻路请求，0 表示没有 */
+        uint32 PendingPathQuery = 0;
+
+        /* 下一次思考与下一次扣动扳机的时间 */
+        double NextThinkTime = 0.0;
+        double NextTriggerTime = 0.0;
+
+        /* 交战时的横移方向（±1），以及下一次换向的时间 */
+        float StrafeSign = 1.0f;
+        double NextStrafeSwitchTime = 0.0;
+
+        /* 瞄准偏差（每次思考重新取随机值） */
+        FRotator AimError = FRotator::ZeroRotator;
+
+        /* 卡住检测与跳跃 */
+        float StuckSeconds = 0.0f;
+        bool bJumping = false;
+    };
+
+    /* 一个统计窗口内的累计值 */
+    struct FWindowSample
+    {
+        int32 Frames = 0;
+        double FrameMsSum = 0.0;
+        double AIMsSum = 0.0;
+        double AIMsMax = 0.0;
+        int32 Thinks = 0;
+        int32 PathQueries = 0;
+    };
+
+    /* 生成 Count 个机器人 */
+    void SpawnBots(int32 Count);
+
+    /* 分时思考：在预算内处理尽可能多的机器人 */
+    void ThinkBots(double Now);
+    void GatherTargets();
+    void ThinkBot(FBotState& Bot, double Now);
+
+    /* 每帧操控：转向、移动与开火 */
+    void SteerBots(float DeltaTime, double Now);
+    void SteerBot(FBotState& Bot, float DeltaTime, double Now);
+
+    /* 发起异步寻路 */
+    bool RequestPath(FBotState& Bot, const FVector& Destination);
+    void OnPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+    /* 统计：帧开始/结束时间与逐级爬升 */
+    void OnBeginFrame();
+    void OnEndFrame();
+    void AccumulateFrame(double AIMs);
+    void FinishRampStage();
+    void WriteRampCSV() const;
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AFPSCharacter>> BotCharacters;
+
+    TArray<FBotState> Bots;
+
+    /* 异步寻路请求 -> 机器人下标 */
+    TMap<uint32, int32> PathQueryToBot;
+
+    /* 本帧可作为目标的角色（机器人与玩家） */
+    TArray<AFPSCharacter*> TargetScratch;
+
+    /* 下一个轮到思考的机器人 */
+    int32 ThinkCursor = 0;
+
+    /* 本帧的思考与寻路次数 */
+    int32 FrameThinks = 0;
+    int32 FramePathQueries = 0;
+
+    /* 命令行参数 */
+    int32 TargetBotCount = 0;
+    float Aggression = 0.5f;
+    float TriggerRate = 4.0f;
+    int32 RampStep = 0;
+    float RampStageSeconds = 10.0f;
+    FString CSVPath;
+
+    /* 游戏线程帧时间（不含帧率限制造成的空闲） */
+    uint64 BeginFrameCycles = 0;
+    double LastGameThreadMs = 0.0;
+
+    /* 本帧路径回调的耗时，计入下一次 Tick 的 AI 时间 */
+    uint64 PathCallbackCycles = 0;
+
+    /* 当前逐级爬升阶段与定期报告的统计窗口 */
+    FWindowSample StageSample;
+    FWindowSample ReportSample;
+    double StageStartTime = 0.0;
+    double LastReportTime = 0.0;
+    bool bRampFinished = false;
+
+    /* 每一级的结果：机器人数量、平均帧时间、平均 AI 时间、AI 峰值、每帧思考次数、每帧寻路次数 */
+    struct FRampRow
+    {
+        int32 Bots = 0;
+        FWindowSample Sample;
+    };
+    TArray<FRampRow> RampRows;
+};
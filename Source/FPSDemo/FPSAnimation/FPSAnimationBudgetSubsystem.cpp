@@ -0,0 +1,281 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSAnimation/FPSAnimationBudgetSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSSignificance/FPSTickSignificanceSubsystem.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarAnimBudget(
+    TEXT("fps.Anim.Budget"),
+    1,
+    TEXT("1：按重要度为角色第三人称网格分配动画更新间隔并受 fps.Anim.MaxEvaluationsPerFrame 约束；0：每帧更新。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimMaxEvaluations(
+    TEXT("fps.Anim.MaxEvaluationsPerFrame"),
+    24.0f,
+    TEXT("所有角色每帧动画评估次数之和的上限（Σ 1/更新间隔），本地视角角色不计入调整。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimNearDistance(
+    TEXT("fps.Anim.NearDistance"),
+    1500.0f,
+    TEXT("距最近视角小于该距离（cm）且可见的角色每帧更新。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarAnimFarDistance(
+    TEXT("fps.Anim.FarDistance"),
+    4000.0f,
+    TEXT("距最近视角小于该距离（cm）且可见的角色每 2 帧更新，更远的每 4 帧更新。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimNotRenderedTickRate(
+    TEXT("fps.Anim.NotRenderedTickRate"),
+    8,
+    TEXT("最近未被渲染的角色的更新间隔（帧）。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimServerTickRate(
+    TEXT("fps.Anim.ServerTickRate"),
+    2,
+    TEXT("专用服务器上角色的更新间隔（帧），跳过的帧插值，命中盒骨骼随之刷新。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarAnimMaxTickRate(
+    TEXT("fps.Anim.MaxTickRate"),
+    8,
+    TEXT("预算不足时更新间隔的上限（帧）。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Anim.Report
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GAnimReportCommand(
+    TEXT("fps.Anim.Report"),
+    TEXT("输出角色动画预算：各更新间隔的角色数量与每帧预估评估次数。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSAnimationBudgetSubsystem* Budget = World ? World->GetSubsystem<UFPSAnimationBudgetSubsystem>() : nullptr)
+        {
+            Budget->LogReport();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSAnimationBudgetSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSAnimationBudgetSubsystem::Deinitialize()
+{
+    Characters.Empty();
+    Entries.Empty();
+    Super::Deinitialize();
+}
+
+TStatId UFPSAnimationBudgetSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSAnimationBudgetSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSAnimationBudgetSubsystem::RegisterCharacter(AFPSCharacter* Character)
+{
+    if (Character)
+    {
+        Characters.AddUnique(Character);
+    }
+}
+
+void UFPSAnimationBudgetSubsystem::UnregisterCharacter(AFPSCharacter* Character)
+{
+    Characters.RemoveSingleSwap(Character, EAllowShrinking::No);
+}
+
+void UFPSAnimationBudgetSubsystem::ResetCharacter(AFPSCharacter* Character)
+{
+    if (USkeletalMeshComponent* Mesh = Character ? Character->GetMesh() : nullptr)
+    {
+        Mesh->EnableExternalTickRateControl(false);
+    }
+}
+
+// ------------------------------------------------------------------
+// 每帧：收集视角 -> 期望间隔 -> 预算调整 -> 写入网格
+// ------------------------------------------------------------------
+void UFPSAnimationBudgetSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (CVarAnimBudget.GetValueOnGameThread() == 0)
+    {
+        if (bBudgetActive)
+        {
+            for (AFPSCharacter* Character : Characters)
+            {
+                ResetCharacter(Character);
+            }
+            bBudgetActive = false;
+        }
+        return;
+    }
+
+    if (Characters.Num() == 0)
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSAnimBudget);
+    bBudgetActive = true;
+
+    // 视角与 Tick 重要度调度相同：本地玩家的相机，服务器上另加各远端玩家角色的眼睛位置
+    TArray<FFPSViewpoint, TInlineAllocator<4>> Viewpoints;
+    UFPSTickSignificanceSubsystem::GatherViewpoints(GetWorld(), Viewpoints);
+
+    TArray<FVector, TInlineAllocator<4>> ViewLocations;
+    for (const FFPSViewpoint& Viewpoint : Viewpoints)
+    {
+        ViewLocations.Add(Viewpoint.Location);
+    }
+
+    ComputeDesiredRates(ViewLocations);
+    FitToBudget(CVarAnimMaxEvaluations.GetValueOnGameThread());
+
+    const int32 MaxTickRate = FMath::Clamp(CVarAnimMaxTickRate.GetValueOnGameThread(), 1, 255);
+
+    LastEvaluations = 0.0f;
+    LastRateHistogram.Reset();
+    for (const FBudgetEntry& Entry : Entries)
+    {
+        USkeletalMeshComponent* Mesh = Entry.Character->GetMesh();
+
+        // 外部频率只在 URO 生效时使用；跳过的帧在两次评估之间插值
+        Mesh->EnableExternalTickRateControl(true);
+        Mesh->SetExternalTickRate(static_cast<uint8>(Entry.TickRate));
+        if (Mesh->AnimUpdateRateParams)
+        {
+            Mesh->AnimUpdateRateParams->MaxEvalRateForInterpolation = MaxTickRate + 1;
+        }
+
+        LastEvaluations += 1.0f / Entry.TickRate;
+        ++LastRateHistogram.FindOrAdd(Entry.TickRate, 0);
+    }
+
+    SET_DWORD_STAT(STAT_FPSAnimEvaluations, FMath::CeilToInt32(LastEvaluations));
+    SET_DWORD_STAT(STAT_FPSAnimCharacters, Entries.Num());
+}
+
+// ------------------------------------------------------------------
+// 重要度：本地视角的角色最高；其余按到最近视角的距离，未被渲染的低于所有可见角色
+// ------------------------------------------------------------------
+void UFPSAnimationBudgetSubsystem::ComputeDesiredRates(TConstArrayView<FVector> ViewLocations)
+{
+    const bool bDedicatedServer = IsRunningDedicatedServer();
+    const float NearDistanceSq = FMath::Square(CVarAnimNearDistance.GetValueOnGameThread());
+    const float FarDistanceSq = FMath::Square(CVarAnimFarDistance.GetValueOnGameThread());
+    const int32 MaxTickRate = FMath::Clamp(CVarAnimMaxTickRate.GetValueOnGameThread(), 1, 255);
+    const int32 NotRenderedTickRate = FMath::Clamp(CVarAnimNotRenderedTickRate.GetValueOnGameThread(), 1, MaxTickRate);
+    const int32 ServerTickRate = FMath::Clamp(CVarAnimServerTickRate.GetValueOnGameThread(), 1, MaxTickRate);
+
+    Entries.Reset();
+    for (AFPSCharacter* Character : Characters)
+    {
+        if (!Character || !Character->GetMesh())
+        {
+            continue;
+        }
+
+        FBudgetEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.Character = Character;
+
+        if (Character->IsLocallyControlled() && Character->IsPlayerControlled())
+        {
+            Entry.Significance = TNumericLimits<float>::Max();
+            Entry.TickRate = 1;
+            continue;
+        }
+
+        const FVector Location = Character->GetActorLocation();
+        float MinDistanceSq = TNumericLimits<float>::Max();
+        for (const FVector& ViewLocation : ViewLocations)
+        {
+            MinDistanceSq = FMath::Min(MinDistanceSq, static_cast<float>(FVector::DistSquared(Location, ViewLocation)));
+        }
+        const float Distance = ViewLocations.Num() > 0 ? FMath::Sqrt(MinDistanceSq) : 0.0f;
+
+        if (bDedicatedServer)
+        {
+            Entry.Significance = -Distance;
+            Entry.TickRate = ServerTickRate;
+        }
+        else if (!Character->GetMesh()->WasRecentlyRendered(0.2f))
+        {
+            // 比任何可见角色都不重要
+            Entry.Significance = -Distance - 1.0e7f;
+            Entry.TickRate = NotRenderedTickRate;
+        }
+        else
+        {
+            Entry.Significance = -Distance;
+            Entry.TickRate = MinDistanceSq < NearDistanceSq ? 1 : (MinDistanceSq < FarDistanceSq ? 2 : 4);
+            Entry.TickRate = FMath::Min(Entry.TickRate, MaxTickRate);
+        }
+    }
+}
+
+// ------------------------------------------------------------------
+// 预算：从最不重要的角色开始把更新间隔加倍，每轮最多加倍一次，直到满足预算或无法再加大
+// ------------------------------------------------------------------
+void UFPSAnimationBudgetSubsystem::FitToBudget(float MaxEvaluations)
+{
+    const int32 MaxTickRate = FMath::Clamp(CVarAnimMaxTickRate.GetValueOnGameThread(), 1, 255);
+
+    float Evaluations = 0.0f;
+    for (const FBudgetEntry& Entry : Entries)
+    {
+        Evaluations += 1.0f / Entry.TickRate;
+    }
+    if (Evaluations <= MaxEvaluations)
+    {
+        return;
+    }
+
+    Entries.Sort([](const FBudgetEntry& A, const FBudgetEntry& B) { return A.Significance > B.Significance; });
+
+    bool bChanged = true;
+    while (Evaluations > MaxEvaluations && bChanged)
+    {
+        bChanged = false;
+        for (int32 Index = Entries.Num() - 1; Index >= 0 && Evaluations > MaxEvaluations; --Index)
+        {
+            FBudgetEntry& Entry = Entries[Index];
+            if (Entry.Significance == TNumericLimits<float>::Max() || Entry.TickRate >= MaxTickRate)
+            {
+                continue;
+            }
+
+            Evaluations -= 1.0f / Entry.TickRate;
+            Entry.TickRate = FMath::Min(Entry.TickRate * 2, MaxTickRate);
+            Evaluations += 1.0f / Entry.TickRate;
+            bChanged = true;
+        }
+    }
+}
+
+void UFPSAnimationBudgetSubsystem::LogReport() const
+{
+    FString Histogram;
+    for (const TPair<int32, int32>& Pair : LastRateHistogram)
+    {
+        Histogram += FString::Printf(TEXT(" 1/%d:%d"), Pair.Key, Pair.Value);
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("AnimBudget: Characters=%d Evaluations/frame=%.2f (budget %.2f, full rate %d) Rates:%s"),
+        Entries.Num(), LastEvaluations, CVarAnimMaxEvaluations.GetValueOnGameThread(), Entries.Num(), *Histogram);
+}
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSAnimationBudgetSubsystem.generated.h"
+
+class AFPSCharacter;
+
+/**
+ * UFPSAnimationBudgetSubsystem
+ * 角色第三人称网格的动画预算。
+ * 每帧按重要度（与本地视角的距离、最近是否被渲染）为每个角色选择动画更新间隔（每 N 帧评估一次），
+ * 通过骨骼网格的更新频率优化（URO）外部频率控制生效，跳过的帧在两次评估之间插值。
+ * 所有角色每帧的动画评估次数之和（Σ 1/N）超过 fps.Anim.MaxEvaluationsPerFrame 时，
+ * 从最不重要的角色开始把间隔加倍，直到满足预算或达到 fps.Anim.MaxTickRate。
+ *
+ * 专用服务器上没有视角：所有角色使用 fps.Anim.ServerTickRate（命中盒骨骼仍按插值结果刷新），
+ * 同样受预算约束；没有命中盒骨骼的角色不注册，只更新蒙太奇。第一人称手臂（FPSMesh）由角色自身在非本地玩家控制时关闭。
+ *
+ * 度量：stat FPSDemo（Anim Budget / Anim Evaluations / Anim Characters）、stat Anim、fps.Anim.Report。
+ */
+UCLASS()
+class FPSDEMO_API UFPSAnimationBudgetSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    void RegisterCharacter(AFPSCharacter* Character);
+    void UnregisterCharacter(AFPSCharacter* Character);
+
+    /* 输出当前的更新间隔分布与预估评估次数 */
+    void LogReport() const;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 一个角色本帧的重要度与分配的更新间隔 */
+    struct FBudgetEntry
+    {
+        AFPSCharacter* Character = nullptr;
+
+        /* 越大越重要 */
+        float Significance = 0.0f;
+
+        int32 TickRate = 1;
+    };
+
+    /* 计算重要度与期望的更新间隔 */
+    void ComputeDesiredRates(TConstArrayView<FVector> ViewLocations);
+
+    /* 超出预算时逐步加大不重要角色的更新间隔 */
+    void FitToBudget(float MaxEvaluations);
+
+    /* 关闭外部频率控制，恢复每帧更新 */
+    static void ResetCharacter(AFPSCharacter* Character);
+
+    /* 已注册的角色（在 EndPlay 中注销） */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AFPSCharacter>> Characters;
+
+    /* 每帧复用 */
+    TArray<FBudgetEntry> Entries;
+
+    /* 上一帧的结果，用于报告 */
+    float LastEvaluations = 0.0f;
+    TMap<int32, int32> LastRateHistogram;
+
+    bool bBudgetActive = false;
+};
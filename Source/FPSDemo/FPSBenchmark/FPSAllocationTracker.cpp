@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "FPSDemo.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/MemoryBase.h"
+#include "Misc/CommandLine.h"
+
+namespace FPSAllocationTracker
+{
+    FCounter Shot;
+
+    /* 本线程当前计数的作用域；为空表示不计数 */
+    static thread_local FCounter* ActiveCounter = nullptr;
+
+    static bool bInstalled = false;
+    static uint64 Shots = 0;
+
+    /**
+     * GMalloc 的计数代理：只在本线程有活动作用域时计数，其余全部原样转发。
+     * 安装后不再卸下（之前分配的内存由同一个内部分配器释放）。
+     */
+    class FCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+        {
+        }
+
+        virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+        {
+            Count(Size);
+            return Inner->Malloc(Size, Alignment);
+        }
+
+        virtual void* TryMalloc(SIZE_T Size, uint32 Alignment) override
+        {
+            Count(Size);
+            return Inner->TryMalloc(Size, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+        {
+            Count(Size);
+            return Inner->Realloc(Original, Size, Alignment);
+        }
+
+        virtual void* TryRealloc(void* Original, SIZE_T Size, uint32 Alignment) override
+        {
+            Count(Size);
+            return Inner->TryRealloc(Original, Size, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override { return Inner->QuantizeSize(Size, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUsedOnCurrentThread() override { Inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUnusedOnCurrentThread() override { Inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+        virtual void UpdateStats() override { Inner->UpdateStats(); }
+        virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+        virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+        virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+        virtual void OnMallocInitialized() override { Inner->OnMallocInitialized(); }
+        virtual void OnPreFork() override { Inner->OnPreFork(); }
+        virtual void OnPostFork() override { Inner->OnPostFork(); }
+
+    private:
+        static FORCEINLINE void Count(SIZE_T Size)
+        {
+            // ParallelFor 的工作线程可能同时计入同一计数器
+            if (FCounter* Counter = ActiveCounter)
+            {
+                FPlatformAtomics::InterlockedIncrement(reinterpret_cast<volatile int64*>(&Counter->Count));
+                FPlatformAtomics::InterlockedAdd(reinterpret_cast<volatile int64*>(&Counter->Bytes), static_cast<int64>(Size));
+            }
+        }
+
+        FMalloc* Inner;
+    };
+
+    bool IsEnabled()
+    {
+        return bInstalled;
+    }
+
+    void InstallIfRequested()
+    {
+        if (bInstalled || !FParse::Param(FCommandLine::Get(), TEXT("FPSAllocTracking")))
+        {
+            return;
+        }
+
+        check(GMalloc);
+        GMalloc = new FCountingMalloc(GMalloc);
+        bInstalled = true;
+
+        UE_LOG(LogFPSDemo, Display, TEXT("AllocTracking: counting allocations per shot (fps.Alloc.Report)"));
+    }
+
+    void AddShots(int32 NumShots)
+    {
+        Shots += NumShots;
+    }
+
+    uint64 GetShots()
+    {
+        return Shots;
+    }
+
+    void LogReport()
+    {
+        if (!bInstalled)
+        {
+            UE_LOG(LogFPSDemo, Log, TEXT("AllocTracking: disabled, start with -FPSAllocTracking"));
+            return;
+        }
+
+        const double Divisor = static_cast<double>(FMath::Max<uint64>(Shots, 1));
+        UE_LOG(LogFPSDemo, Log, TEXT("AllocTracking: Shots=%llu Allocations=%llu (%.2f/shot) Bytes=%llu (%.1f/shot)"),
+            Shots, Shot.Count, Shot.Count / Divisor, Shot.Bytes, Shot.Bytes / Divisor);
+    }
+
+    FCounter* GetActiveCounter()
+    {
+        return ActiveCounter;
+    }
+
+    FScope::FScope(FCounter& Counter)
+        : FScope(&Counter)
+    {
+    }
+
+    FScope::FScope(FCounter* Counter)
+        : Previous(ActiveCounter)
+    {
+        // 只有最外层作用域生效
+        if (!Previous && bInstalled)
+        {
+            ActiveCounter = Counter;
+        }
+    }
+
+    FScope::~FScope()
+    {
+        ActiveCounter = Previous;
+    }
+}
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Alloc.Report
+// ------------------------------------------------------------------
+static FAutoConsoleCommand GAllocReportCommand(
+    TEXT("fps.Alloc.Report"),
+    TEXT("输出每发射击（开火到回收）的分配次数与字节数。需要命令行 -FPSAllocTracking。"),
+    FConsoleCommandDelegate::CreateStatic(&FPSAllocationTracker::LogReport));
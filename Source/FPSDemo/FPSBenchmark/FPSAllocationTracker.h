@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 射击分配计数。
+ * 命令行带 -FPSAllocTracking 时，模块启动时在 GMalloc 外包一层计数代理；
+ * 处于 FPS_ALLOC_SCOPE 作用域内的线程上的每次 Malloc/Realloc 计入对应计数器（字节数为请求大小，不计释放）。
+ * 嵌套作用域只由最外层计数，避免重复统计。计数为原子累加，多个线程可同时计入同一计数器。
+ *
+ * 作用域只作用于当前线程。要计入工作线程上的分配，在发起 ParallelFor 或任务前用 GetActiveCounter() 取得计数器，
+ * 在工作线程的函数体内以 FScope(Counter) 带入（计数器为空时不计数）。
+ *
+ * Shot 覆盖一发射击的完整生命周期：开火（Shoot、FireShots、开火批次 RPC）、对象池取出、弹道积分、
+ * 扫掠（含 ParallelFor 工作线程）、命中（OnHit）、即时命中射线的排队与取回结果，以及回收。
+ * 不包括引擎异步射线任务自身在任务线程上的分配（引擎内部调度，无法带入作用域）。
+ * 除以 GetShots() 即为每发射击的分配次数与字节数；自动化测试 FPSDemo.Performance.ShotAllocations 据此检查阈值。
+ * 未启用时作用域只读取一个线程局部变量；Shipping 版本中宏为空，GetActiveCounter() 始终为空。
+ */
+namespace FPSAllocationTracker
+{
+    struct FCounter
+    {
+        uint64 Bytes = 0;
+        uint64 Count = 0;
+    };
+
+    /* 一发射击生命周期内的分配 */
+    extern FPSDEMO_API FCounter Shot;
+
+    /* 是否已安装计数代理 */
+    FPSDEMO_API bool IsEnabled();
+
+    /* 命令行带 -FPSAllocTracking 时安装计数代理；只能在模块启动时调用 */
+    FPSDEMO_API void InstallIfRequested();
+
+    /* 累计发射的射击数 */
+    FPSDEMO_API void AddShots(int32 NumShots);
+    FPSDEMO_API uint64 GetShots();
+
+    /* 输出累计的每发射击分配 */
+    FPSDEMO_API void LogReport();
+
+    /* 本线程当前计数的计数器，没有活动作用域时为空；用于把作用域带入工作线程 */
+    FPSDEMO_API FCounter* GetActiveCounter();
+
+    /* 作用域：最外层作用域期间本线程的分配计入计数器 */
+    class FPSDEMO_API FScope
+    {
+    public:
+        explicit FScope(FCounter& Counter);
+
+        /* 带入发起线程的计数器（GetActiveCounter() 的结果），为空时不计数 */
+        explicit FScope(FCounter* Counter);
+
+        ~FScope();
+
+    private:
+        FCounter* Previous;
+    };
+}
+
+#if !UE_BUILD_SHIPPING
+#define FPS_ALLOC_SCOPE(CounterName) FPSAllocationTracker::FScope PREPROCESSOR_JOIN(AllocScope_, __LINE__)(FPSAllocationTracker::CounterName)
+#else
+#define FPS_ALLOC_SCOPE(CounterName)
+#endif
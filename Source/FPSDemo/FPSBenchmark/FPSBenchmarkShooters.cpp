@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSBenchmarkShooters.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSDemo.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerStart.h"
+#include "InputActionValue.h"
+
+namespace FPSBenchmarkShooters
+{
+    TArray<AFPSCharacter*> SpawnShooters(UWorld& World, int32 Num)
+    {
+        UClass* ShooterClass = AFPSCharacter::StaticClass();
+        if (const AGameModeBase* GameMode = World.GetAuthGameMode())
+        {
+            if (GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(AFPSCharacter::StaticClass()))
+            {
+                ShooterClass = GameMode->DefaultPawnClass;
+            }
+        }
+
+        FVector Origin(0.0f, 0.0f, 200.0f);
+        for (TActorIterator<APlayerStart> It(&World); It; ++It)
+        {
+            Origin = It->GetActorLocation();
+            break;
+        }
+
+        const int32 Columns = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(Num)));
+        const float Spacing = 150.0f;
+
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+        TArray<AFPSCharacter*> Shooters;
+        Shooters.Reserve(Num);
+        for (int32 Index = 0; Index < Num; ++Index)
+        {
+            const FVector Offset((Index % Columns - Columns * 0.5f) * Spacing, (Index / Columns - Columns * 0.5f) * Spacing, 0.0f);
+            const FRotator Rotation(0.0f, 360.0f * Index / Num, 0.0f);
+
+            AFPSCharacter* Shooter = World.SpawnActor<AFPSCharacter>(ShooterClass, Origin + Offset, Rotation, SpawnParams);
+            if (Shooter)
+            {
+                if (!Shooter->GetController())
+                {
+                    Shooter->SpawnDefaultController();
+                }
+                Shooters.Add(Shooter);
+            }
+        }
+
+        UE_LOG(LogFPSDemo, Display, TEXT("FPSBenchmark: spawned %d/%d shooters of class %s"), Shooters.Num(), Num, *ShooterClass->GetName());
+        return Shooters;
+    }
+
+    void DriveShooter(AFPSCharacter& Shooter, int32 Index, float Time)
+    {
+        AController* Controller = Shooter.GetController();
+        if (!Controller)
+        {
+            return;
+        }
+
+        const float Phase = Index * 0.37f;
+        Shooter.Move(FInputActionValue(FVector2D(FMath::Sin(Time * 0.5f + Phase), FMath::Cos(Time * 0.3f + Phase))));
+        Controller->SetControlRotation(FRotator(FMath::Sin(Time + Phase) * 10.0f, Phase * 57.0f + Time * 30.0f, 0.0f));
+        Shooter.Shoot(FInputActionValue(true));
+    }
+}
@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AFPSCharacter;
+class UWorld;
+
+/**
+ * 压力测试与自动化测试共用的射手。
+ * -FPSSoak（UFPSSoakBenchmarkSubsystem）与 FPSDemo.Performance.ShotAllocations 用同一套生成与驱动方式，
+ * 两者测得的数据才可以相互对照。仅在游戏线程上使用。
+ */
+namespace FPSBenchmarkShooters
+{
+    /**
+     * 以玩家出生点为中心排成方阵生成 Num 个角色，由 AI 控制器占有。
+     * 优先使用游戏模式配置的默认角色类（蓝图中设置了子弹类、网格等）。
+     * @return 实际生成的角色
+     */
+    FPSDEMO_API TArray<AFPSCharacter*> SpawnShooters(UWorld& World, int32 Num);
+
+    /**
+     * 驱动一个角色绕圈移动、缓慢转向并开火，每帧调用。
+     * @param Index 角色序号，决定相位，保证子弹射向不同方向
+     * @param Time  开始驱动后经过的时间（秒）
+     */
+    FPSDEMO_API void DriveShooter(AFPSCharacter& Shooter, int32 Index, float Time);
+}
@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSFootprintSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSDemo.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Serialization/ArchiveCountMem.h"
+
+namespace FPSFootprint
+{
+    /* 第一个游戏世界开始游戏时记录，之后的关卡切换不再更新 */
+    static double StartupSeconds = 0.0;
+
+    static void CountObject(UObject* Object, double& OutObjectBytes, double& OutResourceBytes)
+    {
+        FArchiveCountMem CountMem(Object);
+        OutObjectBytes += CountMem.GetMax();
+        OutResourceBytes += Object->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+    }
+}
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Memory.Footprint
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GFootprintCommand(
+    TEXT("fps.Memory.Footprint"),
+    TEXT("输出当前版本（服务器/客户端）的启动耗时与每个角色、子弹的组件数和内存占用。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSFootprintSubsystem* Footprint = World ? World->GetSubsystem<UFPSFootprintSubsystem>() : nullptr)
+        {
+            Footprint->LogReport();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSFootprintSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSFootprintSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    if (FPSFootprint::StartupSeconds > 0.0)
+    {
+        return;
+    }
+
+    FPSFootprint::StartupSeconds = FPlatformTime::Seconds() - GStartTime;
+
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    UE_LOG(LogFPSDemo, Display, TEXT("Footprint: %s build, %s began play %.2f s after process start, used physical %.1f MB"),
+        GetBuildLabel(), *InWorld.GetMapName(), FPSFootprint::StartupSeconds, MemoryStats.UsedPhysical / (1024.0 * 1024.0));
+}
+
+const TCHAR* UFPSFootprintSubsystem::GetBuildLabel()
+{
+#if UE_SERVER
+    return TEXT("Server");
+#else
+    return IsRunningDedicatedServer() ? TEXT("Game -server") : TEXT("Client");
+#endif
+}
+
+double UFPSFootprintSubsystem::GetStartupSeconds()
+{
+    return FPSFootprint::StartupSeconds;
+}
+
+// ------------------------------------------------------------------
+// 每个实体：Actor 与其全部组件的对象内存及独占资源
+// ------------------------------------------------------------------
+FFPSEntityFootprint UFPSFootprintSubsystem::Measure(TSubclassOf<AActor> ActorClass) const
+{
+    FFPSEntityFootprint Result;
+    if (!ActorClass)
+    {
+        return Result;
+    }
+
+    double NumComponents = 0.0;
+    for (TActorIterator<AActor> It(GetWorld(), ActorClass); It; ++It)
+    {
+        AActor* Actor = *It;
+        ++Result.NumActors;
+        FPSFootprint::CountObject(Actor, Result.ObjectBytesPerActor, Result.ResourceBytesPerActor);
+
+        for (UActorComponent* Component : Actor->GetComponents())
+        {
+            if (Component)
+            {
+                ++NumComponents;
+                FPSFootprint::CountObject(Component, Result.ObjectBytesPerActor, Result.ResourceBytesPerActor);
+            }
+        }
+    }
+
+    if (Result.NumActors > 0)
+    {
+        Result.ComponentsPerActor = NumComponents / Result.NumActors;
+        Result.ObjectBytesPerActor /= Result.NumActors;
+        Result.ResourceBytesPerActor /= Result.NumActors;
+    }
+    return Result;
+}
+
+void UFPSFootprintSubsystem::LogReport() const
+{
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    UE_LOG(LogFPSDemo, Log, TEXT("Footprint: %s build, startup %.2f s, used physical %.1f MB (peak %.1f MB)"),
+        GetBuildLabel(), FPSFootprint::StartupSeconds,
+        MemoryStats.UsedPhysical / (1024.0 * 1024.0), MemoryStats.PeakUsedPhysical / (1024.0 * 1024.0));
+
+    const TPair<const TCHAR*, UClass*> Classes[] = {
+        { TEXT("Character"), AFPSCharacter::StaticClass() },
+        { TEXT("Projectile"), AProjetileActor::StaticClass() },
+    };
+    for (const TPair<const TCHAR*, UClass*>& Entry : Classes)
+    {
+        const FFPSEntityFootprint Footprint = Measure(Entry.Value);
+        UE_LOG(LogFPSDemo, Log, TEXT("  %-10s: %4d actors, %.1f components, %.1f KB each (objects %.1f KB, resources %.1f KB)"),
+            Entry.Key, Footprint.NumActors, Footprint.ComponentsPerActor, Footprint.GetBytesPerActor() / 1024.0,
+            Footprint.ObjectBytesPerActor / 1024.0, Footprint.ResourceBytesPerActor / 1024.0);
+    }
+}
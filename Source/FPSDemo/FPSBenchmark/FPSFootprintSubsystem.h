@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSFootprintSubsystem.generated.h"
+
+/* 某一类实体的平均内存占用 */
+struct FFPSEntityFootprint
+{
+    int32 NumActors = 0;
+
+    /* 每个实体的平均组件数 */
+    double ComponentsPerActor = 0.0;
+
+    /* 每个实体：Actor 与组件对象本身及其容器（同 obj list 的 MaxKB） */
+    double ObjectBytesPerActor = 0.0;
+
+    /* 每个实体：Actor 与组件独占的资源（骨骼变换缓冲等，同 obj list 的 ResExcKB） */
+    double ResourceBytesPerActor = 0.0;
+
+    double GetBytesPerActor() const { return ObjectBytesPerActor + ResourceBytesPerActor; }
+};
+
+/**
+ * UFPSFootprintSubsystem
+ * 启动耗时与每个实体的内存占用，用于比较服务器版本（FPSDemoServer）与客户端版本，估算单机可承载的对局数。
+ * 第一个游戏世界开始游戏时输出一次启动耗时（进程启动至今）与物理内存；
+ * fps.Memory.Footprint 输出当前世界中角色与子弹（含对象池中的子弹）的平均组件数与字节数。
+ * 压力测试（-FPSSoak）结束时同样把这些数据写入汇总 CSV，两个版本各跑一次即可直接对比。
+ */
+UCLASS()
+class FPSDEMO_API UFPSFootprintSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    /* 当前进程的版本：Server（服务器版本）、Game -server（客户端版本以专用服务器运行）或 Client */
+    static const TCHAR* GetBuildLabel();
+
+    /* 进程启动到第一个游戏世界开始游戏的秒数，尚未开始时为 0 */
+    static double GetStartupSeconds();
+
+    /* 统计世界中某一类（含子类）实体的平均内存占用 */
+    FFPSEntityFootprint Measure(TSubclassOf<AActor> ActorClass) const;
+
+    /* 输出版本、启动耗时与角色、子弹的内存占用 */
+    void LogReport() const;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+};
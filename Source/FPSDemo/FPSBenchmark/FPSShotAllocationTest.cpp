@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "FPSBenchmark/FPSBenchmarkShooters.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<float> CVarTestMaxAllocsPerShot(
+    TEXT("fps.Alloc.TestMaxAllocsPerShot"),
+    8.0f,
+    TEXT("自动化测试 FPSDemo.Performance.ShotAllocations：稳定射击状态下每发射击允许的最大分配次数。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarTestMaxBytesPerShot(
+    TEXT("fps.Alloc.TestMaxBytesPerShot"),
+    2048.0f,
+    TEXT("自动化测试 FPSDemo.Performance.ShotAllocations：稳定射击状态下每发射击允许的最大分配字节数。"),
+    ECVF_Default);
+
+namespace FPSShotAllocationTest
+{
+    constexpr const TCHAR* MapName = TEXT("/Game/001_Maps/FPSMap");
+    constexpr int32 NumShooters = 8;
+
+    /* 预热：对象池填满、各数组扩容完毕 */
+    constexpr double WarmupSeconds = 3.0;
+
+    /* 预热后需要测量的射击数，以及等待这些射击的最长时间 */
+    constexpr uint64 MeasuredShots = 500;
+    constexpr double TimeoutSeconds = 60.0;
+
+    static UWorld* FindGameWorld()
+    {
+        for (const FWorldContext& Context : GEngine->GetWorldContexts())
+        {
+            if (Context.WorldType == EWorldType::Game && Context.World())
+            {
+                return Context.World();
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * 每帧驱动角色开火：预热结束时记录基线，之后累计到 MeasuredShots 发后比较每发射击的分配。
+     * 与 -FPSSoak 相同，角色由 FPSBenchmarkShooters 生成与驱动，射击数与分配均来自 FPSAllocationTracker。
+     */
+    class FMeasureCommand : public IAutomationLatentCommand
+    {
+    public:
+        explicit FMeasureCommand(FAutomationTestBase* InTest)
+            : Test(InTest)
+        {
+        }
+
+        virtual bool Update() override
+        {
+            UWorld* World = FindGameWorld();
+            if (!World)
+            {
+                Test->AddError(FString::Printf(TEXT("No game world after loading %s"), MapName));
+                return true;
+            }
+
+            if (StartTime == 0.0)
+            {
+                SpawnShooters(*World);
+                StartTime = FPlatformTime::Seconds();
+                if (Shooters.Num() == 0)
+                {
+                    Test->AddError(TEXT("Failed to spawn any shooter"));
+                    return true;
+                }
+            }
+
+            const double Elapsed = FPlatformTime::Seconds() - StartTime;
+            DriveShooters(static_cast<float>(Elapsed));
+
+            if (Elapsed < WarmupSeconds)
+            {
+                return false;
+            }
+
+            if (!bMeasuring)
+            {
+                Baseline = FPSAllocationTracker::Shot;
+                ShotsBaseline = FPSAllocationTracker::GetShots();
+                bMeasuring = true;
+                return false;
+            }
+
+            const uint64 Shots = FPSAllocationTracker::GetShots() - ShotsBaseline;
+            if (Shots < MeasuredShots)
+            {
+                if (Elapsed > WarmupSeconds + TimeoutSeconds)
+                {
+                    Test->AddError(FString::Printf(TEXT("Only %llu of %llu shots fired within %.0f s"), Shots, MeasuredShots, TimeoutSeconds));
+                    Finish();
+                    return true;
+                }
+                return false;
+            }
+
+            const double AllocsPerShot = (FPSAllocationTracker::Shot.Count - Baseline.Count) / static_cast<double>(Shots);
+            const double BytesPerShot = (FPSAllocationTracker::Shot.Bytes - Baseline.Bytes) / static_cast<double>(Shots);
+            const double MaxAllocsPerShot = CVarTestMaxAllocsPerShot.GetValueOnGameThread();
+            const double MaxBytesPerShot = CVarTestMaxBytesPerShot.GetValueOnGameThread();
+
+            Test->AddInfo(FString::Printf(TEXT("%llu shots, %.2f allocs/shot (max %.2f), %.1f bytes/shot (max %.1f)"),
+                Shots, AllocsPerShot, MaxAllocsPerShot, BytesPerShot, MaxBytesPerShot));
+            if (AllocsPerShot > MaxAllocsPerShot)
+            {
+                Test->AddError(FString::Printf(TEXT("Allocations per shot %.2f exceed fps.Alloc.TestMaxAllocsPerShot %.2f"), AllocsPerShot, MaxAllocsPerShot));
+            }
+            if (BytesPerShot > MaxBytesPerShot)
+            {
+                Test->AddError(FString::Printf(TEXT("Bytes per shot %.1f exceed fps.Alloc.TestMaxBytesPerShot %.1f"), BytesPerShot, MaxBytesPerShot));
+            }
+
+            Finish();
+            return true;
+        }
+
+    private:
+        void SpawnShooters(UWorld& World)
+        {
+            for (AFPSCharacter* Shooter : FPSBenchmarkShooters::SpawnShooters(World, NumShooters))
+            {
+                Shooters.Add(Shooter);
+            }
+        }
+
+        void DriveShooters(float Time)
+        {
+            for (int32 Index = 0; Index < Shooters.Num(); ++Index)
+            {
+                if (AFPSCharacter* Shooter = Shooters[Index].Get())
+                {
+                    FPSBenchmarkShooters::DriveShooter(*Shooter, Index, Time);
+                }
+            }
+        }
+
+        void Finish()
+        {
+            for (const TWeakObjectPtr<AFPSCharacter>& Shooter : Shooters)
+            {
+                if (AFPSCharacter* Resolved = Shooter.Get())
+                {
+                    if (AController* Controller = Resolved->GetController())
+                    {
+                        Controller->Destroy();
+                    }
+                    Resolved->Destroy();
+                }
+            }
+            Shooters.Reset();
+        }
+
+        FAutomationTestBase* Test;
+        TArray<TWeakObjectPtr<AFPSCharacter>> Shooters;
+        double StartTime = 0.0;
+        bool bMeasuring = false;
+        FPSAllocationTracker::FCounter Baseline;
+        uint64 ShotsBaseline = 0;
+    };
+}
+
+// ------------------------------------------------------------------
+// 稳定射击状态下每发射击的分配不超过阈值（fps.Alloc.TestMaxAllocsPerShot / fps.Alloc.TestMaxBytesPerShot）。
+// 需要以游戏方式运行并带 -FPSAllocTracking，例如：
+//   UnrealEditor FPSDemo.uproject -game -nullrhi -unattended -FPSAllocTracking
+//       -ExecCmds="Automation RunTests FPSDemo.Performance.ShotAllocations; Quit"
+// ------------------------------------------------------------------
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFPSShotAllocationTest, "FPSDemo.Performance.ShotAllocations",
+    EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::PerfFilter)
+
+bool FFPSShotAllocationTest::RunTest(const FString& Parameters)
+{
+    if (!FPSAllocationTracker::IsEnabled())
+    {
+        AddError(TEXT("Allocation tracking is not installed, run with -FPSAllocTracking"));
+        return false;
+    }
+
+    AutomationOpenMap(FPSShotAllocationTest::MapName);
+    ADD_LATENT_AUTOMATION_COMMAND(FPSShotAllocationTest::FMeasureCommand(this));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
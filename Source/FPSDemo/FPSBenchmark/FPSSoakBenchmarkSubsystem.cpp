@@ -0,0 +1,378 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSSoakBenchmarkSubsystem.h"
+#include "FPSBenchmark/FPSBenchmarkShooters.h"
+#include "FPSBenchmark/FPSFootprintSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSProjetile/ProjectilePoolSubsystem.h"
+#include "FPSDemo.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace FPSSoak
+{
+    /* 游戏线程一帧的工作时间：OnBeginFrame 与 OnEndFrame 之间，不含帧率限制造成的空闲 */
+    static uint64 BeginFrameCycles = 0;
+    static double LastGameThreadMs = 0.0;
+
+    static float Percentile(const TArray<float>& SortedValues, float Fraction)
+    {
+        if (SortedValues.Num() == 0)
+        {
+            return 0.0f;
+        }
+        const int32 Index = FMath::Clamp(FMath::FloorToInt32(Fraction * SortedValues.Num()), 0, SortedValues.Num() - 1);
+        return SortedValues[Index];
+    }
+
+    static double CyclesToMicroseconds(uint64 Cycles, uint32 Calls)
+    {
+        return Calls > 0 ? FPlatformTime::ToMilliseconds64(Cycles) * 1000.0 / Calls : 0.0;
+    }
+}
+
+// ------------------------------------------------------------------
+// 仅在命令行带 -FPSSoak 时创建
+// ------------------------------------------------------------------
+bool UFPSSoakBenchmarkSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer) && FParse::Param(FCommandLine::Get(), TEXT("FPSSoak"));
+}
+
+bool UFPSSoakBenchmarkSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSSoakBenchmarkSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSSoakBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+// ------------------------------------------------------------------
+// 关卡开始：读取参数、生成角色并开始计时
+// ------------------------------------------------------------------
+void UFPSSoakBenchmarkSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+    FParse::Value(CommandLine, TEXT("SoakShooters="), NumShooters);
+    FParse::Value(CommandLine, TEXT("SoakWarmup="), WarmupSeconds);
+    FParse::Value(CommandLine, TEXT("SoakSeconds="), DurationSeconds);
+    if (!FParse::Value(CommandLine, TEXT("SoakCSV="), CSVPath))
+    {
+        CSVPath = FPaths::ProfilingDir() / FString::Printf(TEXT("FPSSoak_%s.csv"), *FDateTime::Now().ToString());
+    }
+    bExitWhenDone = !FParse::Param(CommandLine, TEXT("SoakNoExit"));
+    FParse::Value(CommandLine, TEXT("SoakMaxAllocsPerShot="), MaxAllocsPerShot);
+    FParse::Value(CommandLine, TEXT("SoakMaxBytesPerShot="), MaxBytesPerShot);
+
+    NumShooters = FMath::Max(NumShooters, 1);
+    DurationSeconds = FMath::Max(DurationSeconds, 1.0f);
+
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSSoak: map=%s shooters=%d warmup=%.1fs duration=%.1fs csv=%s"),
+        *InWorld.GetMapName(), NumShooters, WarmupSeconds, DurationSeconds, *CSVPath);
+
+    // 生成与驱动方式和自动化测试 FPSDemo.Performance.ShotAllocations 相同
+    Shooters.Append(FPSBenchmarkShooters::SpawnShooters(InWorld, NumShooters));
+
+    PreGCHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UFPSSoakBenchmarkSubsystem::OnPreGarbageCollect);
+    PostGCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(this, &UFPSSoakBenchmarkSubsystem::OnPostGarbageCollect);
+    FCoreDelegates::OnBeginFrame.AddWeakLambda(this, []() { FPSSoak::BeginFrameCycles = FPlatformTime::Cycles64(); });
+    FCoreDelegates::OnEndFrame.AddWeakLambda(this, []()
+    {
+        if (FPSSoak::BeginFrameCycles != 0)
+        {
+            FPSSoak::LastGameThreadMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - FPSSoak::BeginFrameCycles);
+        }
+    });
+
+    const int32 ExpectedFrames = FMath::CeilToInt32(DurationSeconds * 240.0f);
+    FrameTimesMs.Reserve(ExpectedFrames);
+    GameThreadTimesMs.Reserve(ExpectedFrames);
+    SecondSamples.Reserve(FMath::CeilToInt32(DurationSeconds) + 1);
+
+    bRunning = true;
+    LastWallTime = FPlatformTime::Seconds();
+}
+
+void UFPSSoakBenchmarkSubsystem::Deinitialize()
+{
+    if (bRunning && !bFinished)
+    {
+        FinishRun();
+    }
+
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGCHandle);
+    FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGCHandle);
+    FCoreDelegates::OnBeginFrame.RemoveAll(this);
+    FCoreDelegates::OnEndFrame.RemoveAll(this);
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 每帧：驱动角色并在预热结束后采样
+// ------------------------------------------------------------------
+void UFPSSoakBenchmarkSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!bRunning || bFinished)
+    {
+        return;
+    }
+
+    const double Now = FPlatformTime::Seconds();
+    const double WallDelta = Now - LastWallTime;
+    LastWallTime = Now;
+    ElapsedSeconds += WallDelta;
+
+    // 进入新的一秒时先结束上一秒，本帧的开火、命中与帧时间都记入新的一秒
+    if (ElapsedSeconds >= WarmupSeconds)
+    {
+        const int32 Second = FMath::FloorToInt32(ElapsedSeconds - WarmupSeconds);
+        if (Second != CurrentSecond.Second)
+        {
+            FlushSecond();
+            CurrentSecond.Second = Second;
+        }
+    }
+
+    DriveShooters(DeltaTime);
+
+    if (ElapsedSeconds < WarmupSeconds)
+    {
+        // 预热阶段：记录探针基线，之后的数据只统计测量阶段
+        SpawnBaseline = FPSSoakProbes::SpawnActor;
+        OnHitBaseline = FPSSoakProbes::OnHit;
+        ShotAllocBaseline = FPSAllocationTracker::Shot;
+        ShotsBaseline = FPSAllocationTracker::GetShots();
+        return;
+    }
+
+    SampleFrame(static_cast<float>(WallDelta));
+
+    if (ElapsedSeconds >= WarmupSeconds + DurationSeconds)
+    {
+        FinishRun();
+    }
+}
+
+void UFPSSoakBenchmarkSubsystem::DriveShooters(float DeltaTime)
+{
+    const float Time = static_cast<float>(ElapsedSeconds);
+
+    for (int32 Index = 0; Index < Shooters.Num(); ++Index)
+    {
+        AFPSCharacter* Shooter = Shooters[Index];
+        if (IsValid(Shooter))
+        {
+            FPSBenchmarkShooters::DriveShooter(*Shooter, Index, Time);
+        }
+    }
+}
+
+void UFPSSoakBenchmarkSubsystem::SampleFrame(float WallDeltaSeconds)
+{
+    const float FrameMs = WallDeltaSeconds * 1000.0f;
+    const float GameThreadMs = static_cast<float>(FPSSoak::LastGameThreadMs);
+    FrameTimesMs.Add(FrameMs);
+    GameThreadTimesMs.Add(GameThreadMs);
+
+    const UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>();
+    const int32 LiveProjectiles = Pool ? Pool->GetStats().Active : 0;
+    PeakLiveProjectiles = FMath::Max(PeakLiveProjectiles, LiveProjectiles);
+
+    ++CurrentSecond.Frames;
+    CurrentSecond.FrameMsSum += FrameMs;
+    CurrentSecond.FrameMsMax = FMath::Max<double>(CurrentSecond.FrameMsMax, FrameMs);
+    CurrentSecond.GameThreadMsSum += GameThreadMs;
+    CurrentSecond.LiveProjectiles = LiveProjectiles;
+}
+
+// ------------------------------------------------------------------
+// 每秒汇总一行：探针与分配计数取自上一行之后的增量
+// ------------------------------------------------------------------
+void UFPSSoakBenchmarkSubsystem::FlushSecond()
+{
+    if (CurrentSecond.Frames == 0)
+    {
+        return;
+    }
+
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    PeakUsedPhysicalBytes = FMath::Max<uint64>(PeakUsedPhysicalBytes, MemoryStats.UsedPhysical);
+
+    CurrentSecond.SpawnCalls = FPSSoakProbes::SpawnActor.Calls - SpawnBaseline.Calls;
+    CurrentSecond.SpawnCycles = FPSSoakProbes::SpawnActor.Cycles - SpawnBaseline.Cycles;
+    CurrentSecond.OnHitCalls = FPSSoakProbes::OnHit.Calls - OnHitBaseline.Calls;
+    CurrentSecond.OnHitCycles = FPSSoakProbes::OnHit.Cycles - OnHitBaseline.Cycles;
+    CurrentSecond.UsedPhysicalBytes = MemoryStats.UsedPhysical;
+    CurrentSecond.Shots = FPSAllocationTracker::GetShots() - ShotsBaseline;
+    CurrentSecond.ShotAllocs = FPSAllocationTracker::Shot.Count - ShotAllocBaseline.Count;
+    CurrentSecond.ShotAllocBytes = FPSAllocationTracker::Shot.Bytes - ShotAllocBaseline.Bytes;
+    SecondSamples.Add(CurrentSecond);
+
+    SpawnBaseline = FPSSoakProbes::SpawnActor;
+    OnHitBaseline = FPSSoakProbes::OnHit;
+    ShotAllocBaseline = FPSAllocationTracker::Shot;
+    ShotsBaseline = FPSAllocationTracker::GetShots();
+    CurrentSecond = FSecondSample();
+}
+
+// ------------------------------------------------------------------
+// GC 暂停计时
+// ------------------------------------------------------------------
+void UFPSSoakBenchmarkSubsystem::OnPreGarbageCollect()
+{
+    GCStartTime = FPlatformTime::Seconds();
+}
+
+void UFPSSoakBenchmarkSubsystem::OnPostGarbageCollect()
+{
+    if (!bRunning || bFinished || ElapsedSeconds < WarmupSeconds || GCStartTime == 0.0)
+    {
+        return;
+    }
+
+    const double PauseMs = (FPlatformTime::Seconds() - GCStartTime) * 1000.0;
+    ++TotalGCCount;
+    TotalGCPauseMs += PauseMs;
+    MaxGCPauseMs = FMath::Max(MaxGCPauseMs, PauseMs);
+
+    ++CurrentSecond.GCCount;
+    CurrentSecond.GCPauseMsMax = FMath::Max(CurrentSecond.GCPauseMsMax, PauseMs);
+}
+
+// ------------------------------------------------------------------
+// 结束：输出逐秒 CSV 与汇总 CSV
+// ------------------------------------------------------------------
+void UFPSSoakBenchmarkSubsystem::FinishRun()
+{
+    bFinished = true;
+
+    // 最后不足一秒的部分也写入逐秒 CSV 与汇总
+    FlushSecond();
+
+    TArray<float> SortedFrameMs = FrameTimesMs;
+    TArray<float> SortedGameThreadMs = GameThreadTimesMs;
+    SortedFrameMs.Sort();
+    SortedGameThreadMs.Sort();
+
+    uint64 SpawnCycles = 0, OnHitCycles = 0;
+    uint32 SpawnCalls = 0, OnHitCalls = 0;
+    uint64 Shots = 0, ShotAllocs = 0, ShotAllocBytes = 0;
+
+    FString Timeline = TEXT("Second,Frames,FrameMsAvg,FrameMsMax,GameThreadMsAvg,LiveProjectiles,SpawnCalls,SpawnUsAvg,OnHitCalls,OnHitUsAvg,GCCount,GCPauseMsMax,UsedPhysicalMB,Shots,AllocsPerShot,BytesPerShot\n");
+    for (const FSecondSample& Sample : SecondSamples)
+    {
+        SpawnCycles += Sample.SpawnCycles;
+        SpawnCalls += Sample.SpawnCalls;
+        OnHitCycles += Sample.OnHitCycles;
+        OnHitCalls += Sample.OnHitCalls;
+        Shots += Sample.Shots;
+        ShotAllocs += Sample.ShotAllocs;
+        ShotAllocBytes += Sample.ShotAllocBytes;
+
+        const double Frames = FMath::Max(Sample.Frames, 1);
+        const double SampleShots = static_cast<double>(FMath::Max<uint64>(Sample.Shots, 1));
+        Timeline += FString::Printf(TEXT("%d,%d,%.3f,%.3f,%.3f,%d,%u,%.2f,%u,%.2f,%d,%.3f,%.1f,%llu,%.2f,%.1f\n"),
+            Sample.Second, Sample.Frames, Sample.FrameMsSum / Frames, Sample.FrameMsMax, Sample.GameThreadMsSum / Frames,
+            Sample.LiveProjectiles, Sample.SpawnCalls, FPSSoak::CyclesToMicroseconds(Sample.SpawnCycles, Sample.SpawnCalls),
+            Sample.OnHitCalls, FPSSoak::CyclesToMicroseconds(Sample.OnHitCycles, Sample.OnHitCalls),
+            Sample.GCCount, Sample.GCPauseMsMax, Sample.UsedPhysicalBytes / (1024.0 * 1024.0),
+            Sample.Shots, Sample.ShotAllocs / SampleShots, Sample.ShotAllocBytes / SampleShots);
+    }
+
+    // 分配阈值：只统计预热之后（对象池已填满）的稳定射击状态
+    const double AllocsPerShot = ShotAllocs / static_cast<double>(FMath::Max<uint64>(Shots, 1));
+    const double BytesPerShot = ShotAllocBytes / static_cast<double>(FMath::Max<uint64>(Shots, 1));
+    const bool bAllocGateEnabled = MaxAllocsPerShot >= 0.0 || MaxBytesPerShot >= 0.0;
+    bool bAllocGatePassed = true;
+    if (bAllocGateEnabled)
+    {
+        if (!FPSAllocationTracker::IsEnabled())
+        {
+            UE_LOG(LogFPSDemo, Error, TEXT("FPSSoak: allocation thresholds were given but -FPSAllocTracking is not set"));
+            bAllocGatePassed = false;
+        }
+        else if ((MaxAllocsPerShot >= 0.0 && AllocsPerShot > MaxAllocsPerShot) || (MaxBytesPerShot >= 0.0 && BytesPerShot > MaxBytesPerShot))
+        {
+            UE_LOG(LogFPSDemo, Error, TEXT("FPSSoak: allocation threshold exceeded, %.2f allocs/shot (max %.2f), %.1f bytes/shot (max %.1f)"),
+                AllocsPerShot, MaxAllocsPerShot, BytesPerShot, MaxBytesPerShot);
+            bAllocGatePassed = false;
+        }
+    }
+
+    const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+    PeakUsedPhysicalBytes = FMath::Max<uint64>(PeakUsedPhysicalBytes, MemoryStats.PeakUsedPhysical);
+
+    FString Summary = TEXT("Metric,Value\n");
+    Summary += FString::Printf(TEXT("Shooters,%d\n"), Shooters.Num());
+    Summary += FString::Printf(TEXT("DurationSeconds,%.1f\n"), DurationSeconds);
+    Summary += FString::Printf(TEXT("Frames,%d\n"), FrameTimesMs.Num());
+    Summary += FString::Printf(TEXT("FrameMsP50,%.3f\n"), FPSSoak::Percentile(SortedFrameMs, 0.50f));
+    Summary += FString::Printf(TEXT("FrameMsP90,%.3f\n"), FPSSoak::Percentile(SortedFrameMs, 0.90f));
+    Summary += FString::Printf(TEXT("FrameMsP99,%.3f\n"), FPSSoak::Percentile(SortedFrameMs, 0.99f));
+    Summary += FString::Printf(TEXT("FrameMsMax,%.3f\n"), SortedFrameMs.Num() > 0 ? SortedFrameMs.Last() : 0.0f);
+    Summary += FString::Printf(TEXT("GameThreadMsP50,%.3f\n"), FPSSoak::Percentile(SortedGameThreadMs, 0.50f));
+    Summary += FString::Printf(TEXT("GameThreadMsP90,%.3f\n"), FPSSoak::Percentile(SortedGameThreadMs, 0.90f));
+    Summary += FString::Printf(TEXT("GameThreadMsP99,%.3f\n"), FPSSoak::Percentile(SortedGameThreadMs, 0.99f));
+    Summary += FString::Printf(TEXT("SpawnActorCalls,%u\n"), SpawnCalls);
+    Summary += FString::Printf(TEXT("SpawnActorUsAvg,%.2f\n"), FPSSoak::CyclesToMicroseconds(SpawnCycles, SpawnCalls));
+    Summary += FString::Printf(TEXT("OnHitCalls,%u\n"), OnHitCalls);
+    Summary += FString::Printf(TEXT("OnHitUsAvg,%.2f\n"), FPSSoak::CyclesToMicroseconds(OnHitCycles, OnHitCalls));
+    Summary += FString::Printf(TEXT("PeakLiveProjectiles,%d\n"), PeakLiveProjectiles);
+    Summary += FString::Printf(TEXT("GCCount,%d\n"), TotalGCCount);
+    Summary += FString::Printf(TEXT("GCPauseMsTotal,%.3f\n"), TotalGCPauseMs);
+    Summary += FString::Printf(TEXT("GCPauseMsMax,%.3f\n"), MaxGCPauseMs);
+    Summary += FString::Printf(TEXT("PeakUsedPhysicalMB,%.1f\n"), PeakUsedPhysicalBytes / (1024.0 * 1024.0));
+
+    // 每个实体的内存占用：服务器版本与客户端版本各跑一次后对比
+    if (const UFPSFootprintSubsystem* Footprint = GetWorld()->GetSubsystem<UFPSFootprintSubsystem>())
+    {
+        const FFPSEntityFootprint Characters = Footprint->Measure(AFPSCharacter::StaticClass());
+        const FFPSEntityFootprint Projectiles = Footprint->Measure(AProjetileActor::StaticClass());
+        Summary += FString::Printf(TEXT("Build,%s\n"), UFPSFootprintSubsystem::GetBuildLabel());
+        Summary += FString::Printf(TEXT("StartupSeconds,%.2f\n"), UFPSFootprintSubsystem::GetStartupSeconds());
+        Summary += FString::Printf(TEXT("CharacterComponents,%.1f\n"), Characters.ComponentsPerActor);
+        Summary += FString::Printf(TEXT("CharacterKB,%.1f\n"), Characters.GetBytesPerActor() / 1024.0);
+        Summary += FString::Printf(TEXT("ProjectileComponents,%.1f\n"), Projectiles.ComponentsPerActor);
+        Summary += FString::Printf(TEXT("ProjectileKB,%.1f\n"), Projectiles.GetBytesPerActor() / 1024.0);
+    }
+    if (FPSAllocationTracker::IsEnabled())
+    {
+        Summary += FString::Printf(TEXT("Shots,%llu\n"), Shots);
+        Summary += FString::Printf(TEXT("AllocsPerShot,%.2f\n"), AllocsPerShot);
+        Summary += FString::Printf(TEXT("BytesPerShot,%.1f\n"), BytesPerShot);
+    }
+    if (bAllocGateEnabled)
+    {
+        Summary += FString::Printf(TEXT("AllocGate,%s\n"), bAllocGatePassed ? TEXT("Passed") : TEXT("Failed"));
+    }
+
+    const FString SummaryPath = FPaths::GetPath(CSVPath) / FPaths::GetBaseFilename(CSVPath) + TEXT("_Summary.csv");
+    const bool bWritten = FFileHelper::SaveStringToFile(Timeline, *CSVPath) && FFileHelper::SaveStringToFile(Summary, *SummaryPath);
+
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSSoak: finished, frame ms p50=%.2f p99=%.2f, peak projectiles=%d, GC count=%d max=%.2fms, peak memory=%.1fMB"),
+        FPSSoak::Percentile(SortedFrameMs, 0.50f), FPSSoak::Percentile(SortedFrameMs, 0.99f), PeakLiveProjectiles,
+        TotalGCCount, MaxGCPauseMs, PeakUsedPhysicalBytes / (1024.0 * 1024.0));
+    if (FPSAllocationTracker::IsEnabled())
+    {
+        UE_LOG(LogFPSDemo, Display, TEXT("FPSSoak: %llu shots, %.2f allocs/shot, %.1f bytes/shot"), Shots, AllocsPerShot, BytesPerShot);
+    }
+    UE_LOG(LogFPSDemo, Display, TEXT("FPSSoak: %s %s and %s"), bWritten ? TEXT("wrote") : TEXT("FAILED to write"), *CSVPath, *SummaryPath);
+
+    if (bExitWhenDone)
+    {
+        FPlatformMisc::RequestExitWithStatus(false, bAllocGatePassed ? 0 : 1, TEXT("FPSSoak"));
+    }
+}
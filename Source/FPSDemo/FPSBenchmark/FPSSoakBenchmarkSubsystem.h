@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSBenchmark/FPSSoakProbes.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "FPSSoakBenchmarkSubsystem.generated.h"
+
+class AFPSCharacter;
+
+/**
+ * UFPSSoakBenchmarkSubsystem
+ * 无界面（-nullrhi）压力测试：在 FPSMap 中生成 N 个 AFPSCharacter，持续移动并调用 Shoot，
+ * 在固定时长内采样帧时间分位数、SpawnActor 与 OnHit 耗时、在途子弹数量、GC 暂停与内存峰值，结果写入 CSV。
+ *
+ * 仅在命令行带 -FPSSoak 时创建，例如：
+ *   UnrealEditor FPSDemo.uproject /Game/001_Maps/FPSMap -game -nullrhi -unattended -FPSSoak
+ *       -SoakShooters=32 -SoakSeconds=60 -SoakWarmup=5 -SoakCSV=Saved/Profiling/Soak.csv
+ * 结束后自动退出进程（加 -SoakNoExit 可保留）。
+ *
+ * 同时带 -FPSAllocTracking 时记录测量阶段每发射击的分配次数与字节数；
+ * 指定 -SoakMaxAllocsPerShot=N 或 -SoakMaxBytesPerShot=N 后超出阈值即判定失败，进程以退出码 1 结束，作为长时间运行下的补充检查；
+ * 分配回归的主要检查是自动化测试 FPSDemo.Performance.ShotAllocations（FPSShotAllocationTest.cpp）。
+ * 汇总中还包含版本、启动耗时与每个角色、子弹的内存占用（见 UFPSFootprintSubsystem），
+ * 用服务器版本（FPSDemoServer -FPSSoak）与客户端版本各跑一次即可对比。
+ */
+UCLASS()
+class FPSDEMO_API UFPSSoakBenchmarkSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /* 一秒内的采样汇总，对应 CSV 的一行 */
+    struct FSecondSample
+    {
+        int32 Second = 0;
+        int32 Frames = 0;
+        double FrameMsSum = 0.0;
+        double FrameMsMax = 0.0;
+        double GameThreadMsSum = 0.0;
+        int32 LiveProjectiles = 0;
+        uint32 SpawnCalls = 0;
+        uint64 SpawnCycles = 0;
+        uint32 OnHitCalls = 0;
+        uint64 OnHitCycles = 0;
+        int32 GCCount = 0;
+        double GCPauseMsMax = 0.0;
+        uint64 UsedPhysicalBytes = 0;
+        uint64 Shots = 0;
+        uint64 ShotAllocs = 0;
+        uint64 ShotAllocBytes = 0;
+    };
+
+    /* 驱动所有角色移动、转向并开火（FPSBenchmarkShooters） */
+    void DriveShooters(float DeltaTime);
+
+    /* 采样一帧数据 */
+    void SampleFrame(float DeltaTime);
+
+    /* 结束当前这一秒：记录探针与分配计数的增量，追加为 CSV 的一行（没有帧时跳过） */
+    void FlushSecond();
+
+    /* 结束：写入 CSV 并（可选）退出 */
+    void FinishRun();
+
+    /* GC 回调，记录暂停时长 */
+    void OnPreGarbageCollect();
+    void OnPostGarbageCollect();
+
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AFPSCharacter>> Shooters;
+
+    /* 命令行参数 */
+    int32 NumShooters = 16;
+    float WarmupSeconds = 5.0f;
+    float DurationSeconds = 60.0f;
+    FString CSVPath;
+    bool bExitWhenDone = true;
+
+    /* 每发射击的分配阈值，负数表示不检查 */
+    double MaxAllocsPerShot = -1.0;
+    double MaxBytesPerShot = -1.0;
+
+    /* 运行状态 */
+    bool bRunning = false;
+    bool bFinished = false;
+    double ElapsedSeconds = 0.0;
+    double LastWallTime = 0.0;
+
+    /* 采样数据 */
+    TArray<float> FrameTimesMs;
+    TArray<float> GameThreadTimesMs;
+    TArray<FSecondSample> SecondSamples;
+    FSecondSample CurrentSecond;
+    FPSSoakProbes::FCounter SpawnBaseline;
+    FPSSoakProbes::FCounter OnHitBaseline;
+    FPSAllocationTracker::FCounter ShotAllocBaseline;
+    uint64 ShotsBaseline = 0;
+
+    /* GC 统计 */
+    double GCStartTime = 0.0;
+    int32 TotalGCCount = 0;
+    double TotalGCPauseMs = 0.0;
+    double MaxGCPauseMs = 0.0;
+    uint64 PeakUsedPhysicalBytes = 0;
+    int32 PeakLiveProjectiles = 0;
+
+    FDelegateHandle PreGCHandle;
+    FDelegateHandle PostGCHandle;
+};
@@ -0,0 +1,9 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSBenchmark/FPSSoakProbes.h"
+
+namespace FPSSoakProbes
+{
+    FCounter SpawnActor;
+    FCounter OnHit;
+}
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+/**
+ * 压力测试探针。
+ * 在游戏代码的关键位置（SpawnActor、OnHit 等）累计调用次数与 CPU 周期，供 UFPSSoakBenchmarkSubsystem 采样。
+ * 仅在游戏线程上使用；Shipping 版本中探针宏为空。
+ */
+namespace FPSSoakProbes
+{
+    struct FCounter
+    {
+        uint64 Cycles = 0;
+        uint32 Calls = 0;
+    };
+
+    /* 子弹 SpawnActor（对象池未命中或预热时） */
+    extern FPSDEMO_API FCounter SpawnActor;
+
+    /* 子弹命中回调 AProjetileActor::OnHit */
+    extern FPSDEMO_API FCounter OnHit;
+
+    /* 作用域计时：构造时记录起点，析构时累加到计数器 */
+    class FScope
+    {
+    public:
+        explicit FScope(FCounter& InCounter)
+            : Counter(InCounter)
+            , StartCycles(FPlatformTime::Cycles64())
+        {
+        }
+
+        ~FScope()
+        {
+            Counter.Cycles += FPlatformTime::Cycles64() - StartCycles;
+            ++Counter.Calls;
+        }
+
+    private:
+        FCounter& Counter;
+        uint64 StartCycles;
+    };
+}
+
+#if !UE_BUILD_SHIPPING
+#define FPS_SOAK_PROBE(CounterName) FPSSoakProbes::FScope PREPROCESSOR_JOIN(SoakProbe_, __LINE__)(FPSSoakProbes::CounterName)
+#else
+#define FPS_SOAK_PROBE(CounterName)
+#endif
@@ -5,13 +5,56 @@
 #include "EnhancedInputSubsystems.h"
 #include "Components/CapsuleComponent.h"
 #include "FPSProjetile/ProjetileActor.h" // 注意：文件名可能有拼写错误 (Projectile)
+#include "FPSProjetile/ProjectilePoolSubsystem.h"
+#include "FPSWeapon/HitscanTraceSubsystem.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "FPSNet/FPSNetStatsSubsystem.h"
+#include "FPSNet/FPSLagCompensationSubsystem.h"
+#include "FPSWeapon/FPSWeaponDefinition.h"
+#include "FPSWeapon/FPSBallisticProfile.h"
+#include "FPSWeapon/FPSBallistics.h"
+#include "FPSInput/FPSInputReplaySubsystem.h"
+#include "FPSTelemetry/FPSTelemetrySubsystem.h"
+#include "FPSAnimation/FPSAnimationBudgetSubsystem.h"
+#include "FPSSignificance/FPSTickSignificanceSubsystem.h"
+#include "FPSDemo.h"
+#include "Engine/AssetManager.h"
+#include "EngineUtils.h"
+#include "Components/SphereComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarFireBatchInterval(
+	TEXT("fps.Net.FireBatchInterval"),
+	0.0f,
+	TEXT("客户端合并发送开火批次的最小间隔（秒）。0 表示每帧发送一次本帧的全部射击。"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMaxMuzzleError(
+	TEXT("fps.Net.MaxMuzzleError"),
+	150.0f,
+	TEXT("服务器接受的客户端枪口位置与服务器枪口位置的最大偏差（cm），超出时改用服务器位置。"),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarFireRateBurstSeconds(
+	TEXT("fps.Net.FireRateBurstSeconds"),
+	0.5f,
+	TEXT("服务器射速校验允许的突发量（按 FireRate 折算的秒数），用于吸收网络抖动。"),
+	ECVF_Default);
 
 // 设置默认值
 AFPSCharacter::AFPSCharacter()
 {
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+
 	// 设置此角色每帧调用Tick()。如果不需要，可以关闭以提高性能。
 	PrimaryActorTick.bCanEverTick = true;
 
+	// 第一人称相机与手臂只用于本地表现：服务器版本不创建（非服务器版本以 -server 运行时在 PostInitializeComponents 中移除）
+#if !UE_SERVER
 	// 创建并初始化第一人称相机组件
 	FPSCameraComponent = CreateDefaultSubobject<UCameraComponent>(TEXT("FirstPersonCamera"));
 	check(FPSCameraComponent != nullptr); // 确保相机创建成功
@@ -33,37 +76,330 @@ AFPSCharacter::AFPSCharacter()
 	// 禁用动态阴影投射以提高性能
 	FPSMesh->bCastDynamicShadow = false;
 	FPSMesh->CastShadow = false;
+#endif
 
 	// 设置第三人称网格对所有者不可见（避免穿模）
 	GetMesh()->SetOwnerNoSee(true);
+	// 启用更新频率优化：由动画预算子系统按重要度设置更新间隔，跳过的帧插值
+	GetMesh()->bEnableUpdateRateOptimizations = true;
 
 	// 设置最大跳跃次数（2表示允许二段跳）
 	JumpMaxCount = 2;
 	// 设置射击速率（每秒2发）
 	FireRate = 2.0f;
-	// 初始化上次射击时间为0
-	LastFireTime = 0.0f;
+	// 设置枪口偏移量（在摄像机前方100单位）
+	MuzzleOffset.Set(100.0f, 0.0f, 0.0f);
+	// 预热的子弹数量：足以覆盖默认射速下子弹寿命内的全部在途子弹
+	ProjectilePoolPrewarmCount = 16;
+	// 默认发射实体子弹
+	FireMode = EFPSFireMode::Projectile;
+	HitscanRange = 10000.0f;
+	HitscanRadius = 0.0f;
+
+	// 默认命中盒：UE5 标准人体骨骼的头、胸、骨盆
+	const TPair<FName, float> DefaultHitboxes[] = {
+		{ TEXT("head"), 12.0f },
+		{ TEXT("spine_03"), 22.0f },
+		{ TEXT("pelvis"), 20.0f },
+	};
+	for (const TPair<FName, float>& Hitbox : DefaultHitboxes)
+	{
+		FFPSHitboxDef& Def = Hitboxes.AddDefaulted_GetRef();
+		Def.BoneName = Hitbox.Key;
+		Def.Radius = Hitbox.Value;
+	}
+}
+
+// 组件初始化完成后调用
+void AFPSCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// 专用服务器上没有本地视角：移除第一人称手臂与相机（视角由 GetActorEyesViewPoint 提供，不依赖相机）
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		if (FPSMesh)
+		{
+			FPSMesh->DestroyComponent();
+			FPSMesh = nullptr;
+		}
+		if (FPSCameraComponent)
+		{
+			FPSCameraComponent->DestroyComponent();
+			FPSCameraComponent = nullptr;
+		}
+	}
 }
 
 // 游戏开始或角色生成时调用
 void AFPSCharacter::BeginPlay()
 {
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+
 	Super::BeginPlay();
 
-	// 在屏幕上显示调试消息5秒
-	check(GEngine != nullptr);
-	GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Hello Unreal, this message come FPSCharacter"));
+	const bool bDedicatedServer = IsNetMode(NM_DedicatedServer);
+
+	// 在屏幕上显示调试消息5秒（专用服务器上没有屏幕）
+	if (!bDedicatedServer)
+	{
+		check(GEngine != nullptr);
+		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, TEXT("Hello Unreal, this message come FPSCharacter"));
+	}
+
+	// 预热子弹对象池，避免开火时才生成子弹
+	if (ProjectileClass)
+	{
+		if (UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+		{
+			Pool->Prewarm(ProjectileClass, ProjectilePoolPrewarmCount);
+		}
+	}
+
+	// 服务器：参与延迟补偿
+	if (HasAuthority())
+	{
+		InitializeHitboxHistory();
+	}
+
+	// 动画预算：第一人称手臂按控制方式开关，第三人称网格交给预算子系统
+	// 专用服务器上没有命中盒骨骼需要刷新时，姿势无人使用，只保留蒙太奇（根运动）更新
+	UpdateFirstPersonMeshTick();
+	if (bDedicatedServer && HitboxBoneIndices.Num() == 0)
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+	else if (UFPSAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UFPSAnimationBudgetSubsystem>())
+	{
+		AnimBudget->RegisterCharacter(this);
+	}
+
+	// Tick 重要度：远离视角的角色降低 Actor 与移动组件的 Tick 频率
+	if (UFPSTickSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>())
+	{
+		Significance->RegisterCharacter(this);
+	}
+
+	// 装备默认武器（各端各自加载）
+	if (DefaultWeapon.IsValid())
+	{
+		EquipWeapon(DefaultWeapon);
+	}
+}
+
+// 角色销毁或关卡结束时调用
+void AFPSCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// 角色被销毁时卸下武器；关卡结束时只释放资产句柄，对象池随世界一起销毁
+	if (EndPlayReason == EEndPlayReason::Destroyed)
+	{
+		UnequipWeapon();
+	}
+	else if (WeaponAssetsHandle.IsValid())
+	{
+		WeaponAssetsHandle->CancelHandle();
+		WeaponAssetsHandle.Reset();
+	}
+
+	if (UFPSLagCompensationSubsystem* LagComp = GetWorld()->GetSubsystem<UFPSLagCompensationSubsystem>())
+	{
+		LagComp->UnregisterCharacter(this);
+	}
+
+	if (UFPSAnimationBudgetSubsystem* AnimBudget = GetWorld()->GetSubsystem<UFPSAnimationBudgetSubsystem>())
+	{
+		AnimBudget->UnregisterCharacter(this);
+	}
+
+	if (UFPSTickSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>())
+	{
+		Significance->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// 控制器变化：本地玩家接管或离开时切换第一人称手臂
+void AFPSCharacter::NotifyControllerChanged()
+{
+	Super::NotifyControllerChanged();
+
+	if (HasActorBegunPlay())
+	{
+		UpdateFirstPersonMeshTick();
+	}
+}
+
+// 第一人称手臂只对本地玩家可见（SetOnlyOwnerSee），其他情况下评估 ABP_Arms 纯属浪费
+void AFPSCharacter::UpdateFirstPersonMeshTick()
+{
+	if (!FPSMesh)
+	{
+		return;
+	}
+
+	const bool bLocalPlayer = IsLocallyControlled() && IsPlayerControlled() && !IsRunningDedicatedServer();
+
+	FPSMesh->SetComponentTickEnabled(bLocalPlayer);
+	FPSMesh->bNoSkeletonUpdate = !bLocalPlayer;
+	FPSMesh->VisibilityBasedAnimTickOption = bLocalPlayer
+		? EVisibilityBasedAnimTickOption::AlwaysTickPose
+		: EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered;
+}
+
+// 装备武器：通过 AssetManager 异步加载武器定义及其 "Equipped" 资产包
+void AFPSCharacter::EquipWeapon(FPrimaryAssetId WeaponId)
+{
+	UnequipWeapon();
+
+	if (!WeaponId.IsValid())
+	{
+		return;
+	}
+
+	EquippedWeaponId = WeaponId;
+
+	// 递归加载资产包：武器定义 -> 子弹类、弹道配置 -> 弹道配置中的网格
+	// 句柄保存在角色上，多个角色装备同一武器时资产按句柄引用计数，最后一个句柄释放后才可被卸载
+	WeaponAssetsHandle = UAssetManager::Get().PreloadPrimaryAssets(
+		{ WeaponId },
+		{ UFPSWeaponDefinition::EquippedBundle },
+		/*bLoadRecursive*/ true,
+		FStreamableDelegate::CreateUObject(this, &AFPSCharacter::OnWeaponAssetsLoaded, WeaponId));
+
+	// 没有需要加载的内容（已在内存中或资产不存在）时不会返回句柄，直接尝试生效
+	if (!WeaponAssetsHandle.IsValid())
+	{
+		OnWeaponAssetsLoaded(WeaponId);
+	}
+}
+
+// 武器资产加载完成：用武器定义覆盖射击参数
+void AFPSCharacter::OnWeaponAssetsLoaded(FPrimaryAssetId WeaponId)
+{
+	// 加载期间已换装或卸下
+	if (WeaponId != EquippedWeaponId)
+	{
+		return;
+	}
+
+	const UFPSWeaponDefinition* Weapon = Cast<UFPSWeaponDefinition>(UAssetManager::Get().GetPrimaryAssetObject(WeaponId));
+	if (!Weapon)
+	{
+		UE_LOG(LogFPSDemo, Warning, TEXT("%s: failed to load weapon %s"), *GetName(), *WeaponId.ToString());
+		EquippedWeaponId = FPrimaryAssetId();
+		return;
+	}
+
+	EquippedWeapon = Weapon;
+	BallisticProfile = Weapon->BallisticProfile.Get();
+
+	FireRate = Weapon->FireRate;
+	FireMode = Weapon->FireMode;
+	MuzzleOffset = Weapon->MuzzleOffset;
+	HitscanRange = Weapon->HitscanRange;
+	HitscanRadius = Weapon->HitscanRadius;
+	ProjectilePoolPrewarmCount = Weapon->PoolPrewarmCount;
+
+	// 武器未指定子弹类时沿用角色上的设置
+	if (UClass* WeaponProjectileClass = Weapon->ProjectileClass.Get())
+	{
+		ProjectileClass = WeaponProjectileClass;
+	}
+
+	FireScheduler.Reset();
+
+	if (ProjectileClass)
+	{
+		if (UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+		{
+			Pool->Prewarm(ProjectileClass, ProjectilePoolPrewarmCount);
+		}
+	}
+}
+
+// 卸下武器：恢复类默认的射击参数并释放武器资产
+void AFPSCharacter::UnequipWeapon()
+{
+	if (!EquippedWeaponId.IsValid())
+	{
+		return;
+	}
+
+	const TSubclassOf<AProjetileActor> WeaponProjectileClass = ProjectileClass;
+
+	const AFPSCharacter* Defaults = GetClass()->GetDefaultObject<AFPSCharacter>();
+	FireRate = Defaults->FireRate;
+	FireMode = Defaults->FireMode;
+	MuzzleOffset = Defaults->MuzzleOffset;
+	HitscanRange = Defaults->HitscanRange;
+	HitscanRadius = Defaults->HitscanRadius;
+	ProjectilePoolPrewarmCount = Defaults->ProjectilePoolPrewarmCount;
+	ProjectileClass = Defaults->ProjectileClass;
+
+	EquippedWeaponId = FPrimaryAssetId();
+	EquippedWeapon = nullptr;
+	BallisticProfile = nullptr;
+	FireScheduler.Reset();
+
+	// 仍在加载时一并取消完成回调
+	if (WeaponAssetsHandle.IsValid())
+	{
+		WeaponAssetsHandle->CancelHandle();
+		WeaponAssetsHandle.Reset();
+	}
+
+	// 世界中已没有角色使用该子弹类时清空对象池，释放对子弹类的引用；在途子弹回收时直接销毁
+	if (!WeaponProjectileClass || WeaponProjectileClass == ProjectileClass)
+	{
+		return;
+	}
+
+	for (TActorIterator<AFPSCharacter> It(GetWorld()); It; ++It)
+	{
+		if (*It != this && It->ProjectileClass == WeaponProjectileClass)
+		{
+			return;
+		}
+	}
+
+	if (UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+	{
+		Pool->Drain(WeaponProjectileClass);
+	}
+}
+
+// 当前发射的子弹的弹道参数
+bool AFPSCharacter::GetBallisticParams(FFPSBallisticParams& OutParams) const
+{
+	if (FireMode != EFPSFireMode::Projectile || !ProjectileClass)
+	{
+		return false;
+	}
+
+	OutParams = FFPSBallisticParams::Make(*ProjectileClass->GetDefaultObject<AProjetileActor>(), BallisticProfile, GetWorld()->GetGravityZ());
+	return true;
 }
 
 // 每帧调用
 void AFPSCharacter::Tick(float DeltaTime)
 {
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+
 	Super::Tick(DeltaTime);
+
+	// 结算本帧的射击：只有本地控制的角色（玩家或服务器上的 AI）读取扳机，远端角色的射击来自 RPC
+	if (IsLocallyControlled())
+	{
+		TickFireScheduler(DeltaTime);
+	}
 }
 
 // 绑定功能到输入
 void AFPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 {
+	LLM_SCOPE_BYTAG(FPSDemo_Input);
+
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
 
 	// 获取玩家控制器并添加强制输入映射上下文
@@ -93,6 +429,14 @@ void AFPSCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCompon
 // 处理移动输入
 void AFPSCharacter::Move(const FInputActionValue& Value)
 {
+	FPS_SCOPE_CYCLE_COUNTER(STAT_FPSCharacterMove);
+
+	// 输入录制
+	if (UFPSInputReplaySubsystem* Recorder = InputRecorder.Get())
+	{
+		Recorder->CaptureInput(EFPSInputChannel::Move, Value);
+	}
+
 	// 获取二维移动向量（X: 左右, Y: 前后）
 	FVector2D MovementVector = Value.Get<FVector2D>();
 
@@ -116,21 +460,48 @@ void AFPSCharacter::Move(const FInputActionValue& Value)
 // 处理视角转动输入
 void AFPSCharacter::Look(const FInputActionValue& Value)
 {
+	FPS_SCOPE_CYCLE_COUNTER(STAT_FPSCharacterLook);
+
+	// 输入录制
+	if (UFPSInputReplaySubsystem* Recorder = InputRecorder.Get())
+	{
+		Recorder->CaptureInput(EFPSInputChannel::Look, Value);
+	}
+
 	// 获取二维视角转动向量（X: 水平, Y: 垂直）
 	FVector2D LookAxisVector = Value.Get<FVector2D>();
 
-	if (Controller != nullptr)
+	if (Controller == nullptr)
+	{
+		return;
+	}
+
+	if (Controller->IsLocalPlayerController())
 	{
 		// 添加偏航（左右看）输入
 		AddControllerYawInput(LookAxisVector.X);
 		// 添加俯仰（上下看）输入（取反因为屏幕坐标与游戏世界坐标方向相反）
 		AddControllerPitchInput(-LookAxisVector.Y);
 	}
+	else
+	{
+		// AI 控制器没有输入缩放与视角限制，直接以角度修改控制旋转
+		FRotator ControlRotation = Controller->GetControlRotation();
+		ControlRotation.Yaw = FRotator::NormalizeAxis(ControlRotation.Yaw + LookAxisVector.X);
+		ControlRotation.Pitch = FMath::Clamp(FRotator::NormalizeAxis(ControlRotation.Pitch - LookAxisVector.Y), -89.0f, 89.0f);
+		Controller->SetControlRotation(ControlRotation);
+	}
 }
 
 // 处理开始跳跃输入
 void AFPSCharacter::StartJump(const FInputActionValue& Value)
 {
+	// 输入录制
+	if (UFPSInputReplaySubsystem* Recorder = InputRecorder.Get())
+	{
+		Recorder->CaptureInput(EFPSInputChannel::StartJump, Value);
+	}
+
 	// 调用父类的Jump方法
 	Jump();
 }
@@ -138,6 +509,12 @@ void AFPSCharacter::StartJump(const FInputActionValue& Value)
 // 处理停止跳跃输入
 void AFPSCharacter::StopJump(const FInputActionValue& Value)
 {
+	// 输入录制
+	if (UFPSInputReplaySubsystem* Recorder = InputRecorder.Get())
+	{
+		Recorder->CaptureInput(EFPSInputChannel::StopJump, Value);
+	}
+
 	// 调用父类的StopJumping方法
 	StopJumping();
 }
@@ -145,57 +522,375 @@ void AFPSCharacter::StopJump(const FInputActionValue& Value)
 // 处理射击输入
 void AFPSCharacter::Shoot(const FInputActionValue& Value)
 {
-	// 检查开火冷却时间
-	const float CurrentTime = GetWorld()->GetTimeSeconds();
-	//每次开火至少需要等待的秒数
-	float TimeBetweenShots = 1.0f / FireRate;   // FireRate = 2 ⇒ 0.5 s
-	// 下一次允许开火的时间
-	float NextFireTime = LastFireTime + TimeBetweenShots;
-	if (CurrentTime < NextFireTime)
+	FPS_SCOPE_CYCLE_COUNTER(STAT_FPSCharacterShoot);
+	LLM_SCOPE_BYTAG(FPSDemo_Input);
+	FPS_ALLOC_SCOPE(Shot);
+
+	// 输入录制
+	if (UFPSInputReplaySubsystem* Recorder = InputRecorder.Get())
 	{
-		return; // 如果未达到开火间隔，直接返回
+		Recorder->CaptureInput(EFPSInputChannel::Shoot, Value);
 	}
 
-	// 更新上次开火时间
-	LastFireTime = CurrentTime;
+	// 只记录本帧扳机处于按下状态，实际开火由 Tick 中的开火调度器按固定间隔统一结算
+	bTriggerHeld = true;
+}
+
+// 计算当前的枪口位置与朝向
+void AFPSCharacter::GetMuzzleTransform(FVector& OutLocation, FRotator& OutRotation) const
+{
+	// 获取摄像机位置和旋转
+	FVector CameraLocation;
+	FRotator CameraRotation;
+	GetActorEyesViewPoint(CameraLocation, CameraRotation);
+
+	// 将偏移量从本地空间转换到世界空间
+	OutLocation = CameraLocation + FTransform(CameraRotation).TransformVector(MuzzleOffset);
+
+	// 使用摄像机旋转作为子弹初始旋转
+	OutRotation = CameraRotation;
+	// 可以在此处添加额外的俯仰调整（已注释掉）
+	// OutRotation.Pitch += 10.0f;
+}
+
+// 开火调度：结算本帧欠下的全部射击，并为每一发插值枪口变换
+void AFPSCharacter::TickFireScheduler(float DeltaTime)
+{
+	FVector MuzzleLocation;
+	FRotator MuzzleRotation;
+	GetMuzzleTransform(MuzzleLocation, MuzzleRotation);
+	const FQuat MuzzleQuat = MuzzleRotation.Quaternion();
+
+	// 第一帧没有上一帧的枪口数据，使用当前值
+	if (!bHasPreviousMuzzle)
+	{
+		PreviousMuzzleLocation = MuzzleLocation;
+		PreviousMuzzleQuat = MuzzleQuat;
+		bHasPreviousMuzzle = true;
+	}
+
+	const double FrameEndTime = GetWorld()->GetTimeSeconds();
+	const double FrameStartTime = FrameEndTime - DeltaTime;
+
+	ShotTimesScratch.Reset();
+	FireScheduler.Advance(FrameStartTime, FrameEndTime, 1.0 / FireRate, bTriggerHeld, ShotTimesScratch);
+	bTriggerHeld = false;
+
+	if (ShotTimesScratch.Num() > 0)
+	{
+		FireBatchScratch.Reset();
+		for (const double ShotTime : ShotTimesScratch)
+		{
+			// 按开火时间在上一帧与本帧的枪口变换之间插值
+			const float Alpha = DeltaTime > 0.0f ? FMath::Clamp(static_cast<float>((ShotTime - FrameStartTime) / DeltaTime), 0.0f, 1.0f) : 1.0f;
+
+			FFPSFireShot& Shot = FireBatchScratch.AddDefaulted_GetRef();
+			Shot.MuzzleLocation = FMath::Lerp(PreviousMuzzleLocation, MuzzleLocation, Alpha);
+			Shot.MuzzleRotation = FQuat::Slerp(PreviousMuzzleQuat, MuzzleQuat, Alpha).Rotator();
+			Shot.Timestamp = ShotTime;
+		}
+
+		FireShots(FireBatchScratch);
+	}
+
+	PreviousMuzzleLocation = MuzzleLocation;
+	PreviousMuzzleQuat = MuzzleQuat;
+
+	// 客户端：到达合并间隔后把积攒的射击发给服务器
+	if (PendingServerBatch.Shots.Num() > 0 && GetWorld()->GetTimeSeconds() - LastServerBatchSendTime >= CVarFireBatchInterval.GetValueOnGameThread())
+	{
+		FlushServerFireBatch();
+	}
+}
+
+// 一次性发射一批射击
+void AFPSCharacter::FireShots(TConstArrayView<FFPSFireShot> Shots)
+{
+	FPS_SCOPE_CYCLE_COUNTER(STAT_FPSCharacterFireShots);
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+	FPS_ALLOC_SCOPE(Shot);
+	INC_DWORD_STAT_BY(STAT_FPSShotsFired, Shots.Num());
+	FPSAllocationTracker::AddShots(Shots.Num());
+
+	// 服务器（及单机）发射权威子弹；客户端只做本地预测表现，命中结果以服务器为准
+	const bool bAuthority = HasAuthority();
 
+	// 遥测：只记录权威端的射击
+	if (bAuthority)
+	{
+		if (UFPSTelemetrySubsystem* Telemetry = GetWorld()->GetSubsystem<UFPSTelemetrySubsystem>())
+		{
+			for (const FFPSFireShot& Shot : Shots)
+			{
+				Telemetry->RecordShot(this, Shot.MuzzleLocation, Shot.MuzzleRotation.Vector(), Shot.Timestamp, FireMode == EFPSFireMode::Hitscan);
+			}
+		}
+	}
+
+	for (const FFPSFireShot& Shot : Shots)
+	{
+		// 根据开火方式发射子弹或排队即时命中射线
+		if (FireMode == EFPSFireMode::Hitscan)
+		{
+			// 即时命中没有可预测的表现，只在服务器上结算
+			if (bAuthority)
+			{
+				FireHitscan(Shot);
+			}
+		}
+		else
+		{
+			FireProjectile(Shot, !bAuthority);
+		}
+	}
+
+	if (!bAuthority)
+	{
+		QueueServerShots(Shots);
+	}
+	else if (GetNetMode() != NM_Standalone && FireMode == EFPSFireMode::Projectile)
+	{
+		// 通知其他客户端生成表现子弹；子弹本身不复制
+		FFPSFireBatch Batch;
+		for (const FFPSFireShot& Shot : Shots)
+		{
+			FFPSNetShot& NetShot = Batch.Shots.AddDefaulted_GetRef();
+			NetShot.Origin = Shot.MuzzleLocation;
+			NetShot.Direction = Shot.MuzzleRotation.Vector();
+			NetShot.ServerTime = Shot.Timestamp;
+		}
+		MulticastFireBatch(Batch);
+	}
+}
+
+// 发射实体子弹
+void AFPSCharacter::FireProjectile(const FFPSFireShot& Shot, bool bCosmeticOnly)
+{
 	// 检查子弹类是否有效
+	if (!ProjectileClass)
+	{
+		return;
+	}
+
+	// 获取世界上下文
+	UWorld* World = GetWorld();
+	UProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr;
+	if (Pool)
+	{
+		// 从对象池取出子弹并放置在枪口位置（所有者为自己，发起者为当前 Instigator）
+		AProjetileActor* Projectile = Pool->Acquire(ProjectileClass, Shot.MuzzleLocation, Shot.MuzzleRotation, this, GetInstigator());
+
+		if (Projectile)
+		{
+			Projectile->ApplyBallisticProfile(BallisticProfile);
+			Projectile->SetCosmeticOnly(bCosmeticOnly);
+
+			// 设置子弹的发射方向；按开火时间戳补足本帧内已经飞行的时间
+			FVector LaunchDirection = Shot.MuzzleRotation.Vector();
+			Projectile->ShootInDirectionAt(LaunchDirection, Shot.Timestamp);
+		}
+	}
+}
+
+// 排队一次即时命中射击，结果在下一帧批量处理
+void AFPSCharacter::FireHitscan(const FFPSFireShot& Shot)
+{
+	UWorld* World = GetWorld();
+	UHitscanTraceSubsystem* Hitscan = World ? World->GetSubsystem<UHitscanTraceSubsystem>() : nullptr;
+	if (!Hitscan)
+	{
+		return;
+	}
+
+	FHitscanShotParams Params;
+	Params.Range = HitscanRange;
+	Params.Radius = HitscanRadius;
+	Params.RewindTime = Shot.RewindTime;
+
+	// 冲量、伤害与碰撞预设沿用子弹类的设置，保证与实体子弹命中时的表现一致
 	if (ProjectileClass)
 	{
-		// 获取摄像机位置和旋转
-		FVector CameraLocation;
-		FRotator CameraRotation;
-		GetActorEyesViewPoint(CameraLocation, CameraRotation);
+		const AProjetileActor* ProjectileDefaults = ProjectileClass->GetDefaultObject<AProjetileActor>();
+		Params.ImpactSpeed = BallisticProfile ? BallisticProfile->InitialSpeed : ProjectileDefaults->ProjectileMovementComponent->InitialSpeed;
+		Params.Damage = BallisticProfile ? BallisticProfile->Damage : ProjectileDefaults->HitDamage;
+		Params.CollisionProfile = ProjectileDefaults->CollisionComponent->GetCollisionProfileName();
+	}
 
-		// 设置枪口偏移量（在摄像机前方100单位）
-		MuzzleOffset.Set(100.0f, 0.0f, 0.0f);
+	Hitscan->QueueShot(this, Shot.MuzzleLocation, Shot.MuzzleRotation.Vector(), Params);
+}
 
-		// 将偏移量从本地空间转换到世界空间
-		FVector MuzzleLocation = CameraLocation + FTransform(CameraRotation).TransformVector(MuzzleOffset);
+// 服务器世界时间与本地世界时间之差
+double AFPSCharacter::GetServerTimeOffset() const
+{
+	const UWorld* World = GetWorld();
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() - World->GetTimeSeconds() : 0.0;
+}
 
-		// 使用摄像机旋转作为子弹初始旋转
-		FRotator MuzzleRotation = CameraRotation;
-		// 可以在此处添加额外的俯仰调整（已注释掉）
-		// MuzzleRotation.Pitch += 10.0f;
+// 客户端：把射击换算为服务器时间后加入待发送批次
+void AFPSCharacter::QueueServerShots(TConstArrayView<FFPSFireShot> Shots)
+{
+	const double ServerTimeOffset = GetServerTimeOffset();
 
-		// 获取世界上下文
-		UWorld* World = GetWorld();
-		if (World)
+	for (const FFPSFireShot& Shot : Shots)
+	{
+		if (PendingServerBatch.Shots.Num() >= FFPSFireBatch::MaxShots)
 		{
-			// 设置生成参数
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Owner = this;        // 设置子弹所有者
-			SpawnParams.Instigator = GetInstigator(); // 设置发起者
+			FlushServerFireBatch();
+		}
 
-			// 在枪口位置生成子弹
-			AProjetileActor* Projectile = World->SpawnActor<AProjetileActor>(ProjectileClass, MuzzleLocation, MuzzleRotation, SpawnParams);
+		FFPSNetShot& NetShot = PendingServerBatch.Shots.AddDefaulted_GetRef();
+		NetShot.Origin = Shot.MuzzleLocation;
+		NetShot.Direction = Shot.MuzzleRotation.Vector();
+		NetShot.ServerTime = Shot.Timestamp + ServerTimeOffset;
+	}
+}
 
-			if (Projectile)
-			{
-				// 设置子弹的发射方向
-				FVector LaunchDirection = MuzzleRotation.Vector();
-				Projectile->ShootInDirection(LaunchDirection);
-			}
+// 客户端：发送待发送批次
+void AFPSCharacter::FlushServerFireBatch()
+{
+	ServerFireBatch(PendingServerBatch);
+	PendingServerBatch.Shots.Reset();
+	LastServerBatchSendTime = GetWorld()->GetTimeSeconds();
+}
+
+bool AFPSCharacter::ServerFireBatch_Validate(const FFPSFireBatch& Batch)
+{
+	return Batch.Shots.Num() <= FFPSFireBatch::MaxShots;
+}
+
+// 服务器：校验客户端的射击并发射权威子弹
+void AFPSCharacter::ServerFireBatch_Implementation(const FFPSFireBatch& Batch)
+{
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+	FPS_ALLOC_SCOPE(Shot);
+
+	UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+
+	// 射速校验：令牌桶按 FireRate 回填，超出部分丢弃
+	const double MaxCredit = FireRate * CVarFireRateBurstSeconds.GetValueOnGameThread() + 1.0;
+	ServerShotCredit = FMath::Min(ServerShotCredit + (Now - ServerShotCreditTime) * FireRate, MaxCredit);
+	ServerShotCreditTime = Now;
+
+	FVector ServerMuzzleLocation;
+	FRotator ServerMuzzleRotation;
+	GetMuzzleTransform(ServerMuzzleLocation, ServerMuzzleRotation);
+	const double MaxMuzzleErrorSquared = FMath::Square(CVarMaxMuzzleError.GetValueOnGameThread());
+
+	const UFPSLagCompensationSubsystem* LagComp = World->GetSubsystem<UFPSLagCompensationSubsystem>();
+	const double RewindTime = LagComp ? LagComp->GetRewindTime(this) : 0.0;
+
+	FireBatchScratch.Reset();
+	int32 NumRejected = 0;
+	for (const FFPSNetShot& NetShot : Batch.Shots)
+	{
+		if (ServerShotCredit < 1.0)
+		{
+			++NumRejected;
+			continue;
 		}
+		ServerShotCredit -= 1.0;
+
+		FFPSFireShot& Shot = FireBatchScratch.AddDefaulted_GetRef();
+		// 起点与服务器上的枪口偏差超出移动预测误差时，改用服务器位置
+		Shot.MuzzleLocation = FVector::DistSquared(NetShot.Origin, ServerMuzzleLocation) <= MaxMuzzleErrorSquared ? NetShot.Origin : ServerMuzzleLocation;
+		Shot.MuzzleRotation = NetShot.Direction.Rotation();
+		// 客户端时间只作参考：限制在本帧之内
+		Shot.Timestamp = FMath::Clamp(NetShot.ServerTime, Now - World->GetDeltaSeconds(), Now);
+		// 命中判定回溯到射手开火时看到的时间
+		Shot.RewindTime = RewindTime;
+	}
+
+	if (UFPSNetStatsSubsystem* NetStats = World->GetSubsystem<UFPSNetStatsSubsystem>())
+	{
+		NetStats->RecordFireBatch(GetNetConnection(), Batch, NumRejected);
+	}
+
+	if (FireBatchScratch.Num() > 0)
+	{
+		FireShots(FireBatchScratch);
 	}
-}
\ No newline at end of file
+}
+
+// 其他客户端：根据服务器广播生成表现子弹
+void AFPSCharacter::MulticastFireBatch_Implementation(const FFPSFireBatch& Batch)
+{
+	LLM_SCOPE_BYTAG(FPSDemo_Character);
+	FPS_ALLOC_SCOPE(Shot);
+
+	// 服务器已发射权威子弹，拥有者已在本地预测，二者都跳过
+	if (HasAuthority() || IsLocallyControlled())
+	{
+		return;
+	}
+
+	const UWorld* World = GetWorld();
+	const double Now = World->GetTimeSeconds();
+	const double ServerTimeOffset = GetServerTimeOffset();
+
+	for (const FFPSNetShot& NetShot : Batch.Shots)
+	{
+		FFPSFireShot Shot;
+		Shot.MuzzleLocation = NetShot.Origin;
+		Shot.MuzzleRotation = NetShot.Direction.Rotation();
+		Shot.Timestamp = FMath::Clamp(NetShot.ServerTime - ServerTimeOffset, Now - World->GetDeltaSeconds(), Now);
+		FireProjectile(Shot, true);
+	}
+}
+
+// 服务器：解析命中盒骨骼并开始记录快照
+void AFPSCharacter::InitializeHitboxHistory()
+{
+	UFPSLagCompensationSubsystem* LagComp = GetWorld()->GetSubsystem<UFPSLagCompensationSubsystem>();
+	if (!LagComp)
+	{
+		return;
+	}
+
+	HitboxBoneIndices.Reset();
+	HitboxBoneNames.Reset();
+	TArray<float, TInlineAllocator<FHitboxSnapshot::MaxHitboxes>> Radii;
+
+	const USkeletalMeshComponent* BodyMesh = GetMesh();
+	for (const FFPSHitboxDef& Hitbox : Hitboxes)
+	{
+		const int32 BoneIndex = BodyMesh ? BodyMesh->GetBoneIndex(Hitbox.BoneName) : INDEX_NONE;
+		if (BoneIndex == INDEX_NONE || Radii.Num() == FHitboxSnapshot::MaxHitboxes)
+		{
+			continue;
+		}
+		HitboxBoneIndices.Add(BoneIndex);
+		HitboxBoneNames.Add(Hitbox.BoneName);
+		Radii.Add(Hitbox.Radius);
+	}
+
+	// 专用服务器默认不刷新不可见网格的骨骼，命中盒需要它们
+	if (HitboxBoneIndices.Num() > 0 && IsRunningDedicatedServer())
+	{
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
+	HitboxHistory.Initialize(Radii);
+	LagComp->RegisterCharacter(this);
+}
+
+// 延迟补偿：记录当前的胶囊体与命中盒快照
+void AFPSCharacter::RecordHitboxSnapshot(double Time)
+{
+	const UCapsuleComponent* Capsule = GetCapsuleComponent();
+
+	TArray<FVector, TInlineAllocator<FHitboxSnapshot::MaxHitboxes>> HitboxCenters;
+	for (const int32 BoneIndex : HitboxBoneIndices)
+	{
+		HitboxCenters.Add(GetMesh()->GetBoneTransform(BoneIndex).GetLocation());
+	}
+
+	HitboxHistory.Record(Time, Capsule->GetComponentLocation(), Capsule->GetScaledCapsuleRadius(), Capsule->GetScaledCapsuleHalfHeight(), HitboxCenters);
+}
+
+// 延迟补偿：命中盒对应的骨骼名称
+FName AFPSCharacter::GetHitboxBoneName(int32 HitboxIndex) const
+{
+	return HitboxBoneNames.IsValidIndex(HitboxIndex) ? HitboxBoneNames[HitboxIndex] : NAME_None;
+}
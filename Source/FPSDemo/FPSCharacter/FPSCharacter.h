@@ -6,10 +6,20 @@
 #include "GameFramework/Character.h"
 #include "EnhancedInputLibrary.h" // 引入增强输入系统功能
 #include "Camera/CameraComponent.h" // 引入相机组件
+#include "FPSWeapon/FPSWeaponTypes.h" // 开火方式
+#include "FPSWeapon/FireScheduler.h" // 开火调度器
+#include "FPSNet/FPSFireBatch.h" // 网络开火批次
+#include "FPSNet/HitboxHistory.h" // 延迟补偿命中盒历史
+#include "UObject/PrimaryAssetId.h" // 武器主资产 ID
 #include "FPSCharacter.generated.h" // 包含由UHT生成的代码
 
 // 前向声明（在TSubclassOf中使用）
 class AProjetileActor;
+class UFPSWeaponDefinition;
+class UFPSBallisticProfile;
+class UFPSInputReplaySubsystem;
+struct FStreamableHandle;
+struct FFPSBallisticParams;
 
 /**
  * 第一人称视角（FPS）游戏角色类。
@@ -25,11 +35,11 @@ public:
 	// 构造函数，设置默认属性值
 	AFPSCharacter();
 
-	// 第一人称相机组件，仅玩家自己可见
+	// 第一人称相机组件，仅玩家自己可见（专用服务器上为空）
 	UPROPERTY(VisibleAnywhere, Category = "Camera")
 	UCameraComponent* FPSCameraComponent;
 
-	// 第一人称视角下可见的骨骼网格体（例如持枪的手臂）
+	// 第一人称视角下可见的骨骼网格体（例如持枪的手臂，专用服务器上为空）
 	UPROPERTY(VisibleAnywhere, Category = "FPSMesh")
 	USkeletalMeshComponent* FPSMesh;
 
@@ -38,22 +48,137 @@ private:
 	UPROPERTY(EditAnywhere, Category = "Shoot")
 	float FireRate;
 
-	// 记录上一次射击的时间，用于控制射击间隔
-	UPROPERTY(EditAnywhere, Category = "Shoot")
-	float LastFireTime;
+	// 固定步长开火调度器，保证任意帧率下射速精确等于 FireRate
+	FFireScheduler FireScheduler;
+
+	// 本帧扳机是否按下（由 Shoot 设置，Tick 结算后清除）
+	bool bTriggerHeld = false;
+
+	// 上一帧的枪口变换，用于为同一帧内的多发射击插值
+	FVector PreviousMuzzleLocation = FVector::ZeroVector;
+	FQuat PreviousMuzzleQuat = FQuat::Identity;
+	bool bHasPreviousMuzzle = false;
+
+	// 复用的临时数组，避免每帧分配
+	TArray<double, TInlineAllocator<8>> ShotTimesScratch;
+	TArray<FFPSFireShot, TInlineAllocator<8>> FireBatchScratch;
+
+	// 客户端：尚未发送给服务器的射击
+	FFPSFireBatch PendingServerBatch;
+	double LastServerBatchSendTime = 0.0;
+
+	// 服务器：射速校验的令牌桶
+	double ServerShotCredit = 0.0;
+	double ServerShotCreditTime = 0.0;
+
+	// 延迟补偿使用的命中盒（最多 FHitboxSnapshot::MaxHitboxes 个），为空或骨骼都不存在时使用胶囊体
+	UPROPERTY(EditAnywhere, Category = "LagCompensation")
+	TArray<FFPSHitboxDef> Hitboxes;
+
+	// 服务器：最近若干帧的命中盒快照
+	FHitboxHistory HitboxHistory;
+
+	// 服务器：实际生效的命中盒对应的骨骼序号与名称
+	TArray<int32, TInlineAllocator<FHitboxSnapshot::MaxHitboxes>> HitboxBoneIndices;
+	TArray<FName, TInlineAllocator<FHitboxSnapshot::MaxHitboxes>> HitboxBoneNames;
+
+	// 服务器：解析命中盒骨骼并开始记录快照
+	void InitializeHitboxHistory();
+
+	// 第一人称手臂只对本地玩家更新：其他角色（远端玩家、AI、专用服务器上的所有角色）关闭其 Tick 与骨骼刷新
+	void UpdateFirstPersonMeshTick();
 
 	// 从相机/角色位置发射子弹的偏移量，用于调整生成位置
 	UPROPERTY(EditAnywhere, Category = "Projectile")
 	FVector MuzzleOffset;
 
 	// 要生成的子弹类（使用TSubclassOf确保类型安全）
+	// 未装备武器时使用；使用 DefaultWeapon 时应在蓝图中清空，避免子弹资源随角色一起加载
 	UPROPERTY(EditAnywhere, Category = "Projectile")
 	TSubclassOf<class AProjetileActor> ProjectileClass;
 
+	// 开始游戏时装备的武器（FPSWeapon 主数据资产），其射击参数覆盖本类上的同名属性
+	UPROPERTY(EditAnywhere, Category = "Weapon", meta = (AllowedTypes = "FPSWeapon"))
+	FPrimaryAssetId DefaultWeapon;
+
+	// 当前装备（或正在加载）的武器
+	FPrimaryAssetId EquippedWeaponId;
+
+	// 已加载完成的武器定义与弹道配置
+	UPROPERTY(Transient)
+	TObjectPtr<const UFPSWeaponDefinition> EquippedWeapon;
+
+	UPROPERTY(Transient)
+	TObjectPtr<const UFPSBallisticProfile> BallisticProfile;
+
+	// 武器资产的加载句柄，持有期间资产保持加载
+	TSharedPtr<FStreamableHandle> WeaponAssetsHandle;
+
+	// 武器资产加载完成
+	void OnWeaponAssetsLoaded(FPrimaryAssetId WeaponId);
+
+	// 正在录制本角色输入的子系统（未录制时为空）
+	TWeakObjectPtr<UFPSInputReplaySubsystem> InputRecorder;
+
+	// 开始游戏时预热到对象池中的子弹数量
+	UPROPERTY(EditAnywhere, Category = "Projectile")
+	int32 ProjectilePoolPrewarmCount;
+
+	// 开火方式：发射实体子弹或即时命中
+	UPROPERTY(EditAnywhere, Category = "Shoot")
+	EFPSFireMode FireMode;
+
+	// 即时命中的最大射程（cm）
+	UPROPERTY(EditAnywhere, Category = "Shoot", meta = (EditCondition = "FireMode == EFPSFireMode::Hitscan"))
+	float HitscanRange;
+
+	// 即时命中的球形扫掠半径，0 表示使用射线
+	UPROPERTY(EditAnywhere, Category = "Shoot", meta = (EditCondition = "FireMode == EFPSFireMode::Hitscan"))
+	float HitscanRadius;
+
+	// 计算当前的枪口位置与朝向
+	void GetMuzzleTransform(FVector& OutLocation, FRotator& OutRotation) const;
+
+	// 开火调度：结算本帧欠下的全部射击
+	void TickFireScheduler(float DeltaTime);
+
+	// 一次性发射一批射击
+	void FireShots(TConstArrayView<FFPSFireShot> Shots);
+
+	// 从对象池取出子弹并沿枪口方向发射；bCosmeticOnly 为 true 时只做表现，不施加命中冲量
+	void FireProjectile(const FFPSFireShot& Shot, bool bCosmeticOnly);
+
+	// 排队一次异步即时命中射击
+	void FireHitscan(const FFPSFireShot& Shot);
+
+	// 服务器世界时间与本地世界时间之差（服务器上为 0）
+	double GetServerTimeOffset() const;
+
+	// 客户端：把射击加入待发送批次，按 fps.Net.FireBatchInterval 合并发送
+	void QueueServerShots(TConstArrayView<FFPSFireShot> Shots);
+	void FlushServerFireBatch();
+
+	// 客户端 -> 服务器：发送一批射击，服务器校验后发射权威子弹
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFireBatch(const FFPSFireBatch& Batch);
+
+	// 服务器 -> 其他客户端：生成纯表现子弹（不可靠，丢包只影响表现）
+	UFUNCTION(NetMulticast, Unreliable)
+	void MulticastFireBatch(const FFPSFireBatch& Batch);
+
 protected:
+	// 组件初始化完成后调用，专用服务器上在此移除纯表现组件
+	virtual void PostInitializeComponents() override;
+
 	// 游戏开始或角色生成时调用
 	virtual void BeginPlay() override;
 
+	// 角色销毁或关卡结束时调用
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// 控制器变化（占有、取消占有、客户端复制）时重新决定第一人称网格是否更新
+	virtual void NotifyControllerChanged() override;
+
 	// 默认输入映射上下文，用于将输入动作绑定到具体的按键/操作
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Input")
 	class UInputMappingContext* DefaultMappingContext;
@@ -95,4 +220,28 @@ public:
 
 	// 处理射击输入的回调函数
 	void Shoot(const FInputActionValue& Value);
+
+	// 装备武器：通过 AssetManager 异步加载武器定义及其子弹类、弹道配置，加载完成后生效
+	void EquipWeapon(FPrimaryAssetId WeaponId);
+
+	// 卸下武器：恢复默认射击参数，释放武器资产，并在无人使用时清空对象池中的对应子弹
+	void UnequipWeapon();
+
+	// 当前生效的武器定义（尚未加载完成时为空）
+	const UFPSWeaponDefinition* GetEquippedWeapon() const { return EquippedWeapon; }
+
+	// 当前发射的子弹的弹道参数（用于 FPSBallistics 的瞄准与预测）；即时命中或没有子弹类时返回 false
+	bool GetBallisticParams(FFPSBallisticParams& OutParams) const;
+
+	// 输入录制：设置后各输入处理函数把收到的输入转交给录制子系统
+	void SetInputRecorder(UFPSInputReplaySubsystem* Recorder) { InputRecorder = Recorder; }
+
+	// 延迟补偿：记录当前的胶囊体与命中盒快照（由 UFPSLagCompensationSubsystem 每帧调用）
+	void RecordHitboxSnapshot(double Time);
+
+	// 延迟补偿：命中盒历史
+	const FHitboxHistory& GetHitboxHistory() const { return HitboxHistory; }
+
+	// 延迟补偿：命中盒对应的骨骼名称，INDEX_NONE（胶囊体）返回 NAME_None
+	FName GetHitboxBoneName(int32 HitboxIndex) const;
 };
\ No newline at end of file
@@ -0,0 +1,391 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSCollision/FPSStaticCollisionBVH.h"
+#include "FPSDemoStats.h"
+#include "CollisionQueryParams.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/HitResult.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Math/VectorRegister.h"
+
+namespace FPSStaticCollisionBVH
+{
+    /* 方向分量为 0 时用的倒数，避免 0 * inf 产生 NaN */
+    constexpr float LargeInverse = 1.0e30f;
+
+    /* 遍历栈深度；中位数划分的树深约为 log2(N / 4)，64 足够 */
+    constexpr int32 MaxStackDepth = 64;
+
+    /** 射线在 SIMD 寄存器中的表示。W 分量让进入/离开时间自动夹到 [0, MaxTime]。 */
+    struct FRay
+    {
+        VectorRegister4Float Origin;
+        VectorRegister4Float InvDir;
+        VectorRegister4Float ExpandMin;
+        VectorRegister4Float ExpandMax;
+        float ExpandRadius;
+
+        FRay(const FVector3f& InOrigin, const FVector3f& Dir, float Radius)
+        {
+            const FVector3f Inv(
+                Dir.X != 0.0f ? 1.0f / Dir.X : FMath::Sign(Dir.X + UE_SMALL_NUMBER) * LargeInverse,
+                Dir.Y != 0.0f ? 1.0f / Dir.Y : FMath::Sign(Dir.Y + UE_SMALL_NUMBER) * LargeInverse,
+                Dir.Z != 0.0f ? 1.0f / Dir.Z : FMath::Sign(Dir.Z + UE_SMALL_NUMBER) * LargeInverse);
+
+            Origin = VectorLoadFloat3_W0(&InOrigin);
+            InvDir = MakeVectorRegisterFloat(Inv.X, Inv.Y, Inv.Z, 1.0f);
+            ExpandMin = MakeVectorRegisterFloat(Radius, Radius, Radius, 0.0f);
+            ExpandRadius = Radius;
+            SetMaxTime(1.0f);
+        }
+
+        void SetMaxTime(float MaxTime)
+        {
+            ExpandMax = MakeVectorRegisterFloat(ExpandRadius, ExpandRadius, ExpandRadius, MaxTime);
+        }
+
+        /**
+         * 射线与按球半径外扩后的包围盒求交（slab 测试）。
+         * 包围盒 W 分量为 0，因此 W 通道的进入时间为 0、离开时间为 MaxTime。
+         * @param OutEntryTime 命中时的进入时间
+         */
+        FORCEINLINE bool Intersects(const FVector3f& Min, const FVector3f& Max, float& OutEntryTime) const
+        {
+            const VectorRegister4Float BoxMin = VectorSubtract(VectorLoadFloat3_W0(&Min), ExpandMin);
+            const VectorRegister4Float BoxMax = VectorAdd(VectorLoadFloat3_W0(&Max), ExpandMax);
+
+            const VectorRegister4Float T1 = VectorMultiply(VectorSubtract(BoxMin, Origin), InvDir);
+            const VectorRegister4Float T2 = VectorMultiply(VectorSubtract(BoxMax, Origin), InvDir);
+
+            VectorRegister4Float Near = VectorMin(T1, T2);
+            VectorRegister4Float Far = VectorMax(T1, T2);
+
+            // 水平最大/最小值广播到所有通道
+            Near = VectorMax(Near, VectorSwizzle(Near, 2, 3, 0, 1));
+            Near = VectorMax(Near, VectorSwizzle(Near, 1, 0, 3, 2));
+            Far = VectorMin(Far, VectorSwizzle(Far, 2, 3, 0, 1));
+            Far = VectorMin(Far, VectorSwizzle(Far, 1, 0, 3, 2));
+
+            if (VectorAnyGreaterThan(Near, Far))
+            {
+                return false;
+            }
+
+            OutEntryTime = VectorGetComponent(Near, 0);
+            return true;
+        }
+    };
+}
+
+// ------------------------------------------------------------------
+// 构建：收集 WorldStatic 组件 -> 中位数划分 -> 按叶子顺序写入 SoA
+// ------------------------------------------------------------------
+void FFPSStaticCollisionBVH::Build(const UWorld* World)
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSStaticBVHBuild);
+
+    Reset();
+    if (!World)
+    {
+        return;
+    }
+
+    TArray<FBuildPrimitive> Primitives;
+    TArray<FBox> PrimitiveBoxes;
+
+    for (const ULevel* Level : World->GetLevels())
+    {
+        if (!Level || !Level->bIsVisible)
+        {
+            continue;
+        }
+
+        for (const AActor* Actor : Level->Actors)
+        {
+            if (!Actor)
+            {
+                continue;
+            }
+
+            Actor->ForEachComponent<UPrimitiveComponent>(false, [this, &Primitives, &PrimitiveBoxes](UPrimitiveComponent* Component)
+            {
+                if (!Component->IsRegistered()
+                    || !Component->IsQueryCollisionEnabled()
+                    || Component->GetCollisionObjectType() != ECC_WorldStatic
+                    || !Component->GetBodyInstance())
+                {
+                    return;
+                }
+
+                uint32 BlockMask = 0;
+                for (int32 Channel = 0; Channel < 32; ++Channel)
+                {
+                    if (Component->GetCollisionResponseToChannel(static_cast<ECollisionChannel>(Channel)) == ECR_Block)
+                    {
+                        BlockMask |= 1u << Channel;
+                    }
+                }
+                if (BlockMask == 0)
+                {
+                    return;
+                }
+
+                // 会移动的组件包围盒会过期，不进 BVH
+                if (Component->Mobility != EComponentMobility::Static)
+                {
+                    UncoveredComponents.Add(Component);
+                    UncoveredBlockMask.Add(BlockMask);
+                    return;
+                }
+
+                FBuildPrimitive& Primitive = Primitives.AddDefaulted_GetRef();
+                Primitive.Component = Component;
+                Primitive.BlockMask = BlockMask;
+                PrimitiveBoxes.Add(Component->Bounds.GetBox());
+                Bounds += PrimitiveBoxes.Last();
+            });
+        }
+    }
+
+    if (Primitives.Num() == 0)
+    {
+        return;
+    }
+
+    // 以中心为原点转为 float，大地图上也保留足够精度
+    Origin = Bounds.GetCenter();
+    for (int32 Index = 0; Index < Primitives.Num(); ++Index)
+    {
+        FBuildPrimitive& Primitive = Primitives[Index];
+        Primitive.Min = FVector3f(PrimitiveBoxes[Index].Min - Origin);
+        Primitive.Max = FVector3f(PrimitiveBoxes[Index].Max - Origin);
+        Primitive.Centroid = (Primitive.Min + Primitive.Max) * 0.5f;
+    }
+
+    Nodes.Reserve(Primitives.Num() * 2 / MaxLeafPrimitives + 1);
+    BuildRecursive(Primitives, 0, Primitives.Num());
+    Nodes.Shrink();
+
+    PrimMin.Reserve(Primitives.Num());
+    PrimMax.Reserve(Primitives.Num());
+    PrimBlockMask.Reserve(Primitives.Num());
+    PrimComponents.Reserve(Primitives.Num());
+    for (const FBuildPrimitive& Primitive : Primitives)
+    {
+        PrimMin.Add(Primitive.Min);
+        PrimMax.Add(Primitive.Max);
+        PrimBlockMask.Add(Primitive.BlockMask);
+        PrimComponents.Add(Primitive.Component);
+    }
+}
+
+int32 FFPSStaticCollisionBVH::BuildRecursive(TArray<FBuildPrimitive>& Primitives, int32 Begin, int32 End)
+{
+    const int32 NodeIndex = Nodes.AddDefaulted();
+
+    FVector3f Min(TNumericLimits<float>::Max());
+    FVector3f Max(TNumericLimits<float>::Lowest());
+    FVector3f CentroidMin(TNumericLimits<float>::Max());
+    FVector3f CentroidMax(TNumericLimits<float>::Lowest());
+    for (int32 Index = Begin; Index < End; ++Index)
+    {
+        const FBuildPrimitive& Primitive = Primitives[Index];
+        Min = Min.ComponentMin(Primitive.Min);
+        Max = Max.ComponentMax(Primitive.Max);
+        CentroidMin = CentroidMin.ComponentMin(Primitive.Centroid);
+        CentroidMax = CentroidMax.ComponentMax(Primitive.Centroid);
+    }
+
+    Nodes[NodeIndex].Min = Min;
+    Nodes[NodeIndex].Max = Max;
+
+    const int32 Count = End - Begin;
+    if (Count <= MaxLeafPrimitives)
+    {
+        Nodes[NodeIndex].Offset = Begin;
+        Nodes[NodeIndex].Count = Count;
+        return NodeIndex;
+    }
+
+    // 沿中心分布最长的轴按中位数划分
+    const FVector3f Extent = CentroidMax - CentroidMin;
+    const int32 Axis = Extent.X >= Extent.Y && Extent.X >= Extent.Z ? 0 : (Extent.Y >= Extent.Z ? 1 : 2);
+    Sort(Primitives.GetData() + Begin, Count, [Axis](const FBuildPrimitive& A, const FBuildPrimitive& B)
+    {
+        return A.Centroid[Axis] < B.Centroid[Axis];
+    });
+
+    const int32 Middle = Begin + Count / 2;
+    BuildRecursive(Primitives, Begin, Middle);
+    const int32 RightIndex = BuildRecursive(Primitives, Middle, End);
+
+    // 递归期间数组可能重新分配，只能按下标写回
+    Nodes[NodeIndex].Offset = RightIndex;
+    Nodes[NodeIndex].Count = 0;
+    return NodeIndex;
+}
+
+void FFPSStaticCollisionBVH::Reset()
+{
+    Origin = FVector::ZeroVector;
+    Bounds = FBox(ForceInit);
+    Nodes.Reset();
+    PrimMin.Reset();
+    PrimMax.Reset();
+    PrimBlockMask.Reset();
+    PrimComponents.Reset();
+    UncoveredComponents.Reset();
+    UncoveredBlockMask.Reset();
+}
+
+SIZE_T FFPSStaticCollisionBVH::GetAllocatedSize() const
+{
+    return Nodes.GetAllocatedSize()
+        + PrimMin.GetAllocatedSize()
+        + PrimMax.GetAllocatedSize()
+        + PrimBlockMask.GetAllocatedSize()
+        + PrimComponents.GetAllocatedSize()
+        + UncoveredComponents.GetAllocatedSize()
+        + UncoveredBlockMask.GetAllocatedSize();
+}
+
+// ------------------------------------------------------------------
+// 扫掠：由近到远遍历，进入时间不早于当前最早命中的子树直接跳过
+// ------------------------------------------------------------------
+bool FFPSStaticCollisionBVH::SweepSphere(const FVector& Start, const FVector& End, float Radius, ECollisionChannel Channel, FHitResult& OutHit,
+    const FCollisionQueryParams& QueryParams) const
+{
+    const uint32 ChannelBit = 1u << static_cast<uint32>(Channel);
+    float BestTime = 1.0f;
+    bool bHit = false;
+
+    if (Nodes.Num() > 0)
+    {
+        const FVector3f LocalStart(Start - Origin);
+        FPSStaticCollisionBVH::FRay Ray(LocalStart, FVector3f(End - Start), Radius);
+
+        struct FStackEntry
+        {
+            int32 NodeIndex;
+            float EntryTime;
+        };
+        FStackEntry Stack[FPSStaticCollisionBVH::MaxStackDepth];
+        int32 StackSize = 0;
+
+        float RootEntry = 0.0f;
+        if (Ray.Intersects(Nodes[0].Min, Nodes[0].Max, RootEntry))
+        {
+            Stack[StackSize++] = { 0, RootEntry };
+        }
+
+        while (StackSize > 0)
+        {
+            const FStackEntry Entry = Stack[--StackSize];
+            if (Entry.EntryTime >= BestTime)
+            {
+                continue;
+            }
+
+            const FNode& Node = Nodes[Entry.NodeIndex];
+            if (Node.Count > 0)
+            {
+                for (int32 Prim = Node.Offset; Prim < Node.Offset + Node.Count; ++Prim)
+                {
+                    float PrimEntry = 0.0f;
+                    if ((PrimBlockMask[Prim] & ChannelBit) == 0 || !Ray.Intersects(PrimMin[Prim], PrimMax[Prim], PrimEntry))
+                    {
+                        continue;
+                    }
+
+                    if (SweepComponent(PrimComponents[Prim].Get(), Start, End, Radius, QueryParams, BestTime, OutHit))
+                    {
+                        bHit = true;
+                        Ray.SetMaxTime(BestTime);
+                    }
+                }
+                continue;
+            }
+
+            const int32 LeftIndex = Entry.NodeIndex + 1;
+            const int32 RightIndex = Node.Offset;
+            float LeftEntry = 0.0f;
+            float RightEntry = 0.0f;
+            const bool bLeft = Ray.Intersects(Nodes[LeftIndex].Min, Nodes[LeftIndex].Max, LeftEntry);
+            const bool bRight = Ray.Intersects(Nodes[RightIndex].Min, Nodes[RightIndex].Max, RightEntry);
+
+            // 先压入较远的子节点，使较近的先出栈
+            if (bLeft && bRight)
+            {
+                check(StackSize + 2 <= FPSStaticCollisionBVH::MaxStackDepth);
+                if (LeftEntry <= RightEntry)
+                {
+                    Stack[StackSize++] = { RightIndex, RightEntry };
+                    Stack[StackSize++] = { LeftIndex, LeftEntry };
+                }
+                else
+                {
+                    Stack[StackSize++] = { LeftIndex, LeftEntry };
+                    Stack[StackSize++] = { RightIndex, RightEntry };
+                }
+            }
+            else if (bLeft || bRight)
+            {
+                check(StackSize < FPSStaticCollisionBVH::MaxStackDepth);
+                Stack[StackSize++] = bLeft ? FStackEntry{ LeftIndex, LeftEntry } : FStackEntry{ RightIndex, RightEntry };
+            }
+        }
+    }
+
+    // 可移动的 WorldStatic 组件数量很少，逐个检测
+    for (int32 Index = 0; Index < UncoveredComponents.Num(); ++Index)
+    {
+        if ((UncoveredBlockMask[Index] & ChannelBit) != 0
+            && SweepComponent(UncoveredComponents[Index].Get(), Start, End, Radius, QueryParams, BestTime, OutHit))
+        {
+            bHit = true;
+        }
+    }
+
+    return bHit;
+}
+
+bool FFPSStaticCollisionBVH::SweepComponent(UPrimitiveComponent* Component, const FVector& Start, const FVector& End, float Radius,
+    const FCollisionQueryParams& QueryParams, float& BestTime, FHitResult& OutHit)
+{
+    // 组件可能在运行时被销毁或关闭碰撞
+    if (!Component || !Component->IsQueryCollisionEnabled())
+    {
+        return false;
+    }
+
+    // 与场景查询相同：跳过调用方忽略的组件与 Actor（如子弹自身、射手）
+    if (QueryParams.GetIgnoredComponents().Contains(Component->GetUniqueID()))
+    {
+        return false;
+    }
+    const AActor* Owner = Component->GetOwner();
+    if (Owner && QueryParams.GetIgnoredActors().Contains(Owner->GetUniqueID()))
+    {
+        return false;
+    }
+
+    INC_DWORD_STAT(STAT_FPSStaticBVHNarrowphase);
+
+    FHitResult Hit;
+    if (!Component->SweepComponent(Hit, Start, End, FQuat::Identity, FCollisionShape::MakeSphere(Radius), false)
+        || Hit.Time >= BestTime)
+    {
+        return false;
+    }
+
+    BestTime = Hit.Time;
+    OutHit = Hit;
+    OutHit.bBlockingHit = true;
+    if (!OutHit.GetComponent())
+    {
+        OutHit.Component = Component;
+        OutHit.HitObjectHandle = FActorInstanceHandle(Component->GetOwner());
+    }
+    return true;
+}
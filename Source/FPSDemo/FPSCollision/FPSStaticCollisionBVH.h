@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+
+class UPrimitiveComponent;
+class UWorld;
+struct FCollisionQueryParams;
+struct FHitResult;
+
+/**
+ * FFPSStaticCollisionBVH
+ * 静态关卡碰撞的包围盒层次（BVH），加载关卡时构建一次。
+ * 叶子为对象类型 WorldStatic、可移动性为 Static 且开启查询碰撞的组件；节点以 32 字节扁平数组存放（前序排列，
+ * 左子节点紧跟父节点），图元包围盒按叶子顺序另存为连续数组，遍历时只访问连续内存。
+ * 坐标相对 BVH 中心以 float 存储。
+ *
+ * 球形扫掠：先用 SIMD 射线/包围盒（按半径外扩）测试由近到远遍历，只对候选组件调用 SweepComponent 做精确检测，
+ * 结果与场景查询一致。可移动的 WorldStatic 组件（如门）不进 BVH，单独逐个检测。
+ * 构建后只读，可在工作线程上并发查询；组件的注册、注销与碰撞设置变化由 UFPSStaticCollisionSubsystem 标记重建。
+ */
+class FPSDEMO_API FFPSStaticCollisionBVH
+{
+public:
+    /* 收集世界中所有可见关卡的静态碰撞并构建 */
+    void Build(const UWorld* World);
+
+    void Reset();
+
+    bool IsEmpty() const { return Nodes.Num() == 0 && UncoveredComponents.Num() == 0; }
+
+    /**
+     * 对静态碰撞做球形扫掠，返回最早的阻挡命中。
+     * @param Channel     扫掠使用的碰撞通道，只检测对其阻挡的组件
+     * @param QueryParams 跳过其中忽略的 Actor 与组件
+     */
+    bool SweepSphere(const FVector& Start, const FVector& End, float Radius, ECollisionChannel Channel, FHitResult& OutHit,
+        const FCollisionQueryParams& QueryParams) const;
+
+    /* 遍历 BVH 中的组件与单独检测的组件（已销毁的跳过） */
+    template <typename FuncType>
+    void ForEachComponent(FuncType&& Func) const
+    {
+        for (const TWeakObjectPtr<UPrimitiveComponent>& Component : PrimComponents)
+        {
+            if (UPrimitiveComponent* Resolved = Component.Get())
+            {
+                Func(Resolved);
+            }
+        }
+        for (const TWeakObjectPtr<UPrimitiveComponent>& Component : UncoveredComponents)
+        {
+            if (UPrimitiveComponent* Resolved = Component.Get())
+            {
+                Func(Resolved);
+            }
+        }
+    }
+
+    /* 世界空间包围盒（不含可移动的 WorldStatic 组件） */
+    const FBox& GetBounds() const { return Bounds; }
+
+    int32 GetNumPrimitives() const { return PrimComponents.Num(); }
+    int32 GetNumNodes() const { return Nodes.Num(); }
+    int32 GetNumUncovered() const { return UncoveredComponents.Num(); }
+    SIZE_T GetAllocatedSize() const;
+
+private:
+    /* 扁平节点：Count > 0 为叶子（图元区间 [Offset, Offset + Count)），否则左子节点为下一个节点、右子节点为 Offset */
+    struct FNode
+    {
+        FVector3f Min;
+        int32 Offset = 0;
+        FVector3f Max;
+        int32 Count = 0;
+    };
+    static_assert(sizeof(FNode) == 32, "FNode 应占半条缓存行");
+
+    /* 构建时的图元 */
+    struct FBuildPrimitive
+    {
+        FVector3f Min;
+        FVector3f Max;
+        FVector3f Centroid;
+        UPrimitiveComponent* Component = nullptr;
+        uint32 BlockMask = 0;
+    };
+
+    /* 递归构建 [Begin, End) 区间，返回节点下标 */
+    int32 BuildRecursive(TArray<FBuildPrimitive>& Primitives, int32 Begin, int32 End);
+
+    /* 对单个组件做精确扫掠，命中更早时更新 OutHit 与 BestTime */
+    static bool SweepComponent(UPrimitiveComponent* Component, const FVector& Start, const FVector& End, float Radius,
+        const FCollisionQueryParams& QueryParams, float& BestTime, FHitResult& OutHit);
+
+    /* 叶子最多包含的图元数 */
+    static constexpr int32 MaxLeafPrimitives = 4;
+
+    /* 节点坐标的原点（世界空间） */
+    FVector Origin = FVector::ZeroVector;
+
+    FBox Bounds = FBox(ForceInit);
+
+    TArray<FNode> Nodes;
+
+    /* 按叶子顺序排列的图元（SoA） */
+    TArray<FVector3f> PrimMin;
+    TArray<FVector3f> PrimMax;
+    TArray<uint32> PrimBlockMask;
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> PrimComponents;
+
+    /* 可移动的 WorldStatic 组件，逐个检测 */
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> UncoveredComponents;
+    TArray<uint32> UncoveredBlockMask;
+};
@@ -0,0 +1,310 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSCollision/FPSStaticCollisionSubsystem.h"
+#include "FPSDemo.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+static TAutoConsoleVariable<int32> CVarStaticBVH(
+    TEXT("fps.Projectile.StaticBVH"),
+    1,
+    TEXT("1：子弹扫掠先查询静态关卡碰撞的 BVH，场景查询只按对象类型检测动态物体；0：每次扫掠都查询完整场景。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Collision.BenchmarkSweeps [数量] [半径] [长度]
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorldAndArgs GBenchmarkSweepsCommand(
+    TEXT("fps.Collision.BenchmarkSweeps"),
+    TEXT("对比场景查询与静态 BVH 的子弹扫掠吞吐。参数：数量（默认 20000）、半径（默认 15）、长度（默认 50）。"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+    {
+        UFPSStaticCollisionSubsystem* StaticCollision = World ? World->GetSubsystem<UFPSStaticCollisionSubsystem>() : nullptr;
+        if (!StaticCollision)
+        {
+            return;
+        }
+
+        const int32 NumSweeps = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20000;
+        const float Radius = Args.Num() > 1 ? FCString::Atof(*Args[1]) : 15.0f;
+        const float Length = Args.Num() > 2 ? FCString::Atof(*Args[2]) : 50.0f;
+        StaticCollision->RunBenchmark(FMath::Max(NumSweeps, 1), FMath::Max(Radius, 0.0f), FMath::Max(Length, 1.0f));
+    }));
+
+bool UFPSStaticCollisionSubsystem::IsStaticBVHEnabled()
+{
+    return CVarStaticBVH.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSStaticCollisionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSStaticCollisionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UFPSStaticCollisionSubsystem::OnLevelChanged);
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UFPSStaticCollisionSubsystem::OnLevelChanged);
+    CreatePhysicsHandle = UActorComponent::GlobalCreatePhysicsDelegate.AddUObject(this, &UFPSStaticCollisionSubsystem::OnComponentPhysicsStateChanged);
+    DestroyPhysicsHandle = UActorComponent::GlobalDestroyPhysicsDelegate.AddUObject(this, &UFPSStaticCollisionSubsystem::OnComponentPhysicsStateChanged);
+
+    Rebuild();
+}
+
+void UFPSStaticCollisionSubsystem::Deinitialize()
+{
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+    UActorComponent::GlobalCreatePhysicsDelegate.Remove(CreatePhysicsHandle);
+    UActorComponent::GlobalDestroyPhysicsDelegate.Remove(DestroyPhysicsHandle);
+    UnbindComponents();
+    BVH.Reset();
+
+    Super::Deinitialize();
+}
+
+void UFPSStaticCollisionSubsystem::OnLevelChanged(ULevel* Level, UWorld* InWorld)
+{
+    if (InWorld == GetWorld())
+    {
+        bDirty = true;
+    }
+}
+
+// ------------------------------------------------------------------
+// 运行时的静态碰撞变化：只标记，在下一次 GetBVH 时重建
+// ------------------------------------------------------------------
+void UFPSStaticCollisionSubsystem::OnComponentPhysicsStateChanged(UActorComponent* Component)
+{
+    if (bDirty)
+    {
+        return;
+    }
+
+    const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+    if (Primitive && Primitive->GetCollisionObjectType() == ECC_WorldStatic && Primitive->GetWorld() == GetWorld())
+    {
+        bDirty = true;
+    }
+}
+
+void UFPSStaticCollisionSubsystem::OnComponentCollisionSettingsChanged(UPrimitiveComponent* Component)
+{
+    bDirty = true;
+}
+
+void UFPSStaticCollisionSubsystem::UnbindComponents()
+{
+    BVH.ForEachComponent([this](UPrimitiveComponent* Component)
+    {
+        Component->OnComponentCollisionSettingsChangedEvent.RemoveAll(this);
+    });
+}
+
+void UFPSStaticCollisionSubsystem::Rebuild()
+{
+    const double StartTime = FPlatformTime::Seconds();
+    UnbindComponents();
+    BVH.Build(GetWorld());
+    bDirty = false;
+
+    // 响应、对象类型或开关变化后块掩码与可移动性分组都会过期
+    BVH.ForEachComponent([this](UPrimitiveComponent* Component)
+    {
+        Component->OnComponentCollisionSettingsChangedEvent.AddUObject(this, &UFPSStaticCollisionSubsystem::OnComponentCollisionSettingsChanged);
+    });
+
+    UE_LOG(LogFPSDemo, Log, TEXT("StaticCollision: built BVH with %d primitives, %d nodes, %d uncovered, %.1f KB in %.2f ms"),
+        BVH.GetNumPrimitives(), BVH.GetNumNodes(), BVH.GetNumUncovered(),
+        BVH.GetAllocatedSize() / 1024.0, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+const FFPSStaticCollisionBVH* UFPSStaticCollisionSubsystem::GetBVH()
+{
+    check(IsInGameThread());
+
+    // 开始游戏前（如 BeginPlay 中发射的子弹）同样按需构建
+    if (bDirty)
+    {
+        Rebuild();
+    }
+
+    return BVH.IsEmpty() ? nullptr : &BVH;
+}
+
+// ------------------------------------------------------------------
+// 静态 BVH + 动态场景查询
+// ------------------------------------------------------------------
+bool UFPSStaticCollisionSubsystem::SweepSphere(
+    FHitResult& OutHit,
+    const FVector& Start,
+    const FVector& End,
+    float Radius,
+    ECollisionChannel Channel,
+    const FCollisionQueryParams& QueryParams,
+    const FCollisionResponseParams& ResponseParams) const
+{
+    FHitResult StaticHit;
+    const bool bStaticHit = BVH.SweepSphere(Start, End, Radius, Channel, StaticHit, QueryParams);
+
+    // 起点已与静态几何重叠，动态物体不可能更早
+    if (bStaticHit && StaticHit.Time <= 0.0f)
+    {
+        OutHit = StaticHit;
+        return true;
+    }
+
+    // 动态部分只查询本通道会被阻挡的非 WorldStatic 对象类型，静态几何不再进入场景查询
+    FCollisionObjectQueryParams DynamicObjectParams;
+    for (int32 ObjectType = 0; ObjectType < ECC_OverlapAll_Deprecated; ++ObjectType)
+    {
+        if (ObjectType != ECC_WorldStatic
+            && ResponseParams.CollisionResponse.GetResponse(static_cast<ECollisionChannel>(ObjectType)) == ECR_Block)
+        {
+            DynamicObjectParams.AddObjectTypesToQuery(static_cast<ECollisionChannel>(ObjectType));
+        }
+    }
+
+    bool bDynamicHit = false;
+    if (DynamicObjectParams.IsValid())
+    {
+        // 动态部分只扫到静态命中点为止
+        const float DynamicFraction = bStaticHit ? StaticHit.Time : 1.0f;
+        const FVector DynamicEnd = Start + (End - Start) * DynamicFraction;
+
+        // 对象类型查询不看被检测组件对本通道的响应（触发器等也会返回），
+        // 因此取全部命中，再只保留对本通道阻挡的最早一个；每个工作线程复用自己的数组
+        thread_local TArray<FHitResult> DynamicHits;
+        DynamicHits.Reset();
+        GetWorld()->SweepMultiByObjectType(DynamicHits, Start, DynamicEnd, FQuat::Identity, DynamicObjectParams,
+            FCollisionShape::MakeSphere(Radius), QueryParams);
+
+        for (const FHitResult& Hit : DynamicHits)
+        {
+            const UPrimitiveComponent* Component = Hit.GetComponent();
+            if (Component
+                && Component->GetCollisionResponseToChannel(Channel) == ECR_Block
+                && (!bDynamicHit || Hit.Time < OutHit.Time))
+            {
+                OutHit = Hit;
+                bDynamicHit = true;
+            }
+        }
+
+        if (bDynamicHit)
+        {
+            // 换算回完整扫掠的参数
+            OutHit.Time *= DynamicFraction;
+            OutHit.TraceEnd = End;
+            OutHit.bBlockingHit = true;
+            return true;
+        }
+    }
+
+    if (bStaticHit)
+    {
+        OutHit = StaticHit;
+        return true;
+    }
+
+    return false;
+}
+
+// ------------------------------------------------------------------
+// 基准测试：相同的随机扫掠分别走场景查询与 BVH 路径
+// ------------------------------------------------------------------
+void UFPSStaticCollisionSubsystem::RunBenchmark(int32 NumSweeps, float Radius, float Length)
+{
+    if (!GetBVH())
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("StaticCollision: no static collision to benchmark"));
+        return;
+    }
+
+    // 与子弹相同的碰撞设置
+    FCollisionResponseTemplate Profile;
+    if (!UCollisionProfile::Get()->GetProfileTemplate(TEXT("Projectile"), Profile))
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("StaticCollision: collision profile 'Projectile' not found"));
+        return;
+    }
+
+    const ECollisionChannel Channel = Profile.ObjectType;
+    const FCollisionResponseParams ResponseParams(Profile.ResponseToChannels);
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSProjectileSweep), false);
+    if (ResponseParams.CollisionResponse.GetResponse(ECC_WorldStatic) != ECR_Block)
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("StaticCollision: 'Projectile' does not block WorldStatic, BVH path is not used"));
+        return;
+    }
+
+    const FBox& Bounds = BVH.GetBounds();
+    FRandomStream Random(0x5EED);
+    TArray<FVector> Starts;
+    TArray<FVector> Ends;
+    Starts.Reserve(NumSweeps);
+    Ends.Reserve(NumSweeps);
+    for (int32 Index = 0; Index < NumSweeps; ++Index)
+    {
+        const FVector Start(
+            Random.FRandRange(Bounds.Min.X, Bounds.Max.X),
+            Random.FRandRange(Bounds.Min.Y, Bounds.Max.Y),
+            Random.FRandRange(Bounds.Min.Z, Bounds.Max.Z));
+        Starts.Add(Start);
+        Ends.Add(Start + Random.GetUnitVector() * Length);
+    }
+
+    const UWorld* World = GetWorld();
+    const FCollisionShape Shape = FCollisionShape::MakeSphere(Radius);
+    TArray<FHitResult> SceneHits;
+    TArray<FHitResult> BVHHits;
+    TArray<uint8> SceneBlocked;
+    TArray<uint8> BVHBlocked;
+    SceneHits.SetNum(NumSweeps);
+    BVHHits.SetNum(NumSweeps);
+    SceneBlocked.SetNumZeroed(NumSweeps);
+    BVHBlocked.SetNumZeroed(NumSweeps);
+
+    // 参照：完整场景查询，既用于吞吐对比，也是判断 BVH 路径结果是否一致的基准
+    const double SceneStart = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < NumSweeps; ++Index)
+    {
+        SceneBlocked[Index] = World->SweepSingleByChannel(SceneHits[Index], Starts[Index], Ends[Index], FQuat::Identity,
+            Channel, Shape, QueryParams, ResponseParams) ? 1 : 0;
+    }
+    const double SceneSeconds = FPlatformTime::Seconds() - SceneStart;
+
+    const double BVHStart = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < NumSweeps; ++Index)
+    {
+        BVHBlocked[Index] = SweepSphere(BVHHits[Index], Starts[Index], Ends[Index], Radius, Channel, QueryParams, ResponseParams) ? 1 : 0;
+    }
+    const double BVHSeconds = FPlatformTime::Seconds() - BVHStart;
+
+    // 命中与否不同，或命中点相差超过 1cm，视为不一致
+    int32 NumHits = 0;
+    int32 NumMismatches = 0;
+    for (int32 Index = 0; Index < NumSweeps; ++Index)
+    {
+        NumHits += SceneBlocked[Index] ? 1 : 0;
+        if (SceneBlocked[Index] != BVHBlocked[Index]
+            || (SceneBlocked[Index] && FVector::DistSquared(SceneHits[Index].Location, BVHHits[Index].Location) > 1.0))
+        {
+            ++NumMismatches;
+        }
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("StaticCollision: %d sweeps (radius %.1f, length %.1f), hits %d"), NumSweeps, Radius, Length, NumHits);
+    UE_LOG(LogFPSDemo, Log, TEXT("  Scene query: %8.2f ms  %10.0f sweeps/s"), SceneSeconds * 1000.0, NumSweeps / FMath::Max(SceneSeconds, UE_DOUBLE_SMALL_NUMBER));
+    UE_LOG(LogFPSDemo, Log, TEXT("  Static BVH : %8.2f ms  %10.0f sweeps/s  (x%.2f)"), BVHSeconds * 1000.0, NumSweeps / FMath::Max(BVHSeconds, UE_DOUBLE_SMALL_NUMBER),
+        SceneSeconds / FMath::Max(BVHSeconds, UE_DOUBLE_SMALL_NUMBER));
+    UE_LOG(LogFPSDemo, Log, TEXT("  Mismatches : %d"), NumMismatches);
+}
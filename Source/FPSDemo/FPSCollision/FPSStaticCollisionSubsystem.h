@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSCollision/FPSStaticCollisionBVH.h"
+#include "FPSStaticCollisionSubsystem.generated.h"
+
+class UActorComponent;
+class ULevel;
+class UPrimitiveComponent;
+struct FCollisionQueryParams;
+struct FCollisionResponseParams;
+
+/**
+ * UFPSStaticCollisionSubsystem
+ * 持有静态关卡碰撞的 BVH（FFPSStaticCollisionBVH），开始游戏时构建，以下情况在下一次使用前重建：
+ *   流式关卡加载/卸载；运行时创建或销毁 WorldStatic 组件的物理状态（生成、注册、注销）；
+ *   BVH 中组件的碰撞设置（响应、对象类型、开关）变化。
+ * 运行时由其他对象类型改为 WorldStatic 的组件不会被发现，这类物体应直接使用 WorldStatic 生成。
+ *
+ * 子弹扫掠（UProjectileBallisticsSubsystem）先查询 BVH 得到最早的静态命中，
+ * 再按对象类型查询场景中的动态物体（不含 WorldStatic），且只扫到静态命中点为止。
+ *
+ * 控制台：fps.Projectile.StaticBVH、fps.Collision.BenchmarkSweeps [数量] [半径] [长度]
+ */
+UCLASS()
+class FPSDEMO_API UFPSStaticCollisionSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* 子弹扫掠是否使用静态 BVH（fps.Projectile.StaticBVH） */
+    static bool IsStaticBVHEnabled();
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    /* 在游戏线程上调用：需要时重建，BVH 为空时返回 nullptr */
+    const FFPSStaticCollisionBVH* GetBVH();
+
+    /**
+     * 球形扫掠：静态部分查询 BVH，动态部分查询场景，返回两者中最早的阻挡命中，结果与单次场景查询一致。
+     * 调用方需先确认 ResponseParams 对 WorldStatic 为 Block，且已在游戏线程上调用过 GetBVH。可在工作线程并发调用。
+     */
+    bool SweepSphere(
+        FHitResult& OutHit,
+        const FVector& Start,
+        const FVector& End,
+        float Radius,
+        ECollisionChannel Channel,
+        const FCollisionQueryParams& QueryParams,
+        const FCollisionResponseParams& ResponseParams) const;
+
+    /**
+     * 对比场景查询与 BVH 路径的扫掠吞吐（单线程），并统计两者结果不一致的次数。
+     * @param NumSweeps 随机扫掠数量，起点均匀分布在 BVH 包围盒内
+     * @param Radius    扫掠球半径
+     * @param Length    每次扫掠的长度（默认约为 3000 cm/s 的子弹一帧的位移）
+     */
+    void RunBenchmark(int32 NumSweeps, float Radius, float Length);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    void OnLevelChanged(ULevel* Level, UWorld* InWorld);
+
+    /* 任意组件创建/销毁物理状态时调用，本世界的 WorldStatic 组件标记重建 */
+    void OnComponentPhysicsStateChanged(UActorComponent* Component);
+
+    /* BVH 中组件的碰撞设置变化 */
+    void OnComponentCollisionSettingsChanged(UPrimitiveComponent* Component);
+
+    /* 解除对 BVH 中组件碰撞设置的监听 */
+    void UnbindComponents();
+
+    void Rebuild();
+
+    FFPSStaticCollisionBVH BVH;
+
+    bool bDirty = true;
+
+    FDelegateHandle LevelAddedHandle;
+    FDelegateHandle LevelRemovedHandle;
+    FDelegateHandle CreatePhysicsHandle;
+    FDelegateHandle DestroyPhysicsHandle;
+};
@@ -1,6 +1,19 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "FPSDemo.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
 #include "Modules/ModuleManager.h"
 
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, FPSDemo, "FPSDemo" );
+DEFINE_LOG_CATEGORY(LogFPSDemo);
+
+class FFPSDemoModule : public FDefaultGameModuleImpl
+{
+public:
+    virtual void StartupModule() override
+    {
+        // 射击分配计数需要在游戏开始前替换 GMalloc
+        FPSAllocationTracker::InstallIfRequested();
+    }
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FFPSDemoModule, FPSDemo, "FPSDemo" );
@@ -4,3 +4,5 @@
 
 #include "CoreMinimal.h"
 
+// 模块通用日志分类
+FPSDEMO_API DECLARE_LOG_CATEGORY_EXTERN(LogFPSDemo, Log, All);
@@ -0,0 +1,9 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "FPSDemoMemory.h"
+
+LLM_DEFINE_TAG(FPSDemo);
+LLM_DEFINE_TAG(FPSDemo_Character, TEXT("Character"), TEXT("FPSDemo"));
+LLM_DEFINE_TAG(FPSDemo_Projectile, TEXT("Projectile"), TEXT("FPSDemo"));
+LLM_DEFINE_TAG(FPSDemo_HUD, TEXT("HUD"), TEXT("FPSDemo"));
+LLM_DEFINE_TAG(FPSDemo_Input, TEXT("Input"), TEXT("FPSDemo"));
@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// 模块的 LLM（Low Level Memory Tracker）标签：命令行 -llm 启动后，stat LLMFULL 与 Unreal Insights 的 Memory Insights 中
+// 按 FPSDemo/Character、FPSDemo/Projectile、FPSDemo/HUD、FPSDemo/Input 分类统计内存（含 UObject、组件、物理与渲染状态的分配）。
+// 用法：在分配发生的作用域内 LLM_SCOPE_BYTAG(FPSDemo_Projectile)；内层作用域覆盖外层。LLM 关闭时宏为空。
+LLM_DECLARE_TAG_API(FPSDemo, FPSDEMO_API);
+LLM_DECLARE_TAG_API(FPSDemo_Character, FPSDEMO_API);
+LLM_DECLARE_TAG_API(FPSDemo_Projectile, FPSDEMO_API);
+LLM_DECLARE_TAG_API(FPSDemo_HUD, FPSDEMO_API);
+LLM_DECLARE_TAG_API(FPSDemo_Input, FPSDEMO_API);
@@ -0,0 +1,51 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "FPSDemoStats.h"
+
+DEFINE_STAT(STAT_FPSCharacterShoot);
+DEFINE_STAT(STAT_FPSCharacterFireShots);
+DEFINE_STAT(STAT_FPSCharacterMove);
+DEFINE_STAT(STAT_FPSCharacterLook);
+DEFINE_STAT(STAT_FPSProjectileSpawn);
+DEFINE_STAT(STAT_FPSProjectileShootInDirection);
+DEFINE_STAT(STAT_FPSProjectileOnHit);
+DEFINE_STAT(STAT_FPSBallisticsTick);
+DEFINE_STAT(STAT_FPSHitscanResolve);
+DEFINE_STAT(STAT_FPSHUDDraw);
+DEFINE_STAT(STAT_FPSLagCompRecord);
+DEFINE_STAT(STAT_FPSLagCompQuery);
+DEFINE_STAT(STAT_FPSServerReplicateActors);
+DEFINE_STAT(STAT_FPSBotThink);
+DEFINE_STAT(STAT_FPSBotSteer);
+DEFINE_STAT(STAT_FPSHitEventDrain);
+DEFINE_STAT(STAT_FPSAnimBudget);
+DEFINE_STAT(STAT_FPSStaticBVHBuild);
+DEFINE_STAT(STAT_FPSProjectileVisualUpdate);
+DEFINE_STAT(STAT_FPSProjectileVisibility);
+DEFINE_STAT(STAT_FPSSignificance);
+
+DEFINE_STAT(STAT_FPSShotsFired);
+DEFINE_STAT(STAT_FPSHits);
+DEFINE_STAT(STAT_FPSImpulsesApplied);
+DEFINE_STAT(STAT_FPSImpulseBodies);
+DEFINE_STAT(STAT_FPSLagCompHits);
+DEFINE_STAT(STAT_FPSHUDDrawItems);
+DEFINE_STAT(STAT_FPSHUDBatches);
+DEFINE_STAT(STAT_FPSHUDDirtyElements);
+DEFINE_STAT(STAT_FPSBotThinks);
+DEFINE_STAT(STAT_FPSBotPathQueries);
+DEFINE_STAT(STAT_FPSHitEventsDrained);
+DEFINE_STAT(STAT_FPSHitEventQueueDepth);
+DEFINE_STAT(STAT_FPSTelemetryRecords);
+DEFINE_STAT(STAT_FPSAnimEvaluations);
+DEFINE_STAT(STAT_FPSAnimCharacters);
+DEFINE_STAT(STAT_FPSStaticBVHNarrowphase);
+DEFINE_STAT(STAT_FPSProjectileRenderStateChanges);
+DEFINE_STAT(STAT_FPSProjectileVisualInstances);
+DEFINE_STAT(STAT_FPSSignificanceTicks);
+DEFINE_STAT(STAT_FPSSignificanceSkippedTicks);
+
+DEFINE_STAT(STAT_FPSLiveProjectiles);
+DEFINE_STAT(STAT_FPSReplicationConnections);
+DEFINE_STAT(STAT_FPSBots);
+DEFINE_STAT(STAT_FPSTelemetryDropped);
@@ -0,0 +1,69 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+// 模块统计分组：控制台输入 stat FPSDemo 查看
+DECLARE_STATS_GROUP(TEXT("FPSDemo"), STATGROUP_FPSDemo, STATCAT_Advanced);
+
+// 游戏逻辑热点的 CPU 耗时
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Shoot"), STAT_FPSCharacterShoot, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character FireShots"), STAT_FPSCharacterFireShots, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Move"), STAT_FPSCharacterMove, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Look"), STAT_FPSCharacterLook, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Spawn"), STAT_FPSProjectileSpawn, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile ShootInDirection"), STAT_FPSProjectileShootInDirection, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile OnHit"), STAT_FPSProjectileOnHit, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ballistics Tick"), STAT_FPSBallisticsTick, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Hitscan Resolve"), STAT_FPSHitscanResolve, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HUD DrawHUD"), STAT_FPSHUDDraw, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LagComp Record"), STAT_FPSLagCompRecord, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LagComp Query"), STAT_FPSLagCompQuery, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Server ReplicateActors"), STAT_FPSServerReplicateActors, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bot Think"), STAT_FPSBotThink, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Bot Steer"), STAT_FPSBotSteer, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("HitEvent Drain"), STAT_FPSHitEventDrain, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Anim Budget"), STAT_FPSAnimBudget, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Static BVH Build"), STAT_FPSStaticBVHBuild, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Visual Update"), STAT_FPSProjectileVisualUpdate, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Projectile Visibility Toggle"), STAT_FPSProjectileVisibility, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"), STAT_FPSSignificance, STATGROUP_FPSDemo, FPSDEMO_API);
+
+// 每帧计数（每帧自动清零）
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shots Fired"), STAT_FPSShotsFired, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Hits"), STAT_FPSHits, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impulses Applied"), STAT_FPSImpulsesApplied, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Impulse Bodies"), STAT_FPSImpulseBodies, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("LagComp Hits"), STAT_FPSLagCompHits, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HUD Draw Items"), STAT_FPSHUDDrawItems, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HUD Batches"), STAT_FPSHUDBatches, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HUD Dirty Elements"), STAT_FPSHUDDirtyElements, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bot Thinks"), STAT_FPSBotThinks, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Bot Path Queries"), STAT_FPSBotPathQueries, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HitEvents Drained"), STAT_FPSHitEventsDrained, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("HitEvent Queue Depth"), STAT_FPSHitEventQueueDepth, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Telemetry Records"), STAT_FPSTelemetryRecords, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Anim Evaluations"), STAT_FPSAnimEvaluations, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Anim Characters"), STAT_FPSAnimCharacters, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Static BVH Narrowphase"), STAT_FPSStaticBVHNarrowphase, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile Render State Changes"), STAT_FPSProjectileRenderStateChanges, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Projectile Visual Instances"), STAT_FPSProjectileVisualInstances, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Ticks"), STAT_FPSSignificanceTicks, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Significance Skipped Ticks"), STAT_FPSSignificanceSkippedTicks, STATGROUP_FPSDemo, FPSDEMO_API);
+
+// 持续计数
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Live Projectiles"), STAT_FPSLiveProjectiles, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Replication Connections"), STAT_FPSReplicationConnections, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Bots"), STAT_FPSBots, STATGROUP_FPSDemo, FPSDEMO_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Telemetry Dropped"), STAT_FPSTelemetryDropped, STATGROUP_FPSDemo, FPSDEMO_API);
+
+/**
+ * 同时记录 stat 周期计数与 Unreal Insights CPU 事件。
+ * 两者在 Shipping 版本中都会被编译为空。
+ */
+#define FPS_SCOPE_CYCLE_COUNTER(Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
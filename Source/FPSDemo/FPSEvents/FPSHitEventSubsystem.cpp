@@ -0,0 +1,261 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Engine/DamageEvents.h"
+#include "Engine/World.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/DamageType.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.HitEvents.Stats
+// 输出命中事件管线的累计事件数、队列深度峰值与排出耗时
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GHitEventStatsCommand(
+    TEXT("fps.HitEvents.Stats"),
+    TEXT("输出命中事件管线统计（各类型事件数、队列深度峰值、每帧排出耗时）。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSHitEventSubsystem* HitEvents = World ? World->GetSubsystem<UFPSHitEventSubsystem>() : nullptr)
+        {
+            HitEvents->LogStats();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSHitEventSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+// ------------------------------------------------------------------
+// 开始游戏：在世界每帧的末尾排出队列。
+// 不使用可 Tick 子系统：其与即时命中等子系统之间的顺序不确定，会让部分事件晚一帧处理
+// ------------------------------------------------------------------
+void UFPSHitEventSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UFPSHitEventSubsystem::OnWorldPostActorTick);
+}
+
+void UFPSHitEventSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    LogStats();
+
+    // 丢弃未排出的事件；队列本身由共享指针管理，物理线程可能仍持有
+    Batch.Reset();
+    Queue->Drain(Batch);
+    Batch.Reset();
+
+    for (FOnFPSHitEventBatch& Delegate : PhaseDelegates)
+    {
+        Delegate.Clear();
+    }
+
+    Super::Deinitialize();
+}
+
+void UFPSHitEventSubsystem::Push(const UWorld* World, FFPSHitEvent&& Event)
+{
+    check(IsInGameThread());
+
+    if (UFPSHitEventSubsystem* HitEvents = World ? World->GetSubsystem<UFPSHitEventSubsystem>() : nullptr)
+    {
+        Event.Time = World->GetTimeSeconds();
+        HitEvents->Queue->Push(MoveTemp(Event));
+    }
+}
+
+// ------------------------------------------------------------------
+// 每帧末：排出 -> Damage -> Score -> FX -> Analytics
+// ------------------------------------------------------------------
+void UFPSHitEventSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld != GetWorld())
+    {
+        return;
+    }
+
+    const int32 QueueDepth = Queue->GetDepth();
+    SET_DWORD_STAT(STAT_FPSHitEventQueueDepth, QueueDepth);
+
+    if (QueueDepth == 0)
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSHitEventDrain);
+    const double StartTime = FPlatformTime::Seconds();
+
+    Batch.Reset();
+    Batch.Time = InWorld->GetTimeSeconds();
+    Batch.FrameNumber = GFrameCounter;
+    Batch.bAuthority = InWorld->GetNetMode() != NM_Client;
+
+    const int32 NumDrained = Queue->Drain(Batch);
+    INC_DWORD_STAT_BY(STAT_FPSHitEventsDrained, NumDrained);
+
+    // 物理线程产生的事件没有世界时间
+    for (FFPSHitEvent& Event : Batch.GetEvents(EFPSHitEventKind::PhysicsImpulse))
+    {
+        if (Event.Time == 0.0)
+        {
+            Event.Time = Batch.Time;
+        }
+    }
+
+    ApplyDamage(Batch);
+    PhaseDelegates[static_cast<int32>(EFPSHitEventPhase::Damage)].Broadcast(Batch);
+
+    ApplyScore(Batch);
+    PhaseDelegates[static_cast<int32>(EFPSHitEventPhase::Score)].Broadcast(Batch);
+
+    PhaseDelegates[static_cast<int32>(EFPSHitEventPhase::FX)].Broadcast(Batch);
+
+    RecordAnalytics(Batch);
+    PhaseDelegates[static_cast<int32>(EFPSHitEventPhase::Analytics)].Broadcast(Batch);
+
+    const double DrainMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    Stats.PeakQueueDepth = FMath::Max(Stats.PeakQueueDepth, QueueDepth);
+    ++Stats.DrainFrames;
+    Stats.TotalDrainMs += DrainMs;
+    Stats.PeakDrainMs = FMath::Max(Stats.PeakDrainMs, DrainMs);
+}
+
+// ------------------------------------------------------------------
+// Damage：同一批次内同一开火者对同一目标的多次命中合并为一次 TakeDamage
+// ------------------------------------------------------------------
+void UFPSHitEventSubsystem::ApplyDamage(const FFPSHitEventBatch& InBatch)
+{
+    if (!InBatch.bAuthority)
+    {
+        return;
+    }
+
+    PendingDamage.Reset();
+    PendingDamageIndices.Reset();
+
+    for (const EFPSHitEventKind Kind : { EFPSHitEventKind::CharacterHit, EFPSHitEventKind::WorldHit })
+    {
+        for (const FFPSHitEvent& Event : InBatch.GetEvents(Kind))
+        {
+            AActor* Victim = Event.HitActor.Get();
+            if (Event.bCosmetic || Event.Damage <= 0.0f || !Victim)
+            {
+                continue;
+            }
+
+            AActor* Instigator = Event.Instigator.Get();
+            int32& Index = PendingDamageIndices.FindOrAdd(TPair<AActor*, AActor*>(Victim, Instigator), INDEX_NONE);
+            if (Index == INDEX_NONE)
+            {
+                Index = PendingDamage.AddDefaulted();
+                PendingDamage[Index].Victim = Victim;
+                PendingDamage[Index].Instigator = Instigator;
+            }
+
+            FPendingDamage& Pending = PendingDamage[Index];
+            Pending.Damage += Event.Damage;
+            Pending.LastHit = &Event;
+        }
+    }
+
+    for (const FPendingDamage& Pending : PendingDamage)
+    {
+        // 前面的伤害可能已经销毁了目标或开火者
+        if (!IsValid(Pending.Victim))
+        {
+            continue;
+        }
+
+        const FFPSHitEvent& Hit = *Pending.LastHit;
+
+        FHitResult HitInfo;
+        HitInfo.bBlockingHit = true;
+        HitInfo.Location = Hit.Location;
+        HitInfo.ImpactPoint = Hit.Location;
+        HitInfo.ImpactNormal = -Hit.Direction;
+        HitInfo.BoneName = Hit.BoneName;
+        HitInfo.Component = Hit.HitComponent;
+        HitInfo.HitObjectHandle = FActorInstanceHandle(Pending.Victim);
+
+        AActor* Instigator = IsValid(Pending.Instigator) ? Pending.Instigator : nullptr;
+        const APawn* InstigatorPawn = Cast<APawn>(Instigator);
+
+        const FPointDamageEvent DamageEvent(Pending.Damage, HitInfo, Hit.Direction, UDamageType::StaticClass());
+        Pending.Victim->TakeDamage(Pending.Damage, DamageEvent, InstigatorPawn ? InstigatorPawn->GetController() : nullptr, Instigator);
+    }
+
+    Stats.DamageApplications += PendingDamage.Num();
+    PendingDamage.Reset();
+    PendingDamageIndices.Reset();
+}
+
+// ------------------------------------------------------------------
+// Score：命中其他角色一次得一分，按开火者合并后写入 PlayerState
+// ------------------------------------------------------------------
+void UFPSHitEventSubsystem::ApplyScore(const FFPSHitEventBatch& InBatch)
+{
+    if (!InBatch.bAuthority)
+    {
+        return;
+    }
+
+    const TArray<FFPSHitEvent>& CharacterHits = InBatch.GetEvents(EFPSHitEventKind::CharacterHit);
+    if (CharacterHits.Num() == 0)
+    {
+        return;
+    }
+
+    TMap<APlayerState*, int32, TInlineSetAllocator<8>> ScoreDeltas;
+    for (const FFPSHitEvent& Event : CharacterHits)
+    {
+        const APawn* Shooter = Cast<APawn>(Event.Instigator.Get());
+        if (Event.bCosmetic || !Shooter || Shooter == Event.HitActor.Get())
+        {
+            continue;
+        }
+
+        // AI 机器人不创建 PlayerState，不计分
+        if (APlayerState* PlayerState = Shooter->GetPlayerState())
+        {
+            ++ScoreDeltas.FindOrAdd(PlayerState, 0);
+        }
+    }
+
+    for (const TPair<APlayerState*, int32>& Pair : ScoreDeltas)
+    {
+        Pair.Key->SetScore(Pair.Key->GetScore() + Pair.Value);
+    }
+}
+
+// ------------------------------------------------------------------
+// Analytics：累计各类型事件数
+// ------------------------------------------------------------------
+void UFPSHitEventSubsystem::RecordAnalytics(const FFPSHitEventBatch& InBatch)
+{
+    for (int32 KindIndex = 0; KindIndex < static_cast<int32>(EFPSHitEventKind::Num); ++KindIndex)
+    {
+        Stats.TotalEvents[KindIndex] += InBatch.GetEvents(static_cast<EFPSHitEventKind>(KindIndex)).Num();
+    }
+}
+
+void UFPSHitEventSubsystem::LogStats() const
+{
+    const double AverageDrainMs = Stats.DrainFrames > 0 ? Stats.TotalDrainMs / Stats.DrainFrames : 0.0;
+
+    UE_LOG(LogFPSDemo, Log, TEXT("HitEvents: CharacterHits=%llu WorldHits=%llu PhysicsImpulses=%llu DamageApplications=%llu PeakQueueDepth=%d DrainFrames=%llu AvgDrain=%.3fms PeakDrain=%.3fms"),
+        Stats.TotalEvents[static_cast<int32>(EFPSHitEventKind::CharacterHit)],
+        Stats.TotalEvents[static_cast<int32>(EFPSHitEventKind::WorldHit)],
+        Stats.TotalEvents[static_cast<int32>(EFPSHitEventKind::PhysicsImpulse)],
+        Stats.DamageApplications, Stats.PeakQueueDepth, Stats.DrainFrames, AverageDrainMs, Stats.PeakDrainMs);
+}
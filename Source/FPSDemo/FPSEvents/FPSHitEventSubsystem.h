@@ -0,0 +1,105 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "FPSEvents/FPSHitEvents.h"
+#include "FPSHitEventSubsystem.generated.h"
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnFPSHitEventBatch, const FFPSHitEventBatch&);
+
+/* 命中事件管线的运行统计 */
+struct FFPSHitEventStats
+{
+    /* 各类型累计排出的事件数 */
+    uint64 TotalEvents[static_cast<int32>(EFPSHitEventKind::Num)] = {};
+
+    /* 累计结算的伤害调用次数（按 受害者 × 开火者 合并后） */
+    uint64 DamageApplications = 0;
+
+    /* 排出时队列深度的峰值 */
+    int32 PeakQueueDepth = 0;
+
+    /* 排出 + 全部消费者的耗时 */
+    uint64 DrainFrames = 0;
+    double TotalDrainMs = 0.0;
+    double PeakDrainMs = 0.0;
+};
+
+/**
+ * UFPSHitEventSubsystem
+ * 命中事件总线：子弹 OnHit、即时命中结果与物理线程的冲量回调把事件推入无锁的多生产者队列，
+ * 游戏线程每帧只排出一次（在所有 Actor 与可 Tick 对象更新之后），按类型整理为批次，
+ * 再依次交给 Damage、Score、FX、Analytics 各阶段的消费者整批处理。
+ *
+ * 内置消费者：
+ *   Damage    —— 仅权威端：按（受害者、开火者）合并后每对只调用一次 TakeDamage
+ *   Score     —— 仅权威端：按开火者累加命中角色次数到 PlayerState 的分数
+ *   Analytics —— 累计各类型事件数，输出到 stat FPSDemo 与 fps.HitEvents.Stats
+ * 外部消费者通过 OnBatch(Phase) 注册，在同阶段内置消费者之后调用。
+ */
+UCLASS()
+class FPSDEMO_API UFPSHitEventSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * 推入一次命中事件（仅游戏线程；其他线程请持有 GetQueue() 的队列直接 Push）。
+     * 世界没有本子系统时忽略。
+     */
+    static void Push(const UWorld* World, FFPSHitEvent&& Event);
+
+    /* 事件队列，可跨线程持有 */
+    const TSharedRef<FFPSHitEventQueue, ESPMode::ThreadSafe>& GetQueue() const { return Queue; }
+
+    /* 指定阶段的批次回调 */
+    FOnFPSHitEventBatch& OnBatch(EFPSHitEventPhase Phase) { return PhaseDelegates[static_cast<int32>(Phase)]; }
+
+    const FFPSHitEventStats& GetStats() const { return Stats; }
+    void LogStats() const;
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 每帧末：排出队列并依次执行各阶段 */
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+    /* 内置消费者 */
+    void ApplyDamage(const FFPSHitEventBatch& InBatch);
+    void ApplyScore(const FFPSHitEventBatch& InBatch);
+    void RecordAnalytics(const FFPSHitEventBatch& InBatch);
+
+    /* 一对（受害者、开火者）在本批次中合并后的伤害 */
+    struct FPendingDamage
+    {
+        AActor* Victim = nullptr;
+        AActor* Instigator = nullptr;
+
+        /* 最后一次命中，提供伤害事件的命中点与方向 */
+        const FFPSHitEvent* LastHit = nullptr;
+
+        float Damage = 0.0f;
+    };
+
+    /* 伤害合并的复用缓存 */
+    TArray<FPendingDamage> PendingDamage;
+    TMap<TPair<AActor*, AActor*>, int32> PendingDamageIndices;
+
+    TSharedRef<FFPSHitEventQueue, ESPMode::ThreadSafe> Queue = MakeShared<FFPSHitEventQueue, ESPMode::ThreadSafe>();
+
+    /* 每帧复用的批次 */
+    FFPSHitEventBatch Batch;
+
+    FOnFPSHitEventBatch PhaseDelegates[static_cast<int32>(EFPSHitEventPhase::Num)];
+
+    FDelegateHandle PostActorTickHandle;
+
+    FFPSHitEventStats Stats;
+};
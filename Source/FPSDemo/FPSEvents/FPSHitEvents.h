@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/MpscQueue.h"
+#include "Containers/StaticArray.h"
+#include <atomic>
+
+class AActor;
+class UPrimitiveComponent;
+
+/* 命中事件类型，每种类型在批次中有独立的数组 */
+enum class EFPSHitEventKind : uint8
+{
+    CharacterHit,   // 击中角色（Pawn）
+    WorldHit,       // 击中其他物体
+    PhysicsImpulse, // 物理线程已对刚体施加冲量
+    Num
+};
+
+/* 事件来源 */
+enum class EFPSHitEventSource : uint8
+{
+    Projectile,
+    Hitscan,
+    Physics,
+};
+
+/* 消费阶段，每帧按此顺序处理同一个批次 */
+enum class EFPSHitEventPhase : uint8
+{
+    Damage,
+    Score,
+    FX,
+    Analytics,
+    Num
+};
+
+/**
+ * 一次命中事件。
+ * 对象以弱引用保存：生产者可能在任意线程入队，被命中的对象也可能在排出之前被销毁，
+ * 只能在游戏线程上解引用。
+ */
+struct FFPSHitEvent
+{
+    EFPSHitEventKind Kind = EFPSHitEventKind::WorldHit;
+    EFPSHitEventSource Source = EFPSHitEventSource::Projectile;
+
+    /* 纯表现子弹产生的命中：只用于表现，不结算伤害与得分 */
+    bool bCosmetic = false;
+
+    /* 开火者（Pawn） */
+    TWeakObjectPtr<AActor> Instigator;
+
+    TWeakObjectPtr<AActor> HitActor;
+    TWeakObjectPtr<UPrimitiveComponent> HitComponent;
+    FName BoneName;
+
+    /* 命中点；物理冲量事件为刚体位置 */
+    FVector Location = FVector::ZeroVector;
+
+    /* 归一化的命中方向 */
+    FVector Direction = FVector::ZeroVector;
+
+    /* 命中速度（cm/s）；物理冲量事件为冲量大小 */
+    float Magnitude = 0.0f;
+
+    float Damage = 0.0f;
+
+    /* 入队时的世界时间；物理线程产生的事件为 0，排出时补上 */
+    double Time = 0.0;
+};
+
+/**
+ * 一帧排出的全部事件，按类型分组。
+ * 消费者按类型遍历连续数组，而不是逐个事件回调。
+ */
+struct FFPSHitEventBatch
+{
+    /* 排出时的世界时间与帧号 */
+    double Time = 0.0;
+    uint64 FrameNumber = 0;
+
+    /* 当前世界是否为权威端（服务器或单机） */
+    bool bAuthority = false;
+
+    TArray<FFPSHitEvent>& GetEvents(EFPSHitEventKind Kind) { return Events[static_cast<int32>(Kind)]; }
+    const TArray<FFPSHitEvent>& GetEvents(EFPSHitEventKind Kind) const { return Events[static_cast<int32>(Kind)]; }
+
+    int32 Num() const
+    {
+        int32 Total = 0;
+        for (const TArray<FFPSHitEvent>& KindEvents : Events)
+        {
+            Total += KindEvents.Num();
+        }
+        return Total;
+    }
+
+    bool IsEmpty() const { return Num() == 0; }
+
+    /* 清空但保留容量，批次每帧复用 */
+    void Reset()
+    {
+        for (TArray<FFPSHitEvent>& KindEvents : Events)
+        {
+            KindEvents.Reset();
+        }
+    }
+
+private:
+    TStaticArray<TArray<FFPSHitEvent>, static_cast<int32>(EFPSHitEventKind::Num)> Events;
+};
+
+/**
+ * FFPSHitEventQueue
+ * 多生产者、单消费者的无锁命中事件队列。
+ * 任意线程可 Push（游戏线程的子弹/即时命中、物理线程的模拟回调），只有游戏线程 Drain。
+ * 以线程安全的共享指针持有，物理线程一侧即使晚于子系统释放也不会访问悬空内存。
+ */
+class FFPSHitEventQueue
+{
+public:
+    void Push(FFPSHitEvent&& Event)
+    {
+        Queue.Enqueue(MoveTemp(Event));
+        Depth.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * 取出当前所有事件并按类型追加到批次中（仅消费者线程调用）。
+     * @return 取出的事件数量
+     */
+    int32 Drain(FFPSHitEventBatch& OutBatch)
+    {
+        int32 NumDrained = 0;
+        FFPSHitEvent Event;
+        while (Queue.Dequeue(Event))
+        {
+            OutBatch.GetEvents(Event.Kind).Add(MoveTemp(Event));
+            ++NumDrained;
+        }
+        Depth.fetch_sub(NumDrained, std::memory_order_relaxed);
+        return NumDrained;
+    }
+
+    /* 当前排队的事件数量（近似值，仅用于统计） */
+    int32 GetDepth() const { return Depth.load(std::memory_order_relaxed); }
+
+private:
+    TMpscQueue<FFPSHitEvent> Queue;
+    std::atomic<int32> Depth{ 0 };
+};
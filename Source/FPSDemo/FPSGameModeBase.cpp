@@ -7,6 +7,12 @@ void AFPSGameModeBase::StartPlay()
 {
 	Super::StartPlay();
 
+	// 专用服务器上没有屏幕
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		return;
+	}
+
 	check(GEngine != nullptr);
 
 	GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Yellow, TEXT("Welcome to FPSDemo , this message come FPSGameMode"));
@@ -2,35 +2,272 @@
 
 #include "FPSHUD/FPSHUD.h"
 #include "Engine/Canvas.h"
+#include "Engine/Texture.h"
+#include "BatchedElements.h"
+#include "CanvasTypes.h"
+#include "GameFramework/Pawn.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+
+// ----------------------------------------------------------
+// BeginPlay
+// 注册准星元素：以贴图中心对齐屏幕中心，半透明混合以支持带透明通道的准星贴图。
+// ----------------------------------------------------------
+void AFPSHUD::BeginPlay()
+{
+    LLM_SCOPE_BYTAG(FPSDemo_HUD);
+
+    Super::BeginPlay();
+
+    if (CrosshairTexture)
+    {
+        FFPSHUDElement Crosshair;
+        Crosshair.Texture = CrosshairTexture;
+        Crosshair.Anchor = FVector2D(0.5, 0.5);
+        Crosshair.Alignment = FVector2D(0.5, 0.5);
+        Crosshair.BlendMode = SE_BLEND_Translucent;
+        CrosshairHandle = AddElement(Crosshair);
+    }
+
+    if (UFPSHitEventSubsystem* HitEvents = GetWorld()->GetSubsystem<UFPSHitEventSubsystem>())
+    {
+        HitEventBatchHandle = HitEvents->OnBatch(EFPSHitEventPhase::FX).AddUObject(this, &AFPSHUD::OnHitEventBatch);
+    }
+}
+
+void AFPSHUD::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (UFPSHitEventSubsystem* HitEvents = GetWorld()->GetSubsystem<UFPSHitEventSubsystem>())
+    {
+        HitEvents->OnBatch(EFPSHitEventPhase::FX).Remove(HitEventBatchHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+// ----------------------------------------------------------
+// OnHitEventBatch
+// 命中提示：整批只检查一次，命中时把准星染色并记录结束时间，由 DrawHUD 负责恢复。
+// 包含纯表现事件，客户端本地预测的子弹命中时即可立即反馈。
+// ----------------------------------------------------------
+void AFPSHUD::OnHitEventBatch(const FFPSHitEventBatch& Batch)
+{
+    const APawn* LocalPawn = GetOwningPawn();
+    if (!LocalPawn || CrosshairHandle == INDEX_NONE)
+    {
+        return;
+    }
+
+    const bool bLocalHit = Batch.GetEvents(EFPSHitEventKind::CharacterHit).ContainsByPredicate([LocalPawn](const FFPSHitEvent& Event)
+    {
+        return Event.Instigator.Get() == LocalPawn && Event.HitActor.Get() != LocalPawn;
+    });
+    if (!bLocalHit)
+    {
+        return;
+    }
+
+    if (HitMarkerEndTime == 0.0)
+    {
+        UpdateElement(CrosshairHandle, [this](FFPSHUDElement& Element) { Element.Color = HitMarkerColor; });
+    }
+    HitMarkerEndTime = Batch.Time + HitMarkerDuration;
+}
 
 // ----------------------------------------------------------
 // DrawHUD
-// 每帧由引擎调用，负责在屏幕上绘制 HUD 元素。
-// 当前功能：在屏幕正中央渲染准星贴图。
+// 每帧由引擎调用：视口尺寸变化时全部重新布局，否则只处理脏元素；
+// 然后按缓存的顺序把四边形直接写入 Canvas 的批处理元素。
 // ----------------------------------------------------------
 void AFPSHUD::DrawHUD()
 {
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSHUDDraw);
+    LLM_SCOPE_BYTAG(FPSDemo_HUD);
+
     Super::DrawHUD();
 
-    // 确保准星贴图资源有效
-    if (CrosshairTexture)
+    // 命中提示到期：恢复准星颜色
+    if (HitMarkerEndTime > 0.0 && GetWorld()->GetTimeSeconds() >= HitMarkerEndTime)
+    {
+        HitMarkerEndTime = 0.0;
+        UpdateElement(CrosshairHandle, [](FFPSHUDElement& Element) { Element.Color = FLinearColor::White; });
+    }
+
+    const FVector2f ViewportSize(Canvas->ClipX, Canvas->ClipY);
+    const bool bViewportChanged = ViewportSize != LastViewportSize;
+    LastViewportSize = ViewportSize;
+
+    if (bDrawOrderDirty)
+    {
+        RebuildDrawOrder();
+    }
+
+    int32 NumRelayout = 0;
+    for (const int32 Handle : DrawOrder)
+    {
+        FFPSHUDElement& Element = Elements[Handle];
+        if (bViewportChanged || Element.bLayoutDirty)
+        {
+            UpdateLayout(Element);
+            ++NumRelayout;
+        }
+    }
+    INC_DWORD_STAT_BY(STAT_FPSHUDDirtyElements, NumRelayout);
+
+    FCanvas* RenderCanvas = Canvas->Canvas;
+    const FHitProxyId HitProxyId = RenderCanvas->GetHitProxyId();
+
+    int32 NumBatches = 0;
+    int32 Index = 0;
+    while (Index < DrawOrder.Num())
     {
-        /* 计算屏幕中心坐标（以像素为单位） */
-        FVector2D Center(Canvas->ClipX * 0.5f, Canvas->ClipY * 0.5f);
+        // 一批：相同贴图与混合模式的连续元素
+        const FFPSHUDElement& First = Elements[DrawOrder[Index]];
+        const FTexture* TextureResource = First.Texture->GetResource();
+        const ESimpleElementBlendMode BlendMode = First.BlendMode;
+
+        int32 BatchEnd = Index + 1;
+        while (BatchEnd < DrawOrder.Num()
+            && Elements[DrawOrder[BatchEnd]].Texture == First.Texture
+            && Elements[DrawOrder[BatchEnd]].BlendMode == BlendMode)
+        {
+            ++BatchEnd;
+        }
 
-        /* 计算贴图左上角绘制位置，使准星居中 */
-        FVector2D CrossHairDrawPosition(
-            Center.X - (CrosshairTexture->GetSurfaceWidth() * 0.5f),   // 水平居左偏移
-            Center.Y - (CrosshairTexture->GetSurfaceHeight() * 0.5f)    // 垂直居上偏移
-        );
+        if (TextureResource)
+        {
+            const int32 NumQuads = BatchEnd - Index;
+            FBatchedElements* BatchedElements = RenderCanvas->GetBatchedElements(FCanvas::ET_Triangle, nullptr, TextureResource, BlendMode);
+            BatchedElements->AddReserveVertices(NumQuads * 4);
+            BatchedElements->AddReserveTriangles(NumQuads * 2, TextureResource, BlendMode);
 
-        /* 创建绘制项：指定位置、贴图资源及颜色（白色保持原色） */
-        FCanvasTileItem TileItem(CrossHairDrawPosition, CrosshairTexture->GetResource(), FLinearColor::White);
+            for (int32 QuadIndex = Index; QuadIndex < BatchEnd; ++QuadIndex)
+            {
+                const FFPSHUDElement& Element = Elements[DrawOrder[QuadIndex]];
+                FLinearColor Color = Element.Color;
+                Color.A *= Canvas->AlphaModulate;
 
-        /* 设置混合模式为半透明，以支持带透明通道的准星贴图 */
-        TileItem.BlendMode = SE_BLEND_Translucent;
+                const int32 V00 = BatchedElements->AddVertexf(FVector4f(Element.ScreenMin.X, Element.ScreenMin.Y, 0.0f, 1.0f), FVector2f(Element.UV0.X, Element.UV0.Y), Color, HitProxyId);
+                const int32 V10 = BatchedElements->AddVertexf(FVector4f(Element.ScreenMax.X, Element.ScreenMin.Y, 0.0f, 1.0f), FVector2f(Element.UV1.X, Element.UV0.Y), Color, HitProxyId);
+                const int32 V01 = BatchedElements->AddVertexf(FVector4f(Element.ScreenMin.X, Element.ScreenMax.Y, 0.0f, 1.0f), FVector2f(Element.UV0.X, Element.UV1.Y), Color, HitProxyId);
+                const int32 V11 = BatchedElements->AddVertexf(FVector4f(Element.ScreenMax.X, Element.ScreenMax.Y, 0.0f, 1.0f), FVector2f(Element.UV1.X, Element.UV1.Y), Color, HitProxyId);
 
-        /* 将绘制项提交到 Canvas，完成渲染 */
-        Canvas->DrawItem(TileItem);
+                BatchedElements->AddTriangle(V00, V10, V11, TextureResource, BlendMode);
+                BatchedElements->AddTriangle(V00, V11, V01, TextureResource, BlendMode);
+            }
+
+            INC_DWORD_STAT_BY(STAT_FPSHUDDrawItems, NumQuads);
+            ++NumBatches;
+        }
+
+        Index = BatchEnd;
     }
-}
\ No newline at end of file
+    INC_DWORD_STAT_BY(STAT_FPSHUDBatches, NumBatches);
+}
+
+int32 AFPSHUD::AddElement(const FFPSHUDElement& Element)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_HUD);
+
+    int32 Handle;
+    if (FreeHandles.Num() > 0)
+    {
+        Handle = FreeHandles.Pop(EAllowShrinking::No);
+        Elements[Handle] = Element;
+    }
+    else
+    {
+        Handle = Elements.Add(Element);
+    }
+
+    Elements[Handle].bLayoutDirty = true;
+    bDrawOrderDirty = true;
+    return Handle;
+}
+
+void AFPSHUD::RemoveElement(int32 Handle)
+{
+    if (!Elements.IsValidIndex(Handle) || FreeHandles.Contains(Handle))
+    {
+        return;
+    }
+
+    Elements[Handle] = FFPSHUDElement();
+    Elements[Handle].bVisible = false;
+    FreeHandles.Add(Handle);
+    bDrawOrderDirty = true;
+}
+
+void AFPSHUD::UpdateElement(int32 Handle, TFunctionRef<void(FFPSHUDElement&)> Mutator)
+{
+    if (!Elements.IsValidIndex(Handle))
+    {
+        return;
+    }
+
+    FFPSHUDElement& Element = Elements[Handle];
+    Mutator(Element);
+    Element.bLayoutDirty = true;
+    // 贴图、混合模式、层级或可见性都可能改变
+    bDrawOrderDirty = true;
+}
+
+const FFPSHUDElement* AFPSHUD::GetElement(int32 Handle) const
+{
+    return Elements.IsValidIndex(Handle) ? &Elements[Handle] : nullptr;
+}
+
+// ----------------------------------------------------------
+// 计算屏幕矩形：锚点 + 偏移 - 尺寸 × 对齐
+// ----------------------------------------------------------
+void AFPSHUD::UpdateLayout(FFPSHUDElement& Element) const
+{
+    FVector2D Size = Element.Size;
+    if (Size.IsZero() && Element.Texture)
+    {
+        Size = FVector2D(Element.Texture->GetSurfaceWidth(), Element.Texture->GetSurfaceHeight());
+    }
+
+    const FVector2D Position = FVector2D(LastViewportSize) * Element.Anchor + Element.Offset - Size * Element.Alignment;
+    Element.ScreenMin = FVector2f(Position);
+    Element.ScreenMax = FVector2f(Position + Size);
+    Element.bLayoutDirty = false;
+}
+
+// ----------------------------------------------------------
+// 绘制顺序：按层级排序，同一层内按贴图与混合模式聚合以减少提交次数
+// ----------------------------------------------------------
+void AFPSHUD::RebuildDrawOrder()
+{
+    DrawOrder.Reset();
+    for (int32 Handle = 0; Handle < Elements.Num(); ++Handle)
+    {
+        const FFPSHUDElement& Element = Elements[Handle];
+        if (Element.bVisible && Element.Texture)
+        {
+            DrawOrder.Add(Handle);
+        }
+    }
+
+    DrawOrder.Sort([this](int32 A, int32 B)
+    {
+        const FFPSHUDElement& ElementA = Elements[A];
+        const FFPSHUDElement& ElementB = Elements[B];
+        if (ElementA.ZOrder != ElementB.ZOrder)
+        {
+            return ElementA.ZOrder < ElementB.ZOrder;
+        }
+        if (ElementA.Texture != ElementB.Texture)
+        {
+            return ElementA.Texture.Get() < ElementB.Texture.Get();
+        }
+        if (ElementA.BlendMode != ElementB.BlendMode)
+        {
+            return ElementA.BlendMode < ElementB.BlendMode;
+        }
+        return A < B;
+    });
+
+    bDrawOrderDirty = false;
+}
@@ -4,12 +4,17 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/HUD.h"
+#include "FPSHUD/FPSHUDElement.h"
 #include "FPSHUD.generated.h"
 
 /**
  * AFPSHUD
  * 项目的主 HUD（Head-Up Display）类。
  * 用于在屏幕上绘制第一人称射击游戏所需的基本 UI，例如准星/十字准线。
+ *
+ * 采用保留模式：HUD 元素注册一次后缓存在 Elements 中，只有被修改（或视口尺寸变化）的元素重新计算布局；
+ * 绘制顺序按 ZOrder、贴图、混合模式排序后缓存，每帧直接把顶点写入 Canvas 的批处理元素，
+ * 相同贴图与混合模式的相邻元素合并为一次提交。
  */
 UCLASS()
 class FPSDEMO_API AFPSHUD : public AHUD
@@ -22,10 +27,70 @@ protected:
     UPROPERTY(EditDefaultsOnly, Category = "HUD")
     UTexture2D* CrosshairTexture;
 
+    /* 命中提示：本地玩家命中角色时准星短暂变为该颜色 */
+    UPROPERTY(EditDefaultsOnly, Category = "HUD")
+    FLinearColor HitMarkerColor = FLinearColor::Red;
+
+    /* 命中提示持续时间（秒） */
+    UPROPERTY(EditDefaultsOnly, Category = "HUD", meta = (ClampMin = "0.0"))
+    float HitMarkerDuration = 0.15f;
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
     /* 重写 AHUD::DrawHUD()
      * 每帧由引擎调用，负责在屏幕上绘制所有 HUD 元素。
-     * 当前实现：在画面中央绘制 CrosshairTexture。
+     * 只重新计算脏元素的布局，然后按缓存的顺序批量提交。
      */
     virtual void DrawHUD() override;
-};
\ No newline at end of file
+
+    /**
+     * 注册一个元素。
+     * @return 元素句柄，用于后续修改或移除
+     */
+    int32 AddElement(const FFPSHUDElement& Element);
+
+    /* 移除元素，句柄随后可能被新元素复用 */
+    void RemoveElement(int32 Handle);
+
+    /**
+     * 修改元素：回调中直接修改元素，返回后自动标记布局与绘制顺序为脏。
+     * 例如：UpdateElement(Handle, [](FFPSHUDElement& E) { E.Color = FLinearColor::Red; });
+     */
+    void UpdateElement(int32 Handle, TFunctionRef<void(FFPSHUDElement&)> Mutator);
+
+    /* 只读访问元素，句柄无效时返回 nullptr */
+    const FFPSHUDElement* GetElement(int32 Handle) const;
+
+private:
+    /* 计算元素的屏幕矩形 */
+    void UpdateLayout(FFPSHUDElement& Element) const;
+
+    /* 重建绘制顺序 */
+    void RebuildDrawOrder();
+
+    /* 命中事件总线 FX 阶段：本帧批次中有本地玩家命中角色时触发命中提示 */
+    void OnHitEventBatch(const struct FFPSHitEventBatch& Batch);
+
+    /* 所有元素（移除后的空槽保留在 FreeHandles 中复用） */
+    UPROPERTY(Transient)
+    TArray<FFPSHUDElement> Elements;
+
+    TArray<int32> FreeHandles;
+
+    /* 缓存的绘制顺序（可见且有贴图的元素） */
+    TArray<int32> DrawOrder;
+    bool bDrawOrderDirty = true;
+
+    /* 上次绘制时的视口尺寸，变化时所有元素重新布局 */
+    FVector2f LastViewportSize = FVector2f::ZeroVector;
+
+    /* 准星元素句柄 */
+    int32 CrosshairHandle = INDEX_NONE;
+
+    /* 命中提示的结束时间（世界时间），0 表示未显示 */
+    double HitMarkerEndTime = 0.0;
+
+    FDelegateHandle HitEventBatchHandle;
+};
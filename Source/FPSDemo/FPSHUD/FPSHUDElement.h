@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "FPSHUDElement.generated.h"
+
+class UTexture;
+
+/**
+ * FFPSHUDElement
+ * 保留模式的 HUD 贴图元素。
+ * 描述部分（贴图、锚点、偏移、尺寸等）只在修改时标记为脏；屏幕矩形缓存在元素中，
+ * 仅当元素本身或视口尺寸变化时才重新计算。
+ */
+USTRUCT()
+struct FPSDEMO_API FFPSHUDElement
+{
+    GENERATED_BODY()
+
+    /* 贴图，为空的元素不绘制 */
+    UPROPERTY()
+    TObjectPtr<UTexture> Texture;
+
+    /* 锚点：视口的归一化坐标，(0.5, 0.5) 为屏幕中心 */
+    FVector2D Anchor = FVector2D(0.5, 0.5);
+
+    /* 对齐：元素自身的归一化枢轴，(0.5, 0.5) 表示以中心对齐到锚点 */
+    FVector2D Alignment = FVector2D(0.5, 0.5);
+
+    /* 相对锚点的像素偏移 */
+    FVector2D Offset = FVector2D::ZeroVector;
+
+    /* 像素尺寸，为 0 时使用贴图尺寸 */
+    FVector2D Size = FVector2D::ZeroVector;
+
+    /* 贴图 UV 范围 */
+    FVector2f UV0 = FVector2f(0.0f, 0.0f);
+    FVector2f UV1 = FVector2f(1.0f, 1.0f);
+
+    FLinearColor Color = FLinearColor::White;
+
+    ESimpleElementBlendMode BlendMode = SE_BLEND_Translucent;
+
+    /* 绘制顺序，越大越靠上；同一层内按贴图与混合模式合批 */
+    int32 ZOrder = 0;
+
+    bool bVisible = true;
+
+    /* 缓存的屏幕矩形 */
+    FVector2f ScreenMin = FVector2f::ZeroVector;
+    FVector2f ScreenMax = FVector2f::ZeroVector;
+
+    /* 屏幕矩形需要重新计算 */
+    bool bLayoutDirty = true;
+};
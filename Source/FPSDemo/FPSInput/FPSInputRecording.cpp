@@ -0,0 +1,392 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSInput/FPSInputRecording.h"
+#include "FPSDemo.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Serialization/MemoryReader.h"
+
+namespace FPSInputRecording
+{
+    /* 每帧标志字节 */
+    enum EFrameFlags : uint8
+    {
+        Flag_Move       = 1 << 0, // 本帧调用了 Move
+        Flag_MoveValue  = 1 << 1, // Move 的值与上一次不同，后跟两个差值
+        Flag_Look       = 1 << 2, // 本帧调用了 Look
+        Flag_LookValue  = 1 << 3, // Look 的值与上一次不同，后跟两个差值
+        Flag_StartJump  = 1 << 4,
+        Flag_StopJump   = 1 << 5,
+        Flag_Shoot      = 1 << 6,
+        Flag_IdleRun    = 1 << 7, // 单独出现：后跟连续空帧的数量
+    };
+
+    /* 编码缓冲达到该大小时写入文件 */
+    static constexpr int32 FlushThreshold = 64 * 1024;
+
+    /* 回放时每次映射的窗口大小 */
+    static constexpr int64 ReplayWindowSize = 16 * 1024 * 1024;
+
+    /* 量化值限制在 ±2^30 以内，保证差值不会溢出 int32 */
+    static constexpr double MaxQuantized = 1 << 30;
+
+    static int32 Quantize(double Value, float Quantization)
+    {
+        return static_cast<int32>(FMath::RoundToDouble(FMath::Clamp(Value * Quantization, -MaxQuantized, MaxQuantized)));
+    }
+
+    static uint32 ZigZagEncode(int32 Value)
+    {
+        return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+    }
+
+    static int32 ZigZagDecode(uint32 Value)
+    {
+        return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+    }
+}
+
+// ------------------------------------------------------------------
+// 文件头：逐字段按固定宽度读写，不依赖引擎版本的向量序列化格式
+// ------------------------------------------------------------------
+bool FFPSInputRecordingHeader::Serialize(FArchive& Ar)
+{
+    uint32 FileMagic = Magic;
+    Ar << FileMagic;
+    Ar << Version;
+
+    if (Ar.IsLoading() && (FileMagic != Magic || Version != CurrentVersion))
+    {
+        return false;
+    }
+
+    Ar << FixedStep;
+    Ar << Quantization;
+    Ar << RandomSeed;
+    Ar << FrameCount;
+    Ar << StartLocation.X << StartLocation.Y << StartLocation.Z;
+    Ar << StartActorRotation.Pitch << StartActorRotation.Yaw << StartActorRotation.Roll;
+    Ar << StartControlRotation.Pitch << StartControlRotation.Yaw << StartControlRotation.Roll;
+
+    return !Ar.IsError() && FixedStep > 0.0f && Quantization > 0.0f;
+}
+
+// ------------------------------------------------------------------
+// 写入
+// ------------------------------------------------------------------
+FFPSInputRecordWriter::~FFPSInputRecordWriter()
+{
+    Close();
+}
+
+bool FFPSInputRecordWriter::Open(const FString& Filename, const FFPSInputRecordingHeader& InHeader)
+{
+    Close();
+
+    Archive.Reset(IFileManager::Get().CreateFileWriter(*Filename));
+    if (!Archive)
+    {
+        UE_LOG(LogFPSDemo, Error, TEXT("InputRecording: failed to create %s"), *Filename);
+        return false;
+    }
+
+    Header = InHeader;
+    Header.FrameCount = 0;
+    Header.Serialize(*Archive);
+
+    Buffer.Reset(FPSInputRecording::FlushThreshold + 64);
+    IdleRun = 0;
+    PreviousMove[0] = PreviousMove[1] = 0;
+    PreviousLook[0] = PreviousLook[1] = 0;
+    return true;
+}
+
+void FFPSInputRecordWriter::WriteFrame(const FFPSInputFrame& Frame)
+{
+    using namespace FPSInputRecording;
+
+    ++Header.FrameCount;
+
+    if (Frame.IsEmpty())
+    {
+        ++IdleRun;
+        return;
+    }
+
+    FlushIdleRun();
+
+    const int32 Move[2] = { Quantize(Frame.Move.X, Header.Quantization), Quantize(Frame.Move.Y, Header.Quantization) };
+    const int32 Look[2] = { Quantize(Frame.Look.X, Header.Quantization), Quantize(Frame.Look.Y, Header.Quantization) };
+
+    uint8 Flags = 0;
+    if (Frame.bMove)
+    {
+        Flags |= Flag_Move;
+        if (Move[0] != PreviousMove[0] || Move[1] != PreviousMove[1])
+        {
+            Flags |= Flag_MoveValue;
+        }
+    }
+    if (Frame.bLook)
+    {
+        Flags |= Flag_Look;
+        if (Look[0] != PreviousLook[0] || Look[1] != PreviousLook[1])
+        {
+            Flags |= Flag_LookValue;
+        }
+    }
+    Flags |= Frame.bStartJump ? Flag_StartJump : 0;
+    Flags |= Frame.bStopJump ? Flag_StopJump : 0;
+    Flags |= Frame.bShoot ? Flag_Shoot : 0;
+
+    Buffer.Add(Flags);
+
+    if (Flags & Flag_MoveValue)
+    {
+        WriteAxis(Move[0], PreviousMove[0]);
+        WriteAxis(Move[1], PreviousMove[1]);
+    }
+    if (Flags & Flag_LookValue)
+    {
+        WriteAxis(Look[0], PreviousLook[0]);
+        WriteAxis(Look[1], PreviousLook[1]);
+    }
+
+    if (Buffer.Num() >= FlushThreshold)
+    {
+        FlushBuffer();
+    }
+}
+
+void FFPSInputRecordWriter::Close()
+{
+    if (!Archive)
+    {
+        return;
+    }
+
+    FlushIdleRun();
+    FlushBuffer();
+
+    // 回写帧数
+    Archive->Seek(0);
+    Header.Serialize(*Archive);
+    Archive->Close();
+    Archive.Reset();
+}
+
+int64 FFPSInputRecordWriter::GetBytesWritten() const
+{
+    return Archive ? Archive->Tell() + Buffer.Num() : 0;
+}
+
+void FFPSInputRecordWriter::WriteVarInt(uint64 Value)
+{
+    while (Value >= 0x80)
+    {
+        Buffer.Add(static_cast<uint8>(Value | 0x80));
+        Value >>= 7;
+    }
+    Buffer.Add(static_cast<uint8>(Value));
+}
+
+void FFPSInputRecordWriter::WriteAxis(int32 Quantized, int32& Previous)
+{
+    WriteVarInt(FPSInputRecording::ZigZagEncode(Quantized - Previous));
+    Previous = Quantized;
+}
+
+void FFPSInputRecordWriter::FlushIdleRun()
+{
+    if (IdleRun > 0)
+    {
+        Buffer.Add(FPSInputRecording::Flag_IdleRun);
+        WriteVarInt(IdleRun);
+        IdleRun = 0;
+    }
+}
+
+void FFPSInputRecordWriter::FlushBuffer()
+{
+    if (Buffer.Num() > 0)
+    {
+        Archive->Serialize(Buffer.GetData(), Buffer.Num());
+        Buffer.Reset();
+    }
+}
+
+// ------------------------------------------------------------------
+// 读取
+// ------------------------------------------------------------------
+FFPSInputReplayReader::~FFPSInputReplayReader()
+{
+    Close();
+}
+
+bool FFPSInputReplayReader::Open(const FString& Filename)
+{
+    Close();
+
+    MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+    if (!MappedFile)
+    {
+        UE_LOG(LogFPSDemo, Error, TEXT("InputReplay: failed to memory-map %s"), *Filename);
+        return false;
+    }
+
+    FileSize = MappedFile->GetFileSize();
+    if (!MapWindow(0))
+    {
+        Close();
+        return false;
+    }
+
+    FMemoryReaderView HeaderReader(MakeArrayView(WindowData, static_cast<int32>(FMath::Min<int64>(WindowSize, 1024))));
+    if (!Header.Serialize(HeaderReader))
+    {
+        UE_LOG(LogFPSDemo, Error, TEXT("InputReplay: %s is not a valid input recording"), *Filename);
+        Close();
+        return false;
+    }
+
+    WindowCursor = HeaderReader.Tell();
+    return true;
+}
+
+bool FFPSInputReplayReader::ReadFrame(FFPSInputFrame& OutFrame)
+{
+    using namespace FPSInputRecording;
+
+    if (!MappedFile || FramesRead >= Header.FrameCount)
+    {
+        return false;
+    }
+
+    OutFrame = FFPSInputFrame();
+
+    if (IdleRemaining > 0)
+    {
+        --IdleRemaining;
+        ++FramesRead;
+        return true;
+    }
+
+    uint8 Flags = 0;
+    if (!ReadByte(Flags))
+    {
+        return false;
+    }
+
+    if (Flags == Flag_IdleRun)
+    {
+        uint64 Count = 0;
+        if (!ReadVarInt(Count) || Count == 0)
+        {
+            return false;
+        }
+        IdleRemaining = Count - 1;
+        ++FramesRead;
+        return true;
+    }
+
+    if ((Flags & Flag_MoveValue) && !(ReadAxis(PreviousMove[0]) && ReadAxis(PreviousMove[1])))
+    {
+        return false;
+    }
+    if ((Flags & Flag_LookValue) && !(ReadAxis(PreviousLook[0]) && ReadAxis(PreviousLook[1])))
+    {
+        return false;
+    }
+
+    const double InvQuantization = 1.0 / Header.Quantization;
+    OutFrame.bMove = (Flags & Flag_Move) != 0;
+    OutFrame.Move = FVector2D(PreviousMove[0] * InvQuantization, PreviousMove[1] * InvQuantization);
+    OutFrame.bLook = (Flags & Flag_Look) != 0;
+    OutFrame.Look = FVector2D(PreviousLook[0] * InvQuantization, PreviousLook[1] * InvQuantization);
+    OutFrame.bStartJump = (Flags & Flag_StartJump) != 0;
+    OutFrame.bStopJump = (Flags & Flag_StopJump) != 0;
+    OutFrame.bShoot = (Flags & Flag_Shoot) != 0;
+
+    ++FramesRead;
+    return true;
+}
+
+void FFPSInputReplayReader::Close()
+{
+    // 先释放映射区域，再关闭文件
+    MappedRegion.Reset();
+    MappedFile.Reset();
+
+    WindowData = nullptr;
+    WindowOffset = WindowSize = WindowCursor = FileSize = 0;
+    FramesRead = IdleRemaining = 0;
+    PreviousMove[0] = PreviousMove[1] = 0;
+    PreviousLook[0] = PreviousLook[1] = 0;
+}
+
+bool FFPSInputReplayReader::MapWindow(int64 Offset)
+{
+    const int64 Size = FMath::Min(FPSInputRecording::ReplayWindowSize, FileSize - Offset);
+    if (Size <= 0)
+    {
+        return false;
+    }
+
+    MappedRegion.Reset();
+    MappedRegion.Reset(MappedFile->MapRegion(Offset, Size));
+    if (!MappedRegion)
+    {
+        return false;
+    }
+
+    WindowOffset = Offset;
+    WindowData = MappedRegion->GetMappedPtr();
+    WindowSize = MappedRegion->GetMappedSize();
+    WindowCursor = 0;
+    return true;
+}
+
+bool FFPSInputReplayReader::ReadByte(uint8& OutByte)
+{
+    // 当前窗口读完时映射下一段
+    if (WindowCursor >= WindowSize && !MapWindow(WindowOffset + WindowSize))
+    {
+        return false;
+    }
+
+    OutByte = WindowData[WindowCursor++];
+    return true;
+}
+
+bool FFPSInputReplayReader::ReadVarInt(uint64& OutValue)
+{
+    OutValue = 0;
+    for (int32 Shift = 0; Shift < 64; Shift += 7)
+    {
+        uint8 Byte = 0;
+        if (!ReadByte(Byte))
+        {
+            return false;
+        }
+
+        OutValue |= static_cast<uint64>(Byte & 0x7F) << Shift;
+        if (!(Byte & 0x80))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool FFPSInputReplayReader::ReadAxis(int32& InOutQuantized)
+{
+    uint64 Encoded = 0;
+    if (!ReadVarInt(Encoded))
+    {
+        return false;
+    }
+
+    InOutQuantized += FPSInputRecording::ZigZagDecode(static_cast<uint32>(Encoded));
+    return true;
+}
@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FArchive;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/* 被录制的输入通道，对应 AFPSCharacter 的输入处理函数 */
+enum class EFPSInputChannel : uint8
+{
+    Move,
+    Look,
+    StartJump,
+    StopJump,
+    Shoot,
+};
+
+/**
+ * 一帧的输入：每个通道本帧是否被调用及其值。
+ * 同一通道在一帧内被多次调用时，Look 累加，Move 取最后一次。
+ */
+struct FFPSInputFrame
+{
+    FVector2D Move = FVector2D::ZeroVector;
+    FVector2D Look = FVector2D::ZeroVector;
+    bool bMove = false;
+    bool bLook = false;
+    bool bStartJump = false;
+    bool bStopJump = false;
+    bool bShoot = false;
+
+    bool IsEmpty() const { return !bMove && !bLook && !bStartJump && !bStopJump && !bShoot; }
+};
+
+/**
+ * 录制文件头。回放时据此恢复起始状态与固定步长。
+ */
+struct FFPSInputRecordingHeader
+{
+    static constexpr uint32 Magic = 0x49535046; // "FPSI"
+    static constexpr uint16 CurrentVersion = 1;
+
+    uint16 Version = CurrentVersion;
+
+    /* 录制时的固定步长（秒），回放使用同一步长 */
+    float FixedStep = 1.0f / 60.0f;
+
+    /* 轴值量化系数：存储值 = round(值 × Quantization) */
+    float Quantization = 1024.0f;
+
+    /* 录制开始时设置的随机数种子 */
+    int32 RandomSeed = 0;
+
+    /* 总帧数（关闭文件时回写） */
+    uint64 FrameCount = 0;
+
+    /* 录制开始时角色与控制器的状态 */
+    FVector StartLocation = FVector::ZeroVector;
+    FRotator StartActorRotation = FRotator::ZeroRotator;
+    FRotator StartControlRotation = FRotator::ZeroRotator;
+
+    /* 返回 false 表示魔数或版本不匹配 */
+    bool Serialize(FArchive& Ar);
+};
+
+/**
+ * FFPSInputRecordWriter
+ * 把逐帧输入编码为紧凑的二进制流：
+ *   - 每帧一个标志字节，标明被调用的通道，以及 Move / Look 的值是否与上一次不同；
+ *   - 变化的轴值量化为整数，与上一次的差值以 ZigZag + 变长整数写入；
+ *   - 连续的空帧合并为一个“空帧游程”（标志字节 + 帧数）。
+ * 无操作时每秒只占几个字节，持续移动视角时每帧约 3~5 字节。
+ */
+class FPSDEMO_API FFPSInputRecordWriter
+{
+public:
+    ~FFPSInputRecordWriter();
+
+    /* 创建文件并写入文件头（帧数在 Close 时回写） */
+    bool Open(const FString& Filename, const FFPSInputRecordingHeader& InHeader);
+
+    /* 追加一帧 */
+    void WriteFrame(const FFPSInputFrame& Frame);
+
+    /* 写出剩余数据、回写文件头并关闭 */
+    void Close();
+
+    bool IsOpen() const { return Archive.IsValid(); }
+    uint64 GetFrameCount() const { return Header.FrameCount; }
+    int64 GetBytesWritten() const;
+
+private:
+    void WriteVarInt(uint64 Value);
+    void WriteAxis(int32 Quantized, int32& Previous);
+    void FlushIdleRun();
+    void FlushBuffer();
+
+    TUniquePtr<FArchive> Archive;
+    FFPSInputRecordingHeader Header;
+
+    /* 待写入文件的编码数据 */
+    TArray<uint8> Buffer;
+
+    /* 当前连续空帧数 */
+    uint64 IdleRun = 0;
+
+    /* 上一次写出的量化值（差分编码的基准） */
+    int32 PreviousMove[2] = { 0, 0 };
+    int32 PreviousLook[2] = { 0, 0 };
+};
+
+/**
+ * FFPSInputReplayReader
+ * 以内存映射方式流式读取录制文件：每次只映射一个固定大小的窗口，读到窗口末尾时再映射下一段，
+ * 因此数小时的录制也不会整体读入内存。
+ */
+class FPSDEMO_API FFPSInputReplayReader
+{
+public:
+    ~FFPSInputReplayReader();
+
+    /* 打开文件并解析文件头 */
+    bool Open(const FString& Filename);
+
+    /* 读取下一帧，读完（或数据损坏）时返回 false */
+    bool ReadFrame(FFPSInputFrame& OutFrame);
+
+    void Close();
+
+    const FFPSInputRecordingHeader& GetHeader() const { return Header; }
+    uint64 GetFramesRead() const { return FramesRead; }
+
+private:
+    /* 映射从 Offset 开始的窗口 */
+    bool MapWindow(int64 Offset);
+
+    bool ReadByte(uint8& OutByte);
+    bool ReadVarInt(uint64& OutValue);
+    bool ReadAxis(int32& InOutQuantized);
+
+    TUniquePtr<IMappedFileHandle> MappedFile;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    FFPSInputRecordingHeader Header;
+
+    int64 FileSize = 0;
+
+    /* 当前窗口在文件中的起点与窗口内的读取位置 */
+    int64 WindowOffset = 0;
+    const uint8* WindowData = nullptr;
+    int64 WindowSize = 0;
+    int64 WindowCursor = 0;
+
+    uint64 FramesRead = 0;
+    uint64 IdleRemaining = 0;
+
+    int32 PreviousMove[2] = { 0, 0 };
+    int32 PreviousLook[2] = { 0, 0 };
+};
@@ -0,0 +1,466 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSInput/FPSInputReplaySubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSDemo.h"
+#include "FPSDemoMemory.h"
+#include "Engine/Engine.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "InputActionValue.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<float> CVarInputFixedStep(
+    TEXT("fps.Input.FixedStep"),
+    1.0f / 60.0f,
+    TEXT("输入录制使用的固定步长（秒）。录制期间引擎以该步长运行，回放使用录制文件中记录的步长。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorldAndArgs GInputRecordCommand(
+    TEXT("fps.Input.Record"),
+    TEXT("开始录制本地玩家的输入。参数：[文件路径]，默认写入 Saved/InputRecordings。"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (UFPSInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFPSInputReplaySubsystem>() : nullptr)
+        {
+            Replay->StartRecording(Args.Num() > 0 ? Args[0] : UFPSInputReplaySubsystem::MakeDefaultRecordingPath());
+        }
+    }));
+
+static FAutoConsoleCommandWithWorld GInputStopRecordCommand(
+    TEXT("fps.Input.StopRecord"),
+    TEXT("停止录制输入并关闭文件。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (UFPSInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFPSInputReplaySubsystem>() : nullptr)
+        {
+            Replay->StopRecording();
+        }
+    }));
+
+static FAutoConsoleCommandWithWorldAndArgs GInputReplayCommand(
+    TEXT("fps.Input.Replay"),
+    TEXT("回放输入录制文件到本地玩家角色。参数：文件路径。"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+    {
+        UFPSInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFPSInputReplaySubsystem>() : nullptr;
+        if (Replay && Args.Num() > 0)
+        {
+            Replay->StartReplay(Args[0]);
+        }
+    }));
+
+static FAutoConsoleCommandWithWorld GInputStopReplayCommand(
+    TEXT("fps.Input.StopReplay"),
+    TEXT("停止回放输入。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (UFPSInputReplaySubsystem* Replay = World ? World->GetSubsystem<UFPSInputReplaySubsystem>() : nullptr)
+        {
+            Replay->StopReplay();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 回放 Tick 函数
+// ------------------------------------------------------------------
+void FFPSInputReplayTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Target)
+    {
+        Target->ReplayFrame();
+    }
+}
+
+FString FFPSInputReplayTickFunction::DiagnosticMessage()
+{
+    return TEXT("FFPSInputReplayTickFunction");
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSInputReplaySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UFPSInputReplaySubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSInputReplaySubsystem, STATGROUP_Tickables);
+}
+
+FString UFPSInputReplaySubsystem::MakeDefaultRecordingPath()
+{
+    return FPaths::ProjectSavedDir() / TEXT("InputRecordings") / FString::Printf(TEXT("Input_%s.fpsinput"), *FDateTime::Now().ToString());
+}
+
+// ------------------------------------------------------------------
+// 关卡开始：处理命令行参数
+// ------------------------------------------------------------------
+void UFPSInputReplaySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    const TCHAR* CommandLine = FCommandLine::Get();
+
+    FString Filename;
+    if (FParse::Value(CommandLine, TEXT("FPSReplayInput="), Filename))
+    {
+        StartReplay(Filename, !FParse::Param(CommandLine, TEXT("ReplayNoExit")));
+    }
+    else if (FParse::Value(CommandLine, TEXT("FPSRecordInput="), Filename))
+    {
+        StartRecording(Filename);
+    }
+    else if (FParse::Param(CommandLine, TEXT("FPSRecordInput")))
+    {
+        StartRecording(MakeDefaultRecordingPath());
+    }
+}
+
+void UFPSInputReplaySubsystem::Deinitialize()
+{
+    StopRecording();
+    StopReplay();
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 帧末：等待角色就绪、提交本帧录制的输入、结束已读完的回放
+// ------------------------------------------------------------------
+void UFPSInputReplaySubsystem::Tick(float DeltaTime)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Input);
+
+    Super::Tick(DeltaTime);
+
+    switch (Mode)
+    {
+    case EMode::PendingRecord:
+    case EMode::PendingReplay:
+    {
+        APlayerController* Controller = nullptr;
+        if (AFPSCharacter* LocalCharacter = FindLocalCharacter(Controller))
+        {
+            if (Mode == EMode::PendingRecord)
+            {
+                BeginRecording(LocalCharacter, Controller);
+            }
+            else
+            {
+                BeginReplay(LocalCharacter, Controller);
+            }
+        }
+        break;
+    }
+
+    case EMode::Recording:
+        // 角色被销毁时结束录制
+        if (!Character.IsValid())
+        {
+            StopRecording();
+            break;
+        }
+        Writer.WriteFrame(CapturedFrame);
+        CapturedFrame = FFPSInputFrame();
+        break;
+
+    case EMode::Replaying:
+        if (bReplayFinished || !Character.IsValid())
+        {
+            StopReplay();
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+AFPSCharacter* UFPSInputReplaySubsystem::FindLocalCharacter(APlayerController*& OutController) const
+{
+    OutController = GetWorld()->GetFirstPlayerController();
+    return OutController ? Cast<AFPSCharacter>(OutController->GetPawn()) : nullptr;
+}
+
+// ------------------------------------------------------------------
+// 录制
+// ------------------------------------------------------------------
+bool UFPSInputReplaySubsystem::StartRecording(const FString& Filename)
+{
+    if (Mode != EMode::None)
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("InputRecording: already recording or replaying"));
+        return false;
+    }
+
+    PendingFilename = Filename;
+    Mode = EMode::PendingRecord;
+    return true;
+}
+
+bool UFPSInputReplaySubsystem::BeginRecording(AFPSCharacter* InCharacter, APlayerController* InController)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Input);
+
+    FFPSInputRecordingHeader Header;
+    Header.FixedStep = FMath::Max(CVarInputFixedStep.GetValueOnGameThread(), 1.0f / 1000.0f);
+    Header.RandomSeed = FMath::Rand();
+    Header.StartLocation = InCharacter->GetActorLocation();
+    Header.StartActorRotation = InCharacter->GetActorRotation();
+    Header.StartControlRotation = InController->GetControlRotation();
+
+    if (!Writer.Open(PendingFilename, Header))
+    {
+        Mode = EMode::None;
+        return false;
+    }
+
+    // 录制与回放从相同的随机数状态开始
+    FMath::RandInit(Header.RandomSeed);
+    FMath::SRandInit(Header.RandomSeed);
+
+    // 录制期间以固定帧率运行，每帧的步长与回放一致
+    SaveTimeStepSettings();
+    GEngine->bUseFixedFrameRate = true;
+    GEngine->FixedFrameRate = 1.0f / Header.FixedStep;
+
+    Character = InCharacter;
+    PlayerController = InController;
+    CapturedFrame = FFPSInputFrame();
+    InCharacter->SetInputRecorder(this);
+    Mode = EMode::Recording;
+
+    UE_LOG(LogFPSDemo, Display, TEXT("InputRecording: recording %s to %s at %.1f Hz"),
+        *InCharacter->GetName(), *PendingFilename, 1.0f / Header.FixedStep);
+    return true;
+}
+
+void UFPSInputReplaySubsystem::StopRecording()
+{
+    if (Mode == EMode::PendingRecord)
+    {
+        Mode = EMode::None;
+        return;
+    }
+
+    if (Mode != EMode::Recording)
+    {
+        return;
+    }
+
+    if (AFPSCharacter* RecordedCharacter = Character.Get())
+    {
+        RecordedCharacter->SetInputRecorder(nullptr);
+    }
+
+    const uint64 FrameCount = Writer.GetFrameCount();
+    Writer.Close();
+    RestoreTimeStepSettings();
+
+    UE_LOG(LogFPSDemo, Display, TEXT("InputRecording: wrote %llu frames to %s (%s)"),
+        FrameCount, *PendingFilename, *FText::AsMemory(IFileManager::Get().FileSize(*PendingFilename)).ToString());
+
+    Character.Reset();
+    PlayerController.Reset();
+    Mode = EMode::None;
+}
+
+void UFPSInputReplaySubsystem::CaptureInput(EFPSInputChannel Channel, const FInputActionValue& Value)
+{
+    switch (Channel)
+    {
+    case EFPSInputChannel::Move:
+        CapturedFrame.bMove = true;
+        CapturedFrame.Move = Value.Get<FVector2D>();
+        break;
+    case EFPSInputChannel::Look:
+        CapturedFrame.bLook = true;
+        CapturedFrame.Look += Value.Get<FVector2D>();
+        break;
+    case EFPSInputChannel::StartJump:
+        CapturedFrame.bStartJump = true;
+        break;
+    case EFPSInputChannel::StopJump:
+        CapturedFrame.bStopJump = true;
+        break;
+    case EFPSInputChannel::Shoot:
+        CapturedFrame.bShoot = true;
+        break;
+    }
+}
+
+// ------------------------------------------------------------------
+// 回放
+// ------------------------------------------------------------------
+bool UFPSInputReplaySubsystem::StartReplay(const FString& Filename, bool bInExitWhenDone)
+{
+    if (Mode != EMode::None)
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("InputReplay: already recording or replaying"));
+        return false;
+    }
+
+    PendingFilename = Filename;
+    bExitWhenDone = bInExitWhenDone;
+    Mode = EMode::PendingReplay;
+    return true;
+}
+
+bool UFPSInputReplaySubsystem::BeginReplay(AFPSCharacter* InCharacter, APlayerController* InController)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Input);
+
+    if (!Reader.Open(PendingFilename))
+    {
+        Mode = EMode::None;
+        if (bExitWhenDone)
+        {
+            FPlatformMisc::RequestExit(false, TEXT("FPSInputReplay"));
+        }
+        return false;
+    }
+
+    const FFPSInputRecordingHeader& Header = Reader.GetHeader();
+
+    // 恢复录制开始时的状态
+    InCharacter->SetActorLocationAndRotation(Header.StartLocation, Header.StartActorRotation, false, nullptr, ETeleportType::ResetPhysics);
+    InCharacter->GetCharacterMovement()->StopMovementImmediately();
+    InController->SetControlRotation(Header.StartControlRotation);
+    FMath::RandInit(Header.RandomSeed);
+    FMath::SRandInit(Header.RandomSeed);
+
+    // 以录制时的步长运行，且不等待真实时间（无界面时尽可能快）
+    SaveTimeStepSettings();
+    FApp::SetUseFixedTimeStep(true);
+    FApp::SetFixedDeltaTime(Header.FixedStep);
+    FApp::SetBenchmarking(true);
+
+    // 屏蔽实时输入，只接受回放的输入
+    InCharacter->DisableInput(InController);
+
+    // 在控制器处理输入之前注入
+    ReplayTickFunction.Target = this;
+    ReplayTickFunction.TickGroup = TG_PrePhysics;
+    ReplayTickFunction.bCanEverTick = true;
+    ReplayTickFunction.bTickEvenWhenPaused = false;
+    ReplayTickFunction.RegisterTickFunction(GetWorld()->PersistentLevel);
+    InController->PrimaryActorTick.AddPrerequisite(this, ReplayTickFunction);
+
+    Character = InCharacter;
+    PlayerController = InController;
+    bReplayFinished = false;
+    ReplayStartWallTime = FPlatformTime::Seconds();
+    Mode = EMode::Replaying;
+
+    UE_LOG(LogFPSDemo, Display, TEXT("InputReplay: replaying %s (%llu frames at %.1f Hz) into %s"),
+        *PendingFilename, Header.FrameCount, 1.0f / Header.FixedStep, *InCharacter->GetName());
+    return true;
+}
+
+void UFPSInputReplaySubsystem::ReplayFrame()
+{
+    AFPSCharacter* ReplayCharacter = Character.Get();
+    FFPSInputFrame Frame;
+    if (bReplayFinished || !ReplayCharacter || !Reader.ReadFrame(Frame))
+    {
+        bReplayFinished = true;
+        return;
+    }
+
+    // 与 Enhanced Input 调用同一组处理函数
+    if (Frame.bMove)
+    {
+        ReplayCharacter->Move(FInputActionValue(Frame.Move));
+    }
+    if (Frame.bLook)
+    {
+        ReplayCharacter->Look(FInputActionValue(Frame.Look));
+    }
+    if (Frame.bStartJump)
+    {
+        ReplayCharacter->StartJump(FInputActionValue(true));
+    }
+    if (Frame.bStopJump)
+    {
+        ReplayCharacter->StopJump(FInputActionValue(false));
+    }
+    if (Frame.bShoot)
+    {
+        ReplayCharacter->Shoot(FInputActionValue(true));
+    }
+}
+
+void UFPSInputReplaySubsystem::StopReplay()
+{
+    if (Mode == EMode::PendingReplay)
+    {
+        Mode = EMode::None;
+        return;
+    }
+
+    if (Mode != EMode::Replaying)
+    {
+        return;
+    }
+
+    if (APlayerController* Controller = PlayerController.Get())
+    {
+        Controller->PrimaryActorTick.RemovePrerequisite(this, ReplayTickFunction);
+
+        if (AFPSCharacter* ReplayCharacter = Character.Get())
+        {
+            ReplayCharacter->EnableInput(Controller);
+        }
+    }
+    ReplayTickFunction.UnRegisterTickFunction();
+    RestoreTimeStepSettings();
+
+    const uint64 Frames = Reader.GetFramesRead();
+    const double SimSeconds = Frames * Reader.GetHeader().FixedStep;
+    const double WallSeconds = FPlatformTime::Seconds() - ReplayStartWallTime;
+    UE_LOG(LogFPSDemo, Display, TEXT("InputReplay: replayed %llu/%llu frames (%.1fs simulated) in %.2fs wall, %.3f ms/frame"),
+        Frames, Reader.GetHeader().FrameCount, SimSeconds, WallSeconds, Frames > 0 ? WallSeconds * 1000.0 / Frames : 0.0);
+
+    Reader.Close();
+    Character.Reset();
+    PlayerController.Reset();
+    Mode = EMode::None;
+
+    if (bExitWhenDone)
+    {
+        FPlatformMisc::RequestExit(false, TEXT("FPSInputReplay"));
+    }
+}
+
+// ------------------------------------------------------------------
+// 引擎时间步设置
+// ------------------------------------------------------------------
+void UFPSInputReplaySubsystem::SaveTimeStepSettings()
+{
+    bSavedUseFixedFrameRate = GEngine->bUseFixedFrameRate;
+    SavedFixedFrameRate = GEngine->FixedFrameRate;
+    bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+    SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+    bSavedBenchmarking = FApp::IsBenchmarking();
+}
+
+void UFPSInputReplaySubsystem::RestoreTimeStepSettings()
+{
+    GEngine->bUseFixedFrameRate = bSavedUseFixedFrameRate;
+    GEngine->FixedFrameRate = SavedFixedFrameRate;
+    FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+    FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+    FApp::SetBenchmarking(bSavedBenchmarking);
+}
@@ -0,0 +1,138 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineBaseTypes.h"
+#include "FPSInput/FPSInputRecording.h"
+#include "FPSInputReplaySubsystem.generated.h"
+
+class AFPSCharacter;
+class APlayerController;
+class UFPSInputReplaySubsystem;
+struct FInputActionValue;
+
+/**
+ * 回放输入的 Tick 函数。
+ * 作为本地玩家控制器 Tick 的前置条件，在控制器处理输入之前注入录制的输入，
+ * 使回放的输入与实时输入在帧内的时机完全相同。
+ */
+USTRUCT()
+struct FFPSInputReplayTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    UFPSInputReplaySubsystem* Target = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FFPSInputReplayTickFunction> : public TStructOpsTypeTraitsBase2<FFPSInputReplayTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * UFPSInputReplaySubsystem
+ * 录制本地玩家角色的输入（Move / Look / StartJump / StopJump / Shoot），并可在无界面模式下通过同一组处理函数回放，
+ * 用于得到可重复的游戏过程，作为性能回归测试与分析的基准。
+ *
+ * 录制与回放都使用固定步长，并在开始时记录/恢复角色位置、朝向与随机数种子。
+ * 录制文件见 FFPSInputRecordWriter；回放以内存映射窗口流式读取，不会把整个文件读入内存。
+ *
+ * 命令行：
+ *   录制：-FPSRecordInput[=Saved/InputRecordings/Run.fpsinput]
+ *   回放：-FPSReplayInput=Saved/InputRecordings/Run.fpsinput（-nullrhi 下以最快速度运行，结束后退出，加 -ReplayNoExit 可保留）
+ * 控制台：fps.Input.Record [路径]、fps.Input.StopRecord、fps.Input.Replay 路径、fps.Input.StopReplay
+ */
+UCLASS()
+class FPSDEMO_API UFPSInputReplaySubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /* 开始录制本地玩家角色，角色尚未生成时等待其生成 */
+    bool StartRecording(const FString& Filename);
+    void StopRecording();
+
+    /* 开始回放到本地玩家角色 */
+    bool StartReplay(const FString& Filename, bool bInExitWhenDone = false);
+    void StopReplay();
+
+    bool IsRecording() const { return Mode == EMode::Recording; }
+    bool IsReplaying() const { return Mode == EMode::Replaying; }
+
+    /* 由 AFPSCharacter 的输入处理函数调用，记录到本帧 */
+    void CaptureInput(EFPSInputChannel Channel, const FInputActionValue& Value);
+
+    /* 默认的录制文件路径（Saved/InputRecordings/Input_<时间>.fpsinput） */
+    static FString MakeDefaultRecordingPath();
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    friend struct FFPSInputReplayTickFunction;
+
+    enum class EMode : uint8
+    {
+        None,
+        PendingRecord,
+        Recording,
+        PendingReplay,
+        Replaying,
+    };
+
+    /* 本地玩家控制的角色 */
+    AFPSCharacter* FindLocalCharacter(APlayerController*& OutController) const;
+
+    /* 角色就绪后真正开始（均在帧末调用，录制/回放从下一帧开始） */
+    bool BeginRecording(AFPSCharacter* InCharacter, APlayerController* InController);
+    bool BeginReplay(AFPSCharacter* InCharacter, APlayerController* InController);
+
+    /* 回放一帧（由 ReplayTickFunction 调用） */
+    void ReplayFrame();
+
+    /* 固定步长的设置与恢复 */
+    void SaveTimeStepSettings();
+    void RestoreTimeStepSettings();
+
+    EMode Mode = EMode::None;
+    FString PendingFilename;
+
+    FFPSInputRecordWriter Writer;
+    FFPSInputReplayReader Reader;
+
+    /* 本帧已捕获的输入 */
+    FFPSInputFrame CapturedFrame;
+
+    TWeakObjectPtr<AFPSCharacter> Character;
+    TWeakObjectPtr<APlayerController> PlayerController;
+
+    FFPSInputReplayTickFunction ReplayTickFunction;
+
+    /* 回放读完（在 Tick 函数中置位，于帧末停止） */
+    bool bReplayFinished = false;
+    bool bExitWhenDone = false;
+    double ReplayStartWallTime = 0.0;
+
+    /* 开始前的引擎时间步设置 */
+    bool bSavedUseFixedFrameRate = false;
+    float SavedFixedFrameRate = 0.0f;
+    bool bSavedUseFixedTimeStep = false;
+    double SavedFixedDeltaTime = 0.0;
+    bool bSavedBenchmarking = false;
+};
@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/FPSFireBatch.h"
+#include "Engine/NetSerialization.h"
+
+namespace FPSFireBatch
+{
+    /* 时间偏移单位：0.1 毫秒 */
+    static constexpr double TimeOffsetScale = 10000.0;
+
+    /* 与 SerializePackedVector<10, N> 相同的 0.1cm 量化；发送端先量化，保证差值在两端累加结果一致 */
+    static FVector QuantizeOrigin(const FVector& Origin)
+    {
+        return FVector(FMath::RoundToDouble(Origin.X * 10.0), FMath::RoundToDouble(Origin.Y * 10.0), FMath::RoundToDouble(Origin.Z * 10.0)) / 10.0;
+    }
+}
+
+bool FFPSFireBatch::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+
+    uint32 NumShots = Shots.Num();
+    Ar.SerializeInt(NumShots, MaxShots + 1);
+
+    if (Ar.IsLoading())
+    {
+        Shots.SetNum(FMath::Min<int32>(NumShots, MaxShots));
+    }
+
+    double BaseTime = 0.0;
+    FVector PreviousOrigin = FVector::ZeroVector;
+
+    // 发送时只读取 Shots，量化结果放在局部变量中；接收时写回
+    for (int32 Index = 0; Index < Shots.Num(); ++Index)
+    {
+        FFPSNetShot& Shot = Shots[Index];
+
+        // 时间：首发写完整的 double（服务器运行数小时后 float 只剩毫秒级精度，会让延迟补偿的回溯时间偏移），
+        // 其余写相对首发的偏移
+        if (Index == 0)
+        {
+            double Time = Shot.ServerTime;
+            Ar << Time;
+            BaseTime = Time;
+            if (Ar.IsLoading())
+            {
+                Shot.ServerTime = Time;
+            }
+        }
+        else
+        {
+            uint16 Offset = Ar.IsSaving()
+                ? static_cast<uint16>(FMath::Clamp(FMath::RoundToDouble((Shot.ServerTime - BaseTime) * FPSFireBatch::TimeOffsetScale), 0.0, static_cast<double>(MAX_uint16)))
+                : 0;
+            Ar << Offset;
+            if (Ar.IsLoading())
+            {
+                Shot.ServerTime = BaseTime + Offset / FPSFireBatch::TimeOffsetScale;
+            }
+        }
+
+        // 起点：首发写绝对位置，其余写相对上一发（量化后）的差值，两端按相同的量化结果累加
+        FVector Origin = Ar.IsSaving() ? FPSFireBatch::QuantizeOrigin(Shot.Origin) : FVector::ZeroVector;
+        if (Index == 0)
+        {
+            bOutSuccess &= SerializePackedVector<10, 24>(Origin, Ar);
+        }
+        else
+        {
+            FVector Delta = Origin - PreviousOrigin;
+            bOutSuccess &= SerializePackedVector<10, 16>(Delta, Ar);
+            Origin = PreviousOrigin + Delta;
+        }
+        PreviousOrigin = Origin;
+
+        // 方向：俯仰 + 偏航
+        const FRotator Rotation = Ar.IsSaving() ? Shot.Direction.Rotation() : FRotator::ZeroRotator;
+        uint16 Pitch = FRotator::CompressAxisToShort(Rotation.Pitch);
+        uint16 Yaw = FRotator::CompressAxisToShort(Rotation.Yaw);
+        Ar << Pitch;
+        Ar << Yaw;
+
+        if (Ar.IsLoading())
+        {
+            Shot.Origin = Origin;
+            Shot.Direction = FRotator(FRotator::DecompressAxisFromShort(Pitch), FRotator::DecompressAxisFromShort(Yaw), 0.0f).Vector();
+        }
+    }
+
+    return true;
+}
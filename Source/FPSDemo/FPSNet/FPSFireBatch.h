@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPSFireBatch.generated.h"
+
+/**
+ * 网络传输的一发射击：起点、方向与开火时间（服务器世界时间）。
+ * 结构体中保存完整精度的值，量化只发生在 FFPSFireBatch::NetSerialize 中（发送时不修改结构体）。
+ */
+struct FFPSNetShot
+{
+    FVector Origin = FVector::ZeroVector;
+    FVector Direction = FVector::ForwardVector;
+    double ServerTime = 0.0;
+};
+
+/**
+ * FFPSFireBatch
+ * 一次 RPC 发送的一批射击。
+ *
+ * 量化方案（典型每发 6~8 字节）：
+ *   - 数量：按 MaxShots 上限的位宽写入
+ *   - 时间：首发写 double 秒（延迟补偿按它回溯，长时间运行也保持亚毫秒精度），其余写相对首发的 0.1ms 偏移（uint16）
+ *   - 起点：首发 0.1cm 精度打包向量，其余写相对上一发的差值（同一帧内位移很小，打包后只占几位）
+ *   - 方向：俯仰/偏航各压缩为 uint16（约 0.0055°）
+ */
+USTRUCT()
+struct FPSDEMO_API FFPSFireBatch
+{
+    GENERATED_BODY()
+
+    /* 单批最多的射击数量，与开火调度器的单帧上限一致 */
+    static constexpr int32 MaxShots = 64;
+
+    TArray<FFPSNetShot, TInlineAllocator<8>> Shots;
+
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FFPSFireBatch> : public TStructOpsTypeTraitsBase2<FFPSFireBatch>
+{
+    enum
+    {
+        WithNetSerializer = true,
+    };
+};
@@ -0,0 +1,228 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/FPSLagCompensationSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarLagCompEnable(
+    TEXT("fps.LagComp.Enable"),
+    1,
+    TEXT("1：服务器按射手延迟回溯角色命中盒校验即时命中射击；0：关闭。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompMaxRewindMs(
+    TEXT("fps.LagComp.MaxRewindMs"),
+    300.0f,
+    TEXT("最大回溯时间（毫秒），超过的部分按该值处理，防止高延迟玩家命中很久之前的位置。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompInterpDelayMs(
+    TEXT("fps.LagComp.InterpDelayMs"),
+    0.0f,
+    TEXT("客户端显示其他角色时的插值延迟（毫秒），计入回溯时间。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarLagCompSyntheticLatencyMs(
+    TEXT("fps.LagComp.SyntheticLatencyMs"),
+    0.0f,
+    TEXT("测试用：在每个射手的实测延迟上额外增加的回溯时间（毫秒）。"),
+    ECVF_Cheat);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.LagComp.Test [LatencyMs=100] [Iterations=1000]
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorldAndArgs GLagCompTestCommand(
+    TEXT("fps.LagComp.Test"),
+    TEXT("在合成延迟下对每个角色做回溯射线检测并统计耗时。参数：[延迟ms=100] [次数=1000]"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+    {
+        UFPSLagCompensationSubsystem* LagComp = World ? World->GetSubsystem<UFPSLagCompensationSubsystem>() : nullptr;
+        if (!LagComp)
+        {
+            return;
+        }
+
+        const float LatencyMs = Args.Num() > 0 ? FCString::Atof(*Args[0]) : 100.0f;
+        const int32 Iterations = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 1000;
+        LagComp->RunSyntheticLatencyTest(LatencyMs, FMath::Max(Iterations, 1));
+    }));
+
+bool UFPSLagCompensationSubsystem::IsLagCompensationEnabled()
+{
+    return CVarLagCompEnable.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSLagCompensationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSLagCompensationSubsystem::Deinitialize()
+{
+    Characters.Empty();
+    Super::Deinitialize();
+}
+
+TStatId UFPSLagCompensationSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSLagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSLagCompensationSubsystem::RegisterCharacter(AFPSCharacter* Character)
+{
+    if (Character)
+    {
+        Characters.AddUnique(Character);
+    }
+}
+
+void UFPSLagCompensationSubsystem::UnregisterCharacter(AFPSCharacter* Character)
+{
+    Characters.RemoveSingleSwap(Character, EAllowShrinking::No);
+}
+
+// ------------------------------------------------------------------
+// 每帧末（所有 Actor 与物理更新之后）记录一次快照
+// ------------------------------------------------------------------
+void UFPSLagCompensationSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (Characters.Num() == 0 || !IsLagCompensationEnabled())
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSLagCompRecord);
+
+    const double Now = GetWorld()->GetTimeSeconds();
+    for (AFPSCharacter* Character : Characters)
+    {
+        if (Character)
+        {
+            Character->RecordHitboxSnapshot(Now);
+        }
+    }
+}
+
+double UFPSLagCompensationSubsystem::GetRewindTime(const APawn* Shooter) const
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    if (!Shooter || Shooter->IsLocallyControlled())
+    {
+        return Now;
+    }
+
+    const APlayerState* PlayerState = Shooter->GetPlayerState();
+    const double RoundTripMs = PlayerState ? PlayerState->GetPingInMilliseconds() : 0.0;
+    const double RewindMs = RoundTripMs + CVarLagCompInterpDelayMs.GetValueOnGameThread() + CVarLagCompSyntheticLatencyMs.GetValueOnGameThread();
+
+    return Now - FMath::Clamp(RewindMs, 0.0, static_cast<double>(CVarLagCompMaxRewindMs.GetValueOnGameThread())) / 1000.0;
+}
+
+// ------------------------------------------------------------------
+// 回溯射线检测：逐角色粗筛包围球，再检测命中盒，耗时与角色数 × 命中盒数成正比
+// ------------------------------------------------------------------
+bool UFPSLagCompensationSubsystem::RewindLineTrace(const FVector& Start, const FVector& End, double RewindTime, const AActor* IgnoreActor, FFPSRewindHit& OutHit) const
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSLagCompQuery);
+
+    FVector Direction;
+    double MaxDistance;
+    (End - Start).ToDirectionAndLength(Direction, MaxDistance);
+    if (MaxDistance <= UE_SMALL_NUMBER)
+    {
+        return false;
+    }
+
+    bool bHit = false;
+    for (AFPSCharacter* Character : Characters)
+    {
+        if (!Character || Character == IgnoreActor)
+        {
+            continue;
+        }
+
+        double Distance;
+        int32 HitboxIndex;
+        if (Character->GetHitboxHistory().Raycast(RewindTime, Start, Direction, MaxDistance, Distance, HitboxIndex))
+        {
+            // 后续角色只需检测更近的距离
+            MaxDistance = Distance;
+            bHit = true;
+
+            OutHit.Character = Character;
+            OutHit.HitboxIndex = HitboxIndex;
+            OutHit.BoneName = Character->GetHitboxBoneName(HitboxIndex);
+            OutHit.Distance = Distance;
+            OutHit.Location = Start + Direction * Distance;
+        }
+    }
+
+    return bHit;
+}
+
+// ------------------------------------------------------------------
+// 测试：瞄准每个角色在“LatencyMs 之前”的胶囊体中心开火，
+// 对比回溯检测与直接使用最新快照的检测结果，并统计回溯检测的平均耗时
+// ------------------------------------------------------------------
+void UFPSLagCompensationSubsystem::RunSyntheticLatencyTest(float LatencyMs, int32 Iterations)
+{
+    const double Now = GetWorld()->GetTimeSeconds();
+    const double RewindTime = Now - LatencyMs / 1000.0;
+    static constexpr double ShotDistance = 1000.0;
+
+    int32 NumTargets = 0;
+    int32 NumRewindHits = 0;
+    int32 NumLiveHits = 0;
+    double TotalQuerySeconds = 0.0;
+    int32 NumQueries = 0;
+
+    for (AFPSCharacter* Target : Characters)
+    {
+        FHitboxSnapshot Snapshot;
+        if (!Target || !Target->GetHitboxHistory().Sample(RewindTime, Snapshot))
+        {
+            continue;
+        }
+        ++NumTargets;
+
+        // 射手位于目标前方，瞄准目标回溯位置的胶囊体中心；只统计最近命中为目标本身的次数
+        const FVector Aim = Snapshot.CapsuleCenter;
+        const FVector Start = Aim + Target->GetActorForwardVector() * ShotDistance;
+        const FVector End = Aim - Target->GetActorForwardVector() * ShotDistance;
+
+        FFPSRewindHit RewindHit;
+        if (RewindLineTrace(Start, End, RewindTime, nullptr, RewindHit) && RewindHit.Character == Target)
+        {
+            ++NumRewindHits;
+        }
+
+        FFPSRewindHit LiveHit;
+        if (RewindLineTrace(Start, End, Now, nullptr, LiveHit) && LiveHit.Character == Target)
+        {
+            ++NumLiveHits;
+        }
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            FFPSRewindHit Hit;
+            RewindLineTrace(Start, End, RewindTime, nullptr, Hit);
+        }
+        TotalQuerySeconds += FPlatformTime::Seconds() - StartSeconds;
+        NumQueries += Iterations;
+    }
+
+    UE_LOG(LogFPSDemo, Display, TEXT("LagComp test: latency=%.0fms targets=%d rewound hits=%d/%d unrewound hits=%d/%d avg query=%.3fus (%d characters, history %d x %d bytes each)"),
+        LatencyMs, NumTargets, NumRewindHits, NumTargets, NumLiveHits, NumTargets,
+        NumQueries > 0 ? TotalQuerySeconds * 1.0e6 / NumQueries : 0.0,
+        Characters.Num(), FHitboxHistory::Capacity, static_cast<int32>(sizeof(FHitboxSnapshot)));
+}
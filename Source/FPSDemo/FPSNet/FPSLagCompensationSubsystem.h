@@ -0,0 +1,73 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSLagCompensationSubsystem.generated.h"
+
+class AFPSCharacter;
+
+/* 一次回溯射线检测的结果 */
+struct FFPSRewindHit
+{
+    AFPSCharacter* Character = nullptr;
+
+    /* 命中的命中盒序号，INDEX_NONE 表示胶囊体 */
+    int32 HitboxIndex = INDEX_NONE;
+    FName BoneName;
+
+    FVector Location = FVector::ZeroVector;
+    double Distance = 0.0;
+};
+
+/**
+ * UFPSLagCompensationSubsystem
+ * 服务器端延迟补偿：每帧末记录所有角色的胶囊体与命中盒快照（保存在各角色的 FHitboxHistory 中），
+ * 校验射击时把目标回溯到射手开火时看到的时间（当前时间 - 往返延迟 - 插值延迟），
+ * 在插值快照上做解析射线检测，不移动任何组件，也不查询物理场景。
+ *
+ * 测试：服务器上执行 fps.LagComp.Test [延迟ms] [次数]，对每个角色在合成延迟下分别做回溯与不回溯的检测并统计耗时；
+ * 本机多客户端测试时可配合 NetEmulation.PktLag 与 fps.LagComp.SyntheticLatencyMs。
+ */
+UCLASS()
+class FPSDEMO_API UFPSLagCompensationSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /* 是否启用（fps.LagComp.Enable） */
+    static bool IsLagCompensationEnabled();
+
+    /* 角色在服务器上开始/结束参与延迟补偿 */
+    void RegisterCharacter(AFPSCharacter* Character);
+    void UnregisterCharacter(AFPSCharacter* Character);
+
+    /**
+     * 射手开火时所看到的世界时间：当前时间减去往返延迟与插值延迟，最多回溯 fps.LagComp.MaxRewindMs。
+     * 非玩家控制（AI、本地玩家）返回当前时间。
+     */
+    double GetRewindTime(const APawn* Shooter) const;
+
+    /**
+     * 在 RewindTime 时刻的角色快照上做射线检测，返回最近的命中。
+     * @param IgnoreActor 通常为射手自身
+     */
+    bool RewindLineTrace(const FVector& Start, const FVector& End, double RewindTime, const AActor* IgnoreActor, FFPSRewindHit& OutHit) const;
+
+    /* 测试：对每个角色在合成延迟下做回溯检测，输出命中结果与平均耗时 */
+    void RunSyntheticLatencyTest(float LatencyMs, int32 Iterations);
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AFPSCharacter>> Characters;
+};
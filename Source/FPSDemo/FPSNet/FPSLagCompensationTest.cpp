@@ -0,0 +1,216 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/FPSLagCompensationSubsystem.h"
+#include "FPSNet/HitboxHistory.h"
+#include "FPSWeapon/HitscanTraceSubsystem.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerStart.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace FPSLagCompensationTest
+{
+    constexpr const TCHAR* MapName = TEXT("/Game/001_Maps/FPSMap");
+
+    /* 生成后等待角色落地、历史记录填充的帧数 */
+    constexpr int32 SettleFrames = 30;
+
+    /* 目标移动后、开火前经过的帧数；必须小于 FHitboxHistory::Capacity，回溯时间才仍在历史范围内 */
+    constexpr int32 MovedFrames = 5;
+
+    /* 等待即时命中结果与命中事件排出的最长帧数 */
+    constexpr int32 ResultFrames = 10;
+
+    /* 射击起点到目标原位置的距离，以及目标朝射手移动的距离：移动后的胶囊体正好挡在原位置之前 */
+    constexpr double ShotDistance = 600.0;
+    constexpr double MoveDistance = 300.0;
+
+    /**
+     * 生成一个目标角色，记下它在某一帧的命中盒位置后让它沿射线朝射手方向移动，
+     * 几帧之后以该帧为回溯时间，沿同一条射线经 UHitscanTraceSubsystem 开火：
+     * 应当命中回溯后的命中盒（原位置），而不是挡在前面的当前胶囊体。
+     */
+    class FMovedTargetCommand : public IAutomationLatentCommand
+    {
+    public:
+        explicit FMovedTargetCommand(FAutomationTestBase* InTest)
+            : Test(InTest)
+        {
+        }
+
+        virtual bool Update() override
+        {
+            UWorld* World = AutomationCommon::GetAnyGameWorld();
+            if (!World)
+            {
+                Test->AddError(FString::Printf(TEXT("No game world after loading %s"), MapName));
+                return true;
+            }
+
+            ++Frame;
+
+            if (!Target.IsValid())
+            {
+                if (Frame > 1)
+                {
+                    Test->AddError(TEXT("Target character was destroyed"));
+                    return Finish();
+                }
+                return !SpawnTarget(*World);
+            }
+
+            if (Frame == SettleFrames)
+            {
+                return !MoveTarget();
+            }
+
+            if (Frame == SettleFrames + MovedFrames)
+            {
+                UHitscanTraceSubsystem* Hitscan = World->GetSubsystem<UHitscanTraceSubsystem>();
+                UFPSHitEventSubsystem* HitEvents = World->GetSubsystem<UFPSHitEventSubsystem>();
+                if (!Hitscan || !HitEvents)
+                {
+                    Test->AddError(TEXT("Hitscan or hit event subsystem is missing"));
+                    return Finish();
+                }
+
+                BatchHandle = HitEvents->OnBatch(EFPSHitEventPhase::Analytics).AddRaw(this, &FMovedTargetCommand::OnBatch);
+
+                FHitscanShotParams Params;
+                Params.RewindTime = RewindTime;
+                Hitscan->QueueShot(nullptr, ShotStart, FVector::ForwardVector, Params);
+                return false;
+            }
+
+            if (Frame < SettleFrames + MovedFrames + ResultFrames && !bGotHit)
+            {
+                return false;
+            }
+
+            if (!bGotHit)
+            {
+                Test->AddError(TEXT("Rewound shot did not hit the target"));
+                return Finish();
+            }
+
+            // 命中点应在原位置附近，而不是移动后胶囊体的正面
+            const double HitDistance = HitLocation.X - ShotStart.X;
+            Test->AddInfo(FString::Printf(TEXT("Rewound hit at %.1fcm (%s), rewound target at %.0fcm, live target at %.0fcm"),
+                HitDistance, *HitBone.ToString(), ShotDistance, ShotDistance - MoveDistance));
+            Test->TestTrue(TEXT("Shot resolved on the rewound hitbox, not the live capsule"), HitDistance > ShotDistance - MoveDistance * 0.5);
+            return Finish();
+        }
+
+    private:
+        bool SpawnTarget(UWorld& World)
+        {
+            FVector Origin(0.0f, 0.0f, 200.0f);
+            for (TActorIterator<APlayerStart> It(&World); It; ++It)
+            {
+                Origin = It->GetActorLocation();
+                break;
+            }
+
+            // 避开玩家出生点上的角色
+            FActorSpawnParameters SpawnParams;
+            SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+            Target = World.SpawnActor<AFPSCharacter>(AFPSCharacter::StaticClass(), Origin + FVector(ShotDistance, 400.0f, 0.0f), FRotator::ZeroRotator, SpawnParams);
+            if (!Target.IsValid())
+            {
+                Test->AddError(TEXT("Failed to spawn the target character"));
+                return false;
+            }
+            return true;
+        }
+
+        bool MoveTarget()
+        {
+            AFPSCharacter* Character = Target.Get();
+            const FHitboxHistory& History = Character->GetHitboxHistory();
+
+            // 以已记录的最新一帧为回溯时间，瞄准该帧的第一个命中盒（未配置命中盒时瞄准胶囊体中心）
+            FHitboxSnapshot Snapshot;
+            if (!UFPSLagCompensationSubsystem::IsLagCompensationEnabled() || !History.Sample(History.GetNewestTime(), Snapshot))
+            {
+                Test->AddError(TEXT("Target has no hitbox history, check fps.LagComp.Enable"));
+                Finish();
+                return false;
+            }
+
+            RewindTime = Snapshot.Time;
+            const FVector AimPoint = Snapshot.CapsuleCenter + (History.GetNumHitboxes() > 0 ? FVector(Snapshot.HitboxOffsets[0]) : FVector::ZeroVector);
+            ShotStart = AimPoint - FVector::ForwardVector * ShotDistance;
+
+            Character->SetActorLocation(Character->GetActorLocation() - FVector::ForwardVector * MoveDistance, false, nullptr, ETeleportType::TeleportPhysics);
+            return true;
+        }
+
+        void OnBatch(const FFPSHitEventBatch& Batch)
+        {
+            for (const FFPSHitEvent& Event : Batch.GetEvents(EFPSHitEventKind::CharacterHit))
+            {
+                if (Event.Source == EFPSHitEventSource::Hitscan && Event.HitActor.Get() == Target.Get() && !bGotHit)
+                {
+                    bGotHit = true;
+                    HitLocation = Event.Location;
+                    HitBone = Event.BoneName;
+                }
+            }
+        }
+
+        bool Finish()
+        {
+            if (UWorld* World = AutomationCommon::GetAnyGameWorld())
+            {
+                if (UFPSHitEventSubsystem* HitEvents = World->GetSubsystem<UFPSHitEventSubsystem>())
+                {
+                    HitEvents->OnBatch(EFPSHitEventPhase::Analytics).Remove(BatchHandle);
+                }
+            }
+
+            if (AFPSCharacter* Character = Target.Get())
+            {
+                if (AController* Controller = Character->GetController())
+                {
+                    Controller->Destroy();
+                }
+                Character->Destroy();
+            }
+            Target.Reset();
+            return true;
+        }
+
+        FAutomationTestBase* Test;
+        TWeakObjectPtr<AFPSCharacter> Target;
+        int32 Frame = 0;
+        double RewindTime = 0.0;
+        FVector ShotStart = FVector::ZeroVector;
+        FDelegateHandle BatchHandle;
+        bool bGotHit = false;
+        FVector HitLocation = FVector::ZeroVector;
+        FName HitBone;
+    };
+}
+
+// ------------------------------------------------------------------
+// 目标在射击之后移开：延迟补偿的即时命中应命中回溯后的命中盒，而不是当前位置的胶囊体。
+//   UnrealEditor FPSDemo.uproject -game -nullrhi -unattended
+//       -ExecCmds="Automation RunTests FPSDemo.LagCompensation.MovedTarget; Quit"
+// ------------------------------------------------------------------
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFPSLagCompensationMovedTargetTest, "FPSDemo.LagCompensation.MovedTarget",
+    EAutomationTestFlags::ClientContext | EAutomationTestFlags::ServerContext | EAutomationTestFlags::ProductFilter)
+
+bool FFPSLagCompensationMovedTargetTest::RunTest(const FString& Parameters)
+{
+    AutomationOpenMap(FPSLagCompensationTest::MapName);
+    ADD_LATENT_AUTOMATION_COMMAND(FPSLagCompensationTest::FMovedTargetCommand(this));
+    return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,160 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/FPSNetStatsSubsystem.h"
+#include "FPSNet/FPSFireBatch.h"
+#include "FPSDemo.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/CoreNet.h"
+
+static TAutoConsoleVariable<float> CVarNetStatsInterval(
+    TEXT("fps.Net.StatsInterval"),
+    0.0f,
+    TEXT("每隔多少秒输出一次各连接的带宽统计，0 表示关闭（仍可用 fps.Net.Stats 手动输出）。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Net.Stats
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GNetStatsCommand(
+    TEXT("fps.Net.Stats"),
+    TEXT("输出各网络连接的带宽、丢包、延迟与开火批次统计。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (UFPSNetStatsSubsystem* NetStats = World ? World->GetSubsystem<UFPSNetStatsSubsystem>() : nullptr)
+        {
+            NetStats->LogStats();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSNetStatsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSNetStatsSubsystem::Deinitialize()
+{
+    FireStats.Empty();
+    Super::Deinitialize();
+}
+
+TStatId UFPSNetStatsSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSNetStatsSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSNetStatsSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const float Interval = CVarNetStatsInterval.GetValueOnGameThread();
+    if (Interval <= 0.0f || GetWorld()->GetNetMode() == NM_Standalone)
+    {
+        return;
+    }
+
+    SecondsSinceLog += DeltaTime;
+    if (SecondsSinceLog >= Interval)
+    {
+        SecondsSinceLog = 0.0;
+        LogStats();
+    }
+}
+
+// ------------------------------------------------------------------
+// 记录开火批次：重新序列化一次以得到实际载荷位数（不含 RPC 头）
+// ------------------------------------------------------------------
+void UFPSNetStatsSubsystem::RecordFireBatch(UNetConnection* Connection, const FFPSFireBatch& Batch, int32 NumRejected)
+{
+    if (!Connection)
+    {
+        return;
+    }
+
+    // 发送方向的序列化只读取批次
+    FNetBitWriter Writer(nullptr, 0);
+    bool bSuccess = true;
+    const_cast<FFPSFireBatch&>(Batch).NetSerialize(Writer, nullptr, bSuccess);
+
+    FFPSConnectionFireStats& Stats = FireStats.FindOrAdd(Connection);
+    ++Stats.Batches;
+    Stats.Shots += Batch.Shots.Num();
+    Stats.PayloadBits += Writer.GetNumBits();
+    Stats.RejectedShots += NumRejected;
+}
+
+// ------------------------------------------------------------------
+// 记录组播开火批次：载荷只计算一次，按发往与被裁剪的连接数累加
+// ------------------------------------------------------------------
+void UFPSNetStatsSubsystem::RecordFireMulticast(const FFPSFireBatch& Batch, int32 NumRecipients, int32 NumConnections)
+{
+    FNetBitWriter Writer(nullptr, 0);
+    bool bSuccess = true;
+    const_cast<FFPSFireBatch&>(Batch).NetSerialize(Writer, nullptr, bSuccess);
+
+    const int32 NumCulled = FMath::Max(NumConnections - NumRecipients, 0);
+    ++MulticastStats.Batches;
+    MulticastStats.Shots += Batch.Shots.Num();
+    MulticastStats.Recipients += NumRecipients;
+    MulticastStats.Culled += NumCulled;
+    MulticastStats.SentBits += Writer.GetNumBits() * NumRecipients;
+    MulticastStats.SavedBits += Writer.GetNumBits() * NumCulled;
+}
+
+void UFPSNetStatsSubsystem::LogStats()
+{
+    const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+    if (!NetDriver)
+    {
+        return;
+    }
+
+    auto LogConnection = [this](UNetConnection* Connection)
+    {
+        const APlayerController* PC = Connection->PlayerController;
+        UE_LOG(LogFPSDemo, Log, TEXT("NetStats: %s (%s) Out=%d B/s (%d pkt/s, lost %d) In=%d B/s (%d pkt/s, lost %d) Ping=%.1fms"),
+            *Connection->LowLevelGetRemoteAddress(true),
+            PC ? *PC->GetName() : TEXT("-"),
+            Connection->OutBytesPerSecond, Connection->OutPacketsPerSecond, Connection->OutPacketsLost,
+            Connection->InBytesPerSecond, Connection->InPacketsPerSecond, Connection->InPacketsLost,
+            Connection->AvgLag * 1000.0f);
+
+        if (const FFPSConnectionFireStats* Stats = FireStats.Find(Connection))
+        {
+            UE_LOG(LogFPSDemo, Log, TEXT("NetStats:   FireBatches=%u Shots=%u Rejected=%u AvgBytesPerShot=%.2f"),
+                Stats->Batches, Stats->Shots, Stats->RejectedShots,
+                Stats->Shots > 0 ? Stats->PayloadBits / 8.0 / Stats->Shots : 0.0);
+        }
+    };
+
+    if (NetDriver->ServerConnection)
+    {
+        LogConnection(NetDriver->ServerConnection);
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("NetStats: %d client connection(s)"), NetDriver->ClientConnections.Num());
+    for (UNetConnection* Connection : NetDriver->ClientConnections)
+    {
+        if (Connection)
+        {
+            LogConnection(Connection);
+        }
+    }
+
+    if (MulticastStats.Batches > 0)
+    {
+        UE_LOG(LogFPSDemo, Log, TEXT("NetStats: FireMulticast Batches=%u Shots=%u Recipients=%u Culled=%u Sent=%.1fKB Saved=%.1fKB"),
+            MulticastStats.Batches, MulticastStats.Shots, MulticastStats.Recipients, MulticastStats.Culled,
+            MulticastStats.SentBits / 8.0 / 1024.0, MulticastStats.SavedBits / 8.0 / 1024.0);
+    }
+
+    // 开火计数按周期统计；顺带清理已断开的连接
+    FireStats.Reset();
+    MulticastStats = FFPSFireMulticastStats();
+}
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSNetStatsSubsystem.generated.h"
+
+class UNetConnection;
+struct FFPSFireBatch;
+
+/* 单个连接上收到的开火批次统计（服务器端） */
+struct FFPSConnectionFireStats
+{
+    uint32 Batches = 0;
+    uint32 Shots = 0;
+    uint64 PayloadBits = 0;
+    uint32 RejectedShots = 0;
+};
+
+/* 服务器组播的开火批次统计：发往的连接数与因距离被裁剪的连接数 */
+struct FFPSFireMulticastStats
+{
+    uint32 Batches = 0;
+    uint32 Shots = 0;
+    uint32 Recipients = 0;
+    uint32 Culled = 0;
+    uint64 SentBits = 0;
+    uint64 SavedBits = 0;
+};
+
+/**
+ * UFPSNetStatsSubsystem
+ * 按连接统计网络带宽：每隔 fps.Net.StatsInterval 秒输出一次各连接的收发字节/包速率、丢包与延迟，
+ * 服务器端还会附带该连接上开火批次的数量、射击数与平均每发占用的字节数，
+ * 以及组播开火批次按裁剪距离发出与省下的载荷字节数。
+ * 也可随时通过控制台命令 fps.Net.Stats 输出。
+ */
+UCLASS()
+class FPSDEMO_API UFPSNetStatsSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    /* 服务器收到一批射击时调用 */
+    void RecordFireBatch(UNetConnection* Connection, const FFPSFireBatch& Batch, int32 NumRejected);
+
+    /**
+     * 服务器组播一批射击时调用（由复制图在发送前统计）。
+     * @param NumRecipients  在裁剪距离内、实际发往的连接数
+     * @param NumConnections 所有客户端连接数
+     */
+    void RecordFireMulticast(const FFPSFireBatch& Batch, int32 NumRecipients, int32 NumConnections);
+
+    /* 输出所有连接的统计，并清零本周期的开火计数 */
+    void LogStats();
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    TMap<TWeakObjectPtr<UNetConnection>, FFPSConnectionFireStats> FireStats;
+    FFPSFireMulticastStats MulticastStats;
+
+    double SecondsSinceLog = 0.0;
+};
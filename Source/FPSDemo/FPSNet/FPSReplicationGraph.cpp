@@ -0,0 +1,412 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/FPSReplicationGraph.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSNet/FPSNetStatsSubsystem.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetConnection.h"
+#include "Engine/NetDriver.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "HAL/IConsoleManager.h"
+#include "Algo/AnyOf.h"
+#include "UObject/UObjectIterator.h"
+
+static TAutoConsoleVariable<float> CVarRepGraphLogInterval(
+    TEXT("fps.RepGraph.LogInterval"),
+    0.0f,
+    TEXT("每隔多少秒输出一次 ServerReplicateActors 的平均/最大耗时与连接数，0 表示关闭。"),
+    ECVF_Default);
+
+// ==================================================================
+// UFPSReplicationGraphNode_CharacterGrid
+// ==================================================================
+
+UFPSReplicationGraphNode_CharacterGrid::UFPSReplicationGraphNode_CharacterGrid()
+{
+    bRequiresPrepareForReplicationCall = true;
+}
+
+void UFPSReplicationGraphNode_CharacterGrid::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+    Characters.Add(ActorInfo.Actor);
+}
+
+bool UFPSReplicationGraphNode_CharacterGrid::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+    return Characters.RemoveFast(ActorInfo.Actor);
+}
+
+void UFPSReplicationGraphNode_CharacterGrid::NotifyResetAllNetworkActors()
+{
+    Characters.Reset();
+    Cells.Reset();
+}
+
+FIntPoint UFPSReplicationGraphNode_CharacterGrid::GetCell(const FVector& Location) const
+{
+    return FIntPoint(FMath::FloorToInt32(Location.X / CellSize), FMath::FloorToInt32(Location.Y / CellSize));
+}
+
+// ------------------------------------------------------------------
+// 每个复制帧重建一次空间哈希；格子数组保留容量，稳定后不再分配
+// ------------------------------------------------------------------
+void UFPSReplicationGraphNode_CharacterGrid::PrepareForReplication()
+{
+    for (TPair<FIntPoint, TArray<AActor*>>& Pair : Cells)
+    {
+        Pair.Value.Reset();
+    }
+
+    for (AActor* Actor : Characters)
+    {
+        Cells.FindOrAdd(GetCell(Actor->GetActorLocation())).Add(Actor);
+    }
+}
+
+void UFPSReplicationGraphNode_CharacterGrid::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    // 只提供空间哈希，由每连接的 UFPSReplicationGraphNode_CharacterBuckets 输出
+}
+
+// ==================================================================
+// UFPSReplicationGraphNode_CharacterBuckets
+// ==================================================================
+
+// ------------------------------------------------------------------
+// 只检查观察者周围能覆盖最远分档的格子，开销与附近角色数成正比，与总角色数无关。
+// 分屏时按第一个观察者计算。
+// ------------------------------------------------------------------
+void UFPSReplicationGraphNode_CharacterBuckets::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    ReplicationList.Reset();
+
+    if (!Grid || Buckets.Num() == 0 || Params.Viewers.Num() == 0)
+    {
+        return;
+    }
+
+    const FVector ViewLocation = Params.Viewers[0].ViewLocation;
+    const float MaxDistance = Buckets.Last().MaxDistance;
+    const int32 CellRadius = FMath::CeilToInt32(MaxDistance / Grid->CellSize);
+    const FIntPoint Center = Grid->GetCell(ViewLocation);
+
+    for (int32 Y = Center.Y - CellRadius; Y <= Center.Y + CellRadius; ++Y)
+    {
+        for (int32 X = Center.X - CellRadius; X <= Center.X + CellRadius; ++X)
+        {
+            const TArray<AActor*>* Cell = Grid->FindCell(FIntPoint(X, Y));
+            if (!Cell)
+            {
+                continue;
+            }
+
+            for (AActor* Actor : *Cell)
+            {
+                const double DistanceSquared = FVector::DistSquared(Actor->GetActorLocation(), ViewLocation);
+                for (const FFPSRepDistanceBucket& Bucket : Buckets)
+                {
+                    if (DistanceSquared <= FMath::Square(Bucket.MaxDistance))
+                    {
+                        // 按 Actor 错开更新帧，避免同一档的角色集中在同一帧复制
+                        const uint32 Stagger = PointerHash(Actor);
+                        if (Bucket.Period <= 1 || (Params.ReplicationFrameNum + Stagger) % Bucket.Period == 0)
+                        {
+                            ReplicationList.Add(Actor);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    if (ReplicationList.Num() > 0)
+    {
+        Params.OutGatheredReplicationLists.AddReplicationActorList(ReplicationList);
+    }
+}
+
+// ==================================================================
+// UFPSReplicationGraph
+// ==================================================================
+
+UFPSReplicationGraph::UFPSReplicationGraph()
+{
+    // 默认分档：近处每帧，远处逐级降低；超出最后一档不相关
+    const TPair<float, int32> DefaultBuckets[] = {
+        { 1500.0f, 1 },
+        { 3000.0f, 2 },
+        { 6000.0f, 4 },
+        { 10000.0f, 8 },
+    };
+    for (const TPair<float, int32>& Bucket : DefaultBuckets)
+    {
+        FFPSRepDistanceBucket& Added = CharacterBuckets.AddDefaulted_GetRef();
+        Added.MaxDistance = Bucket.Key;
+        Added.Period = Bucket.Value;
+    }
+}
+
+// ------------------------------------------------------------------
+// 类设置：为本项目的类指定路由方式，其余可复制类按其 CDO 的标志归类
+// ------------------------------------------------------------------
+void UFPSReplicationGraph::InitGlobalActorClassSettings()
+{
+    Super::InitGlobalActorClassSettings();
+
+    const float NetServerMaxTickRate = NetDriver ? static_cast<float>(NetDriver->GetNetServerMaxTickRate()) : 30.0f;
+
+    // 分档按复制帧计数，频率完全由分档控制；通道超时需大于最大间隔，否则远处角色的通道会被反复关闭重开
+    int32 MaxBucketPeriod = 1;
+    for (const FFPSRepDistanceBucket& Bucket : CharacterBuckets)
+    {
+        MaxBucketPeriod = FMath::Max(MaxBucketPeriod, Bucket.Period);
+    }
+
+    // 裁剪距离取最远一档：属性复制由分档节点决定，组播 RPC（每批开火）按类的裁剪距离只发给范围内的连接
+    float MaxBucketDistance = 0.0f;
+    for (const FFPSRepDistanceBucket& Bucket : CharacterBuckets)
+    {
+        MaxBucketDistance = FMath::Max(MaxBucketDistance, Bucket.MaxDistance);
+    }
+
+    FClassReplicationInfo CharacterInfo;
+    CharacterInfo.ReplicationPeriodFrame = 1;
+    CharacterInfo.ActorChannelFrameTimeout = static_cast<uint8>(FMath::Min(MaxBucketPeriod * 2, 255));
+    CharacterInfo.SetCullDistanceSquared(FMath::Square(MaxBucketDistance));
+    GlobalActorReplicationInfoMap.SetClassInfo(AFPSCharacter::StaticClass(), CharacterInfo);
+    ClassRepPolicies.Set(AFPSCharacter::StaticClass(), EFPSClassRepPolicy::Character);
+
+    FClassReplicationInfo ProjectileInfo;
+    ProjectileInfo.ReplicationPeriodFrame = 1;
+    ProjectileInfo.SetCullDistanceSquared(FMath::Square(ProjectileCullDistance));
+    GlobalActorReplicationInfoMap.SetClassInfo(AProjetileActor::StaticClass(), ProjectileInfo);
+    ClassRepPolicies.Set(AProjetileActor::StaticClass(), EFPSClassRepPolicy::Spatialize_Dynamic);
+
+    // 以上两类及其子类（蓝图）使用专门的设置，不再按 CDO 自动归类
+    const UClass* ExplicitlySetClasses[] = { AFPSCharacter::StaticClass(), AProjetileActor::StaticClass() };
+
+    ClassRepPolicies.Set(AReplicationGraphDebugActor::StaticClass(), EFPSClassRepPolicy::NotRouted);
+    ClassRepPolicies.Set(ALevelScriptActor::StaticClass(), EFPSClassRepPolicy::NotRouted);
+    ClassRepPolicies.Set(APlayerController::StaticClass(), EFPSClassRepPolicy::NotRouted);
+    ClassRepPolicies.Set(AGameStateBase::StaticClass(), EFPSClassRepPolicy::AlwaysRelevant);
+    ClassRepPolicies.Set(APlayerState::StaticClass(), EFPSClassRepPolicy::AlwaysRelevant);
+
+    for (TObjectIterator<UClass> It; It; ++It)
+    {
+        UClass* Class = *It;
+        const AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject(false));
+        if (!ActorCDO || !ActorCDO->GetIsReplicated())
+        {
+            continue;
+        }
+
+        // 跳过蓝图编译过程中的临时类
+        if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+        {
+            continue;
+        }
+
+        if (ClassRepPolicies.Contains(Class, false)
+            || Algo::AnyOf(ExplicitlySetClasses, [Class](const UClass* SetClass) { return Class->IsChildOf(SetClass); }))
+        {
+            continue;
+        }
+
+        EFPSClassRepPolicy Policy;
+        if (ActorCDO->bAlwaysRelevant)
+        {
+            Policy = EFPSClassRepPolicy::AlwaysRelevant;
+        }
+        else if (ActorCDO->bOnlyRelevantToOwner)
+        {
+            // 仅对拥有者相关的 Actor（控制器、拥有者的 Pawn/视角目标）由每连接节点处理
+            Policy = EFPSClassRepPolicy::NotRouted;
+        }
+        else if (ActorCDO->GetNetDormancy() > DORM_Awake)
+        {
+            Policy = EFPSClassRepPolicy::Spatialize_Dormancy;
+        }
+        else
+        {
+            Policy = ActorCDO->IsRootComponentMovable() ? EFPSClassRepPolicy::Spatialize_Dynamic : EFPSClassRepPolicy::Spatialize_Static;
+        }
+
+        // 按类的 NetUpdateFrequency 换算复制间隔，空间化的类沿用其 NetCullDistanceSquared
+        FClassReplicationInfo Info;
+        Info.ReplicationPeriodFrame = FMath::Max<uint32>(FMath::RoundToInt32(NetServerMaxTickRate / ActorCDO->GetNetUpdateFrequency()), 1);
+        if (Policy != EFPSClassRepPolicy::AlwaysRelevant && Policy != EFPSClassRepPolicy::NotRouted)
+        {
+            Info.SetCullDistanceSquared(ActorCDO->GetNetCullDistanceSquared());
+        }
+        GlobalActorReplicationInfoMap.SetClassInfo(Class, Info);
+
+        ClassRepPolicies.Set(Class, Policy);
+    }
+}
+
+void UFPSReplicationGraph::InitGlobalGraphNodes()
+{
+    GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+    GridNode->CellSize = GridCellSize;
+    GridNode->SpatialBias = GridSpatialBias;
+    AddGlobalGraphNode(GridNode);
+
+    AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+    AddGlobalGraphNode(AlwaysRelevantNode);
+
+    CharacterGridNode = CreateNewNode<UFPSReplicationGraphNode_CharacterGrid>();
+    CharacterGridNode->CellSize = CharacterCellSize;
+    AddGlobalGraphNode(CharacterGridNode);
+}
+
+void UFPSReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+    Super::InitConnectionGraphNodes(RepGraphConnection);
+
+    // 控制器、自己的 Pawn、视角目标
+    UReplicationGraphNode_AlwaysRelevant_ForConnection* AlwaysRelevantForConnection = CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>();
+    AddConnectionGraphNode(AlwaysRelevantForConnection, RepGraphConnection);
+
+    UFPSReplicationGraphNode_CharacterBuckets* CharacterBucketsNode = CreateNewNode<UFPSReplicationGraphNode_CharacterBuckets>();
+    CharacterBucketsNode->Grid = CharacterGridNode;
+    CharacterBucketsNode->Buckets = CharacterBuckets;
+    CharacterBucketsNode->Buckets.Sort([](const FFPSRepDistanceBucket& A, const FFPSRepDistanceBucket& B) { return A.MaxDistance < B.MaxDistance; });
+    AddConnectionGraphNode(CharacterBucketsNode, RepGraphConnection);
+}
+
+EFPSClassRepPolicy UFPSReplicationGraph::GetClassPolicy(const UClass* Class) const
+{
+    const EFPSClassRepPolicy* Policy = ClassRepPolicies.Get(Class);
+    return Policy ? *Policy : EFPSClassRepPolicy::NotRouted;
+}
+
+void UFPSReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+    switch (GetClassPolicy(ActorInfo.Class))
+    {
+    case EFPSClassRepPolicy::AlwaysRelevant:
+        AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Character:
+        CharacterGridNode->NotifyAddNetworkActor(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Static:
+        GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Dynamic:
+        GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Dormancy:
+        GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+        break;
+    default:
+        break;
+    }
+}
+
+void UFPSReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+    switch (GetClassPolicy(ActorInfo.Class))
+    {
+    case EFPSClassRepPolicy::AlwaysRelevant:
+        AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Character:
+        CharacterGridNode->NotifyRemoveNetworkActor(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Static:
+        GridNode->RemoveActor_Static(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Dynamic:
+        GridNode->RemoveActor_Dynamic(ActorInfo);
+        break;
+    case EFPSClassRepPolicy::Spatialize_Dormancy:
+        GridNode->RemoveActor_Dormancy(ActorInfo);
+        break;
+    default:
+        break;
+    }
+}
+
+// ------------------------------------------------------------------
+// 组播 RPC：按各连接视角目标的位置估算开火批次在裁剪距离内发往的连接数，再交给基类发送
+// ------------------------------------------------------------------
+bool UFPSReplicationGraph::ProcessRemoteFunction(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject)
+{
+    static const FName MulticastFireBatchName = GET_FUNCTION_NAME_CHECKED(AFPSCharacter, MulticastFireBatch);
+
+    if (Actor && Function && Function->GetFName() == MulticastFireBatchName && Function->HasAnyFunctionFlags(FUNC_NetMulticast))
+    {
+        const FStructProperty* BatchProperty = CastField<FStructProperty>(Function->ChildProperties);
+        UFPSNetStatsSubsystem* NetStats = Actor->GetWorld() ? Actor->GetWorld()->GetSubsystem<UFPSNetStatsSubsystem>() : nullptr;
+        if (BatchProperty && BatchProperty->Struct == FFPSFireBatch::StaticStruct() && NetStats)
+        {
+            const float CullDistanceSquared = GlobalActorReplicationInfoMap.Get(Actor).Settings.GetCullDistanceSquared();
+            const FVector Location = Actor->GetActorLocation();
+            const UNetConnection* OwnerConnection = Actor->GetNetConnection();
+
+            int32 NumConnections = 0;
+            int32 NumRecipients = 0;
+            for (UNetConnection* Connection : NetDriver->ClientConnections)
+            {
+                if (!Connection || !Connection->ViewTarget)
+                {
+                    continue;
+                }
+
+                ++NumConnections;
+                if (CullDistanceSquared <= 0.0f || Connection == OwnerConnection
+                    || FVector::DistSquared(Connection->ViewTarget->GetActorLocation(), Location) <= CullDistanceSquared)
+                {
+                    ++NumRecipients;
+                }
+            }
+
+            NetStats->RecordFireMulticast(*BatchProperty->ContainerPtrToValuePtr<FFPSFireBatch>(Parameters), NumRecipients, NumConnections);
+        }
+    }
+
+    return Super::ProcessRemoteFunction(Actor, Function, Parameters, OutParms, Stack, SubObject);
+}
+
+// ------------------------------------------------------------------
+// 复制入口：计时并定期输出
+// ------------------------------------------------------------------
+int32 UFPSReplicationGraph::ServerReplicateActors(float DeltaSeconds)
+{
+    int32 NumReplicated = 0;
+    const double StartSeconds = FPlatformTime::Seconds();
+    {
+        FPS_SCOPE_CYCLE_COUNTER(STAT_FPSServerReplicateActors);
+        NumReplicated = Super::ServerReplicateActors(DeltaSeconds);
+    }
+    const double ElapsedSeconds = FPlatformTime::Seconds() - StartSeconds;
+
+    const int32 NumConnections = NetDriver ? NetDriver->ClientConnections.Num() : 0;
+    SET_DWORD_STAT(STAT_FPSReplicationConnections, NumConnections);
+
+    ReplicateSecondsSum += ElapsedSeconds;
+    ReplicateSecondsMax = FMath::Max(ReplicateSecondsMax, ElapsedSeconds);
+    ++ReplicateFrames;
+    SecondsSinceLog += DeltaSeconds;
+
+    const float LogInterval = CVarRepGraphLogInterval.GetValueOnGameThread();
+    if (LogInterval > 0.0f && SecondsSinceLog >= LogInterval)
+    {
+        UE_LOG(LogFPSDemo, Log, TEXT("RepGraph: connections=%d avg=%.3fms max=%.3fms over %d frames"),
+            NumConnections, ReplicateSecondsSum * 1000.0 / ReplicateFrames, ReplicateSecondsMax * 1000.0, ReplicateFrames);
+
+        ReplicateSecondsSum = 0.0;
+        ReplicateSecondsMax = 0.0;
+        ReplicateFrames = 0;
+        SecondsSinceLog = 0.0;
+    }
+
+    return NumReplicated;
+}
@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "FPSReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+
+/* 复制图中各类 Actor 的路由方式 */
+enum class EFPSClassRepPolicy : uint8
+{
+    NotRouted,              // 不进入任何全局节点（PlayerController 等由每连接节点处理）
+    AlwaysRelevant,         // 对所有连接相关（GameState、PlayerState 等）
+    Character,              // 角色：空间哈希 + 距离分档频率
+    Spatialize_Static,      // 网格：静止 Actor
+    Spatialize_Dynamic,     // 网格：移动 Actor（包括需要复制的子弹）
+    Spatialize_Dormancy,    // 网格：休眠时视为静止
+};
+
+/* 角色距离分档：距离不超过 MaxDistance 时每 Period 个复制帧更新一次 */
+USTRUCT()
+struct FFPSRepDistanceBucket
+{
+    GENERATED_BODY()
+
+    UPROPERTY(Config)
+    float MaxDistance = 0.0f;
+
+    UPROPERTY(Config)
+    int32 Period = 1;
+};
+
+/**
+ * 全局节点：每个复制帧把所有角色按位置放入二维空间哈希，本身不向任何连接输出 Actor。
+ */
+UCLASS()
+class UFPSReplicationGraphNode_CharacterGrid : public UReplicationGraphNode
+{
+    GENERATED_BODY()
+
+public:
+    UFPSReplicationGraphNode_CharacterGrid();
+
+    virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+    virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+    virtual void NotifyResetAllNetworkActors() override;
+    virtual void PrepareForReplication() override;
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+    /* 取某个格子中的角色，不存在时返回 nullptr */
+    const TArray<AActor*>* FindCell(const FIntPoint& Cell) const { return Cells.Find(Cell); }
+
+    FIntPoint GetCell(const FVector& Location) const;
+
+    float CellSize = 5000.0f;
+
+private:
+    FActorRepListRefView Characters;
+    TMap<FIntPoint, TArray<AActor*>> Cells;
+};
+
+/**
+ * 每连接节点：从空间哈希中取观察者附近格子内的角色，按距离分档降低远处角色的更新频率，
+ * 超出最远一档的角色对该连接不相关。
+ */
+UCLASS()
+class UFPSReplicationGraphNode_CharacterBuckets : public UReplicationGraphNode
+{
+    GENERATED_BODY()
+
+public:
+    virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override {}
+    virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override { return false; }
+    virtual void NotifyResetAllNetworkActors() override {}
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+    UPROPERTY()
+    TObjectPtr<UFPSReplicationGraphNode_CharacterGrid> Grid;
+
+    /* 按 MaxDistance 升序排列 */
+    TArray<FFPSRepDistanceBucket> Buckets;
+
+private:
+    FActorRepListRefView ReplicationList;
+};
+
+/**
+ * UFPSReplicationGraph
+ * 本项目的复制图（DefaultEngine.ini 中 ReplicationDriverClassName 指定）：
+ *   - 角色：UFPSReplicationGraphNode_CharacterGrid 空间哈希 + 每连接距离分档；
+ *           裁剪距离取最远一档，组播的开火批次只发给范围内的连接（fps.Net.Stats 中的 FireMulticast 行）
+ *   - 子弹与其他移动/静止 Actor：二维网格，只对附近格子的连接相关
+ *   - GameState、PlayerState 等：全局常驻相关
+ *   - PlayerController、自己的 Pawn 与视角目标：每连接常驻相关
+ * 每次 ServerReplicateActors 计时，按 fps.RepGraph.LogInterval 输出平均/最大耗时与连接数。
+ */
+UCLASS(Transient, Config = Engine)
+class FPSDEMO_API UFPSReplicationGraph : public UReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+    UFPSReplicationGraph();
+
+    virtual void InitGlobalActorClassSettings() override;
+    virtual void InitGlobalGraphNodes() override;
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+    virtual int32 ServerReplicateActors(float DeltaSeconds) override;
+    virtual bool ProcessRemoteFunction(AActor* Actor, UFunction* Function, void* Parameters, FOutParmRec* OutParms, FFrame* Stack, UObject* SubObject) override;
+
+    /* 网格格子大小（cm） */
+    UPROPERTY(Config)
+    float GridCellSize = 10000.0f;
+
+    /* 网格坐标偏移，使常用地图范围落在正坐标内 */
+    UPROPERTY(Config)
+    FVector2D GridSpatialBias = FVector2D(-150000.0f, -200000.0f);
+
+    /* 需要复制的子弹的裁剪距离（cm） */
+    UPROPERTY(Config)
+    float ProjectileCullDistance = 5000.0f;
+
+    /* 角色空间哈希的格子大小（cm），应接近最远分档的距离 */
+    UPROPERTY(Config)
+    float CharacterCellSize = 5000.0f;
+
+    /* 角色距离分档 */
+    UPROPERTY(Config)
+    TArray<FFPSRepDistanceBucket> CharacterBuckets;
+
+private:
+    EFPSClassRepPolicy GetClassPolicy(const UClass* Class) const;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_GridSpatialization2D> GridNode;
+
+    UPROPERTY()
+    TObjectPtr<UReplicationGraphNode_ActorList> AlwaysRelevantNode;
+
+    UPROPERTY()
+    TObjectPtr<UFPSReplicationGraphNode_CharacterGrid> CharacterGridNode;
+
+    TClassMap<EFPSClassRepPolicy> ClassRepPolicies;
+
+    /* ServerReplicateActors 耗时统计 */
+    double ReplicateSecondsSum = 0.0;
+    double ReplicateSecondsMax = 0.0;
+    int32 ReplicateFrames = 0;
+    double SecondsSinceLog = 0.0;
+};
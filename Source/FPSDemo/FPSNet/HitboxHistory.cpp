@@ -0,0 +1,230 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSNet/HitboxHistory.h"
+
+static_assert(FMath::IsPowerOfTwo(FHitboxHistory::Capacity), "FHitboxHistory::Capacity must be a power of two");
+
+namespace HitboxHistory
+{
+    /* 射线与球体求交，返回进入点距离；起点在球内时距离为 0 */
+    static bool RaySphere(const FVector& Origin, const FVector& Direction, double MaxDistance, const FVector& Center, double Radius, double& OutDistance)
+    {
+        const FVector M = Origin - Center;
+        const double B = M | Direction;
+        const double C = M.SizeSquared() - Radius * Radius;
+        if (C > 0.0 && B > 0.0)
+        {
+            return false;
+        }
+
+        const double Discriminant = B * B - C;
+        if (Discriminant < 0.0)
+        {
+            return false;
+        }
+
+        const double Distance = FMath::Max(-B - FMath::Sqrt(Discriminant), 0.0);
+        if (Distance > MaxDistance)
+        {
+            return false;
+        }
+
+        OutDistance = Distance;
+        return true;
+    }
+
+    /* 射线与竖直胶囊体求交：圆柱侧面 + 上下两个半球 */
+    static bool RayUprightCapsule(const FVector& Origin, const FVector& Direction, double MaxDistance, const FVector& Center, double Radius, double HalfHeight, double& OutDistance)
+    {
+        const double CylinderHalfHeight = FMath::Max(HalfHeight - Radius, 0.0);
+        double Best = MaxDistance;
+        bool bHit = false;
+
+        const double MX = Origin.X - Center.X;
+        const double MY = Origin.Y - Center.Y;
+        const double A = Direction.X * Direction.X + Direction.Y * Direction.Y;
+        if (A > UE_SMALL_NUMBER)
+        {
+            const double B = MX * Direction.X + MY * Direction.Y;
+            const double C = MX * MX + MY * MY - Radius * Radius;
+            const double Discriminant = B * B - A * C;
+            if (Discriminant >= 0.0)
+            {
+                const double Distance = (-B - FMath::Sqrt(Discriminant)) / A;
+                const double Z = Origin.Z + Distance * Direction.Z - Center.Z;
+                if (Distance >= 0.0 && Distance <= Best && FMath::Abs(Z) <= CylinderHalfHeight)
+                {
+                    Best = Distance;
+                    bHit = true;
+                }
+            }
+        }
+
+        double CapDistance;
+        if (RaySphere(Origin, Direction, Best, Center + FVector(0.0, 0.0, CylinderHalfHeight), Radius, CapDistance))
+        {
+            Best = CapDistance;
+            bHit = true;
+        }
+        if (RaySphere(Origin, Direction, Best, Center - FVector(0.0, 0.0, CylinderHalfHeight), Radius, CapDistance))
+        {
+            Best = CapDistance;
+            bHit = true;
+        }
+
+        OutDistance = Best;
+        return bHit;
+    }
+}
+
+void FHitboxHistory::Initialize(TConstArrayView<float> InHitboxRadii)
+{
+    NumHitboxes = FMath::Min(InHitboxRadii.Num(), FHitboxSnapshot::MaxHitboxes);
+    for (int32 Index = 0; Index < NumHitboxes; ++Index)
+    {
+        HitboxRadii[Index] = InHitboxRadii[Index];
+    }
+    Reset();
+}
+
+void FHitboxHistory::Reset()
+{
+    Head = 0;
+    NumSnapshots = 0;
+}
+
+void FHitboxHistory::Record(double Time, const FVector& CapsuleCenter, float CapsuleRadius, float CapsuleHalfHeight, TConstArrayView<FVector> HitboxCenters)
+{
+    FHitboxSnapshot& Snapshot = Snapshots[Head];
+    Snapshot.Time = Time;
+    Snapshot.CapsuleCenter = CapsuleCenter;
+    Snapshot.CapsuleRadius = CapsuleRadius;
+    Snapshot.CapsuleHalfHeight = CapsuleHalfHeight;
+
+    float BoundingRadius = CapsuleHalfHeight;
+    const int32 NumCenters = FMath::Min(HitboxCenters.Num(), NumHitboxes);
+    for (int32 Index = 0; Index < NumCenters; ++Index)
+    {
+        const FVector3f Offset(HitboxCenters[Index] - CapsuleCenter);
+        Snapshot.HitboxOffsets[Index] = Offset;
+        BoundingRadius = FMath::Max(BoundingRadius, Offset.Size() + HitboxRadii[Index]);
+    }
+    for (int32 Index = NumCenters; Index < NumHitboxes; ++Index)
+    {
+        Snapshot.HitboxOffsets[Index] = FVector3f::ZeroVector;
+    }
+    Snapshot.BoundingRadius = BoundingRadius;
+
+    Head = (Head + 1) & (Capacity - 1);
+    NumSnapshots = FMath::Min(NumSnapshots + 1, Capacity);
+}
+
+double FHitboxHistory::GetOldestTime() const
+{
+    return NumSnapshots > 0 ? At(0).Time : 0.0;
+}
+
+double FHitboxHistory::GetNewestTime() const
+{
+    return NumSnapshots > 0 ? At(NumSnapshots - 1).Time : 0.0;
+}
+
+bool FHitboxHistory::Sample(double Time, FHitboxSnapshot& OutSnapshot) const
+{
+    if (NumSnapshots == 0)
+    {
+        return false;
+    }
+
+    if (Time <= At(0).Time)
+    {
+        OutSnapshot = At(0);
+        return true;
+    }
+    if (Time >= At(NumSnapshots - 1).Time)
+    {
+        OutSnapshot = At(NumSnapshots - 1);
+        return true;
+    }
+
+    // 二分查找：Older.Time <= Time < Newer.Time
+    int32 Low = 0;
+    int32 High = NumSnapshots - 1;
+    while (High - Low > 1)
+    {
+        const int32 Mid = (Low + High) / 2;
+        if (At(Mid).Time <= Time)
+        {
+            Low = Mid;
+        }
+        else
+        {
+            High = Mid;
+        }
+    }
+
+    const FHitboxSnapshot& Older = At(Low);
+    const FHitboxSnapshot& Newer = At(High);
+    const double Span = Newer.Time - Older.Time;
+    const float Alpha = Span > UE_SMALL_NUMBER ? static_cast<float>((Time - Older.Time) / Span) : 1.0f;
+
+    OutSnapshot.Time = Time;
+    OutSnapshot.CapsuleCenter = FMath::Lerp(Older.CapsuleCenter, Newer.CapsuleCenter, static_cast<double>(Alpha));
+    OutSnapshot.CapsuleRadius = FMath::Lerp(Older.CapsuleRadius, Newer.CapsuleRadius, Alpha);
+    OutSnapshot.CapsuleHalfHeight = FMath::Lerp(Older.CapsuleHalfHeight, Newer.CapsuleHalfHeight, Alpha);
+    OutSnapshot.BoundingRadius = FMath::Max(Older.BoundingRadius, Newer.BoundingRadius);
+    for (int32 Index = 0; Index < NumHitboxes; ++Index)
+    {
+        OutSnapshot.HitboxOffsets[Index] = FMath::Lerp(Older.HitboxOffsets[Index], Newer.HitboxOffsets[Index], Alpha);
+    }
+    return true;
+}
+
+bool FHitboxHistory::Raycast(double Time, const FVector& Origin, const FVector& Direction, double MaxDistance, double& OutDistance, int32& OutHitbox) const
+{
+    FHitboxSnapshot Snapshot;
+    if (!Sample(Time, Snapshot))
+    {
+        return false;
+    }
+
+    // 粗筛：包围球
+    double Distance;
+    if (!HitboxHistory::RaySphere(Origin, Direction, MaxDistance, Snapshot.CapsuleCenter, Snapshot.BoundingRadius, Distance))
+    {
+        return false;
+    }
+
+    // 未配置命中盒时直接使用胶囊体
+    if (NumHitboxes == 0)
+    {
+        if (HitboxHistory::RayUprightCapsule(Origin, Direction, MaxDistance, Snapshot.CapsuleCenter, Snapshot.CapsuleRadius, Snapshot.CapsuleHalfHeight, Distance))
+        {
+            OutDistance = Distance;
+            OutHitbox = INDEX_NONE;
+            return true;
+        }
+        return false;
+    }
+
+    double Best = MaxDistance;
+    int32 BestHitbox = INDEX_NONE;
+    for (int32 Index = 0; Index < NumHitboxes; ++Index)
+    {
+        const FVector Center = Snapshot.CapsuleCenter + FVector(Snapshot.HitboxOffsets[Index]);
+        if (HitboxHistory::RaySphere(Origin, Direction, Best, Center, HitboxRadii[Index], Distance))
+        {
+            Best = Distance;
+            BestHitbox = Index;
+        }
+    }
+
+    if (BestHitbox == INDEX_NONE)
+    {
+        return false;
+    }
+
+    OutDistance = Best;
+    OutHitbox = BestHitbox;
+    return true;
+}
@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StaticArray.h"
+#include "HitboxHistory.generated.h"
+
+/**
+ * 一个命中盒：绑定到骨骼的球体。
+ */
+USTRUCT()
+struct FPSDEMO_API FFPSHitboxDef
+{
+    GENERATED_BODY()
+
+    /* 跟随的骨骼；在网格上找不到时使用胶囊体中心 */
+    UPROPERTY(EditAnywhere, Category = "Hitbox")
+    FName BoneName;
+
+    /* 球体半径（cm） */
+    UPROPERTY(EditAnywhere, Category = "Hitbox", meta = (ClampMin = "1.0"))
+    float Radius = 10.0f;
+};
+
+/**
+ * 某一时刻的胶囊体与命中盒快照。
+ * 命中盒位置以相对胶囊体中心的 float 偏移保存，单个快照约 144 字节。
+ */
+struct FHitboxSnapshot
+{
+    static constexpr int32 MaxHitboxes = 8;
+
+    double Time = 0.0;
+    FVector CapsuleCenter = FVector::ZeroVector;
+    float CapsuleRadius = 0.0f;
+    float CapsuleHalfHeight = 0.0f;
+
+    /* 包围胶囊体与全部命中盒的球半径，用于粗筛 */
+    float BoundingRadius = 0.0f;
+
+    FVector3f HitboxOffsets[MaxHitboxes];
+};
+
+static_assert(sizeof(FHitboxSnapshot) == 144, "FHitboxSnapshot layout changed, update the size noted above and FHitboxHistory's memory estimate");
+
+/**
+ * FHitboxHistory
+ * 定长环形缓冲：保存角色最近 Capacity 帧的快照（60Hz 下约 1 秒），内存固定约 9KB。
+ * 回溯查询按时间二分查找相邻两帧并插值，然后对插值结果做解析射线检测，不访问物理场景，
+ * 单次查询耗时只与命中盒数量有关。
+ */
+class FPSDEMO_API FHitboxHistory
+{
+public:
+    /* 必须为 2 的幂 */
+    static constexpr int32 Capacity = 64;
+
+    /* 设置命中盒半径（数量不超过 FHitboxSnapshot::MaxHitboxes），并清空历史 */
+    void Initialize(TConstArrayView<float> InHitboxRadii);
+
+    /* 清空历史 */
+    void Reset();
+
+    /* 追加一帧快照，覆盖最旧的一帧 */
+    void Record(double Time, const FVector& CapsuleCenter, float CapsuleRadius, float CapsuleHalfHeight, TConstArrayView<FVector> HitboxCenters);
+
+    /**
+     * 取指定时间的插值快照；超出记录范围时取最近的一端。
+     * @return 没有任何记录时返回 false
+     */
+    bool Sample(double Time, FHitboxSnapshot& OutSnapshot) const;
+
+    /**
+     * 在指定时间的快照上做射线检测。
+     * @param Origin       射线起点
+     * @param Direction    归一化方向
+     * @param MaxDistance  最大距离
+     * @param OutDistance  命中距离
+     * @param OutHitbox    命中的命中盒序号，INDEX_NONE 表示命中胶囊体（未配置命中盒时）
+     */
+    bool Raycast(double Time, const FVector& Origin, const FVector& Direction, double MaxDistance, double& OutDistance, int32& OutHitbox) const;
+
+    int32 Num() const { return NumSnapshots; }
+    int32 GetNumHitboxes() const { return NumHitboxes; }
+    double GetOldestTime() const;
+    double GetNewestTime() const;
+
+private:
+    /* 第 LogicalIndex 旧的快照（0 为最旧） */
+    const FHitboxSnapshot& At(int32 LogicalIndex) const
+    {
+        return Snapshots[(Head - NumSnapshots + LogicalIndex) & (Capacity - 1)];
+    }
+
+    TStaticArray<FHitboxSnapshot, Capacity> Snapshots;
+    TStaticArray<float, FHitboxSnapshot::MaxHitboxes> HitboxRadii;
+    int32 NumHitboxes = 0;
+
+    /* 下一次写入的位置 */
+    int32 Head = 0;
+    int32 NumSnapshots = 0;
+};
@@ -0,0 +1,393 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSProjetile/ProjectileBallisticsSubsystem.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSCollision/FPSStaticCollisionSubsystem.h"
+#include "FPSSignificance/FPSTickSignificanceSubsystem.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "Async/ParallelFor.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarBatchedBallistics(
+    TEXT("fps.Projectile.BatchedBallistics"),
+    1,
+    TEXT("1：子弹运动由 UProjectileBallisticsSubsystem 批量积分与扫掠；0：使用每个子弹自身的 ProjectileMovementComponent。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarParallelSweepMinBatch(
+    TEXT("fps.Projectile.ParallelSweepMinBatch"),
+    32,
+    TEXT("在途子弹数量不少于该值时，碰撞扫掠分发到工作线程并行执行。"),
+    ECVF_Default);
+
+bool UProjectileBallisticsSubsystem::IsBatchedBallisticsEnabled()
+{
+    return CVarBatchedBallistics.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UProjectileBallisticsSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectileBallisticsSubsystem::Deinitialize()
+{
+    for (AProjetileActor* Projectile : Actors)
+    {
+        if (Projectile)
+        {
+            Projectile->BallisticsSlot = INDEX_NONE;
+        }
+    }
+
+    Actors.Empty();
+    Positions.Empty();
+    Velocities.Empty();
+    GravityZ.Empty();
+    MaxSpeeds.Empty();
+    Bounciness.Empty();
+    Radii.Empty();
+    RemainingLife.Empty();
+    LaunchDelay.Empty();
+    CollisionChannels.Empty();
+    CollisionResponses.Empty();
+    TickIntervals.Empty();
+    NextStepFrames.Empty();
+    PendingTime.Empty();
+    NumPendingRemove = 0;
+
+    Super::Deinitialize();
+}
+
+TStatId UProjectileBallisticsSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UProjectileBallisticsSubsystem, STATGROUP_Tickables);
+}
+
+// ------------------------------------------------------------------
+// 登记：从子弹的移动组件与碰撞组件中读取参数，追加到 SoA 末尾
+// ------------------------------------------------------------------
+int32 UProjectileBallisticsSubsystem::Register(AProjetileActor* Projectile, const FVector& Velocity, float LifeSpan, double LaunchTime)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    check(Projectile && Projectile->BallisticsSlot == INDEX_NONE);
+
+    const UProjectileMovementComponent* Movement = Projectile->ProjectileMovementComponent;
+    const USphereComponent* Collision = Projectile->CollisionComponent;
+
+    const int32 Slot = Actors.Add(Projectile);
+    Positions.Add(Projectile->GetActorLocation());
+    Velocities.Add(Velocity);
+    GravityZ.Add(Movement->GetGravityZ());
+    MaxSpeeds.Add(Movement->GetMaxSpeed());
+    Bounciness.Add(Movement->bShouldBounce ? Movement->Bounciness : -1.0f);
+    Radii.Add(Collision->GetScaledSphereRadius());
+    RemainingLife.Add(LifeSpan);
+
+    // 本帧 Tick 会积分完整的 DeltaSeconds；开火时间晚于帧开始的部分尚未发生，需要跳过
+    const UWorld* World = GetWorld();
+    const double FrameStartTime = World->GetTimeSeconds() - World->GetDeltaSeconds();
+    LaunchDelay.Add(static_cast<float>(FMath::Clamp(LaunchTime - FrameStartTime, 0.0, static_cast<double>(World->GetDeltaSeconds()))));
+    CollisionChannels.Add(Collision->GetCollisionObjectType());
+    CollisionResponses.Add(Collision->GetCollisionResponseToChannels());
+
+    // 新发射的子弹在登记当帧积分
+    TickIntervals.Add(1);
+    NextStepFrames.Add(FrameCounter);
+    PendingTime.Add(0.0f);
+
+    Projectile->BallisticsSlot = Slot;
+    return Slot;
+}
+
+void UProjectileBallisticsSubsystem::Unregister(AProjetileActor* Projectile)
+{
+    if (!Projectile || !Actors.IsValidIndex(Projectile->BallisticsSlot))
+    {
+        return;
+    }
+
+    check(Actors[Projectile->BallisticsSlot] == Projectile);
+    Actors[Projectile->BallisticsSlot] = nullptr;
+    Projectile->BallisticsSlot = INDEX_NONE;
+    ++NumPendingRemove;
+}
+
+// ------------------------------------------------------------------
+// 每帧：积分 -> 批量扫掠 -> 处理命中与同步 -> 压缩
+// ------------------------------------------------------------------
+void UProjectileBallisticsSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (Actors.Num() == 0)
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSBallisticsTick);
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+    FPS_ALLOC_SCOPE(Shot);
+
+    IntegrateBatch(DeltaTime);
+    SweepBatch();
+    ResolveBatch();
+    CompactSlots();
+    UpdateTickIntervals();
+    ++FrameCounter;
+}
+
+void UProjectileBallisticsSubsystem::IntegrateBatch(float DeltaTime)
+{
+    const int32 Num = Actors.Num();
+    SweepStarts.SetNumUninitialized(Num, EAllowShrinking::No);
+    StepTimes.SetNumUninitialized(Num, EAllowShrinking::No);
+
+    // 以下循环只访问连续的数组且无分支依赖，便于编译器向量化
+
+    // 每枚子弹本帧实际飞行的时间：新发射的子弹扣除开火前的部分；
+    // 降频的子弹未轮到时只累积时间（StepTime 为 0，后续循环不改变其状态），轮到时一次补齐
+    int32 NumStepped = 0;
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        const float Elapsed = PendingTime[Index] + DeltaTime - LaunchDelay[Index];
+        // 有符号差值，帧计数回绕时仍然正确
+        const bool bStep = static_cast<int32>(FrameCounter - NextStepFrames[Index]) >= 0;
+        StepTimes[Index] = bStep ? Elapsed : 0.0f;
+        PendingTime[Index] = bStep ? 0.0f : Elapsed;
+        NextStepFrames[Index] = bStep ? FrameCounter + TickIntervals[Index] : NextStepFrames[Index];
+        LaunchDelay[Index] = 0.0f;
+        NumStepped += bStep ? 1 : 0;
+    }
+
+    if (UFPSTickSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>())
+    {
+        Significance->AddBatchedTicks(NumStepped, Num);
+    }
+
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        RemainingLife[Index] -= StepTimes[Index];
+    }
+
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        Velocities[Index].Z += GravityZ[Index] * StepTimes[Index];
+    }
+
+    // 与 ProjectileMovementComponent 一致：MaxSpeed 为 0 表示不限速
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        const float MaxSpeed = MaxSpeeds[Index];
+        if (MaxSpeed > 0.0f)
+        {
+            Velocities[Index] = Velocities[Index].GetClampedToMaxSize(MaxSpeed);
+        }
+    }
+
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        SweepStarts[Index] = Positions[Index];
+        Positions[Index] += Velocities[Index] * StepTimes[Index];
+    }
+}
+
+void UProjectileBallisticsSubsystem::SweepBatch()
+{
+    const int32 Num = Actors.Num();
+    SweepHits.SetNum(Num, EAllowShrinking::No);
+    SweepBlocked.SetNumUninitialized(Num, EAllowShrinking::No);
+
+    const UWorld* World = GetWorld();
+    const EParallelForFlags Flags = Num >= CVarParallelSweepMinBatch.GetValueOnGameThread()
+        ? EParallelForFlags::None
+        : EParallelForFlags::ForceSingleThread;
+
+    // 静态关卡碰撞走 BVH，场景查询只检测动态物体；BVH 需在游戏线程上准备好
+    UFPSStaticCollisionSubsystem* StaticCollision = UFPSStaticCollisionSubsystem::IsStaticBVHEnabled()
+        ? World->GetSubsystem<UFPSStaticCollisionSubsystem>()
+        : nullptr;
+    if (StaticCollision && !StaticCollision->GetBVH())
+    {
+        StaticCollision = nullptr;
+    }
+
+    // 工作线程上的分配（场景查询等）同样计入发起线程的射击分配计数
+    FPSAllocationTracker::FCounter* const AllocCounter = FPSAllocationTracker::GetActiveCounter();
+
+    // 场景查询与 BVH 均只读，可在工作线程并发执行；结果写入各自槽位，互不干扰
+    ParallelFor(Num, [this, World, StaticCollision, AllocCounter](int32 Index)
+    {
+        FPSAllocationTracker::FScope AllocScope(AllocCounter);
+
+        const AProjetileActor* Projectile = Actors[Index];
+        if (!Projectile || StepTimes[Index] <= 0.0f)
+        {
+            SweepBlocked[Index] = 0;
+            return;
+        }
+
+        FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSProjectileSweep), false, Projectile);
+        const FCollisionResponseParams ResponseParams(CollisionResponses[Index]);
+
+        if (StaticCollision && CollisionResponses[Index].GetResponse(ECC_WorldStatic) == ECR_Block)
+        {
+            SweepBlocked[Index] = StaticCollision->SweepSphere(
+                SweepHits[Index],
+                SweepStarts[Index],
+                Positions[Index],
+                Radii[Index],
+                CollisionChannels[Index],
+                QueryParams,
+                ResponseParams) ? 1 : 0;
+            return;
+        }
+
+        SweepBlocked[Index] = World->SweepSingleByChannel(
+            SweepHits[Index],
+            SweepStarts[Index],
+            Positions[Index],
+            FQuat::Identity,
+            CollisionChannels[Index],
+            FCollisionShape::MakeSphere(Radii[Index]),
+            QueryParams,
+            ResponseParams) ? 1 : 0;
+    }, Flags);
+}
+
+void UProjectileBallisticsSubsystem::ResolveBatch()
+{
+    const int32 Num = Actors.Num();
+
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        AProjetileActor* Projectile = Actors[Index];
+        if (!Projectile || StepTimes[Index] <= 0.0f)
+        {
+            continue;
+        }
+
+        if (SweepBlocked[Index])
+        {
+            const FHitResult& Hit = SweepHits[Index];
+            Positions[Index] = Hit.Location;
+
+            // 同步到命中位置与命中前的速度，使 OnHit 中的冲量计算与原先逐 Actor 移动时一致
+            Projectile->SetActorLocation(Hit.Location);
+            Projectile->ProjectileMovementComponent->Velocity = Velocities[Index];
+
+            // 与移动组件相同：向双方派发阻挡命中事件（触发 OnHit）
+            if (Hit.GetComponent())
+            {
+                Projectile->CollisionComponent->DispatchBlockingHit(*Projectile, Hit);
+            }
+
+            // OnHit 中已回收
+            if (!Actors[Index])
+            {
+                continue;
+            }
+
+            // 未被回收时按弹跳系数反射法向速度
+            const float Restitution = Bounciness[Index];
+            const float NormalSpeed = Velocities[Index] | Hit.Normal;
+            if (Restitution >= 0.0f && NormalSpeed < 0.0f)
+            {
+                Velocities[Index] -= (1.0f + Restitution) * NormalSpeed * Hit.Normal;
+            }
+            else
+            {
+                Velocities[Index] = FVector::ZeroVector;
+            }
+        }
+
+        // 寿命到期
+        if (RemainingLife[Index] <= 0.0f)
+        {
+            Projectile->ReturnToPool();
+            continue;
+        }
+
+        // 同步 Actor 变换，朝向跟随速度（等同 bRotationFollowsVelocity）
+        const FVector& Velocity = Velocities[Index];
+        if (Velocity.IsNearlyZero())
+        {
+            Projectile->SetActorLocation(Positions[Index]);
+        }
+        else
+        {
+            Projectile->SetActorLocationAndRotation(Positions[Index], Velocity.Rotation());
+        }
+    }
+}
+
+void UProjectileBallisticsSubsystem::CompactSlots()
+{
+    if (NumPendingRemove == 0)
+    {
+        return;
+    }
+
+    for (int32 Index = Actors.Num() - 1; Index >= 0; --Index)
+    {
+        if (Actors[Index])
+        {
+            continue;
+        }
+
+        Actors.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        Positions.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        Velocities.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        GravityZ.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        MaxSpeeds.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        Bounciness.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        Radii.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        RemainingLife.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        LaunchDelay.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        CollisionChannels.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        CollisionResponses.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        TickIntervals.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        NextStepFrames.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        PendingTime.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+
+        // 被交换到当前位置的子弹需要更新槽位
+        if (Actors.IsValidIndex(Index) && Actors[Index])
+        {
+            Actors[Index]->BallisticsSlot = Index;
+        }
+    }
+
+    NumPendingRemove = 0;
+}
+
+// ------------------------------------------------------------------
+// 积分间隔：子弹不休眠，最远档位为 fps.Significance.FarInterval；未启用时每帧积分。
+// 间隔变小时把下一次积分提前，从下一帧起最多再等新的间隔
+// ------------------------------------------------------------------
+void UProjectileBallisticsSubsystem::UpdateTickIntervals()
+{
+    const UFPSTickSignificanceSubsystem* Significance = UFPSTickSignificanceSubsystem::IsSignificanceEnabled()
+        ? GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>()
+        : nullptr;
+
+    const int32 Num = Actors.Num();
+    for (int32 Index = 0; Index < Num; ++Index)
+    {
+        const uint8 Interval = Significance ? FMath::Max<uint8>(1, Significance->GetTickInterval(Positions[Index], false)) : 1;
+        const uint32 LatestStepFrame = FrameCounter + Interval;
+        if (static_cast<int32>(NextStepFrames[Index] - LatestStepFrame) > 0)
+        {
+            NextStepFrames[Index] = LatestStepFrame;
+        }
+        TickIntervals[Index] = Interval;
+    }
+}
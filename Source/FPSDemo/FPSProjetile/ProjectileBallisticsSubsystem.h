@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+#include "ProjectileBallisticsSubsystem.generated.h"
+
+class AProjetileActor;
+
+/**
+ * UProjectileBallisticsSubsystem
+ * 数据导向的子弹弹道子系统。
+ * 所有在途子弹以结构数组（SoA）形式存放（位置、速度、弹跳系数、剩余寿命等），
+ * 每帧统一积分一次，并批量发起碰撞扫掠，命中时复用子弹原有的 OnHit 语义（冲量、弹跳、回收）。
+ * 启用后子弹自身的 UProjectileMovementComponent 不再 Tick。
+ * 启用 fps.Significance.Enable 时按 UFPSTickSignificanceSubsystem 的档位逐槽位降频：
+ * 未轮到的子弹本帧不积分、不扫掠、不同步，时间累积到下一次积分一并补齐（扫掠覆盖整段路径，不会穿透）。
+ */
+UCLASS()
+class FPSDEMO_API UProjectileBallisticsSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* 是否由本子系统接管子弹运动（fps.Projectile.BatchedBallistics） */
+    static bool IsBatchedBallisticsEnabled();
+
+    /**
+     * 登记一枚子弹。
+     * @param Projectile 已激活的子弹
+     * @param Velocity   初速度（cm/s）
+     * @param LifeSpan   剩余寿命（秒），到期后归还对象池
+     * @param LaunchTime 开火时的世界时间；登记当帧只积分开火之后的那部分时间
+     * @return 子弹所在的槽位
+     */
+    int32 Register(AProjetileActor* Projectile, const FVector& Velocity, float LifeSpan, double LaunchTime);
+
+    /* 注销一枚子弹。只做标记，槽位在本帧结束时统一压缩，因此可在命中回调中安全调用。 */
+    void Unregister(AProjetileActor* Projectile);
+
+    /* 当前在途子弹数量 */
+    int32 GetNumProjectiles() const { return Actors.Num() - NumPendingRemove; }
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 第一阶段：积分速度与位置，并记录本帧扫掠的起点 */
+    void IntegrateBatch(float DeltaTime);
+
+    /* 第二阶段：批量发起扫掠（数量足够时并行） */
+    void SweepBatch();
+
+    /* 第三阶段：在游戏线程上处理命中、寿命与 Actor 变换同步 */
+    void ResolveBatch();
+
+    /* 移除已注销的槽位（交换删除） */
+    void CompactSlots();
+
+    /* 按重要度更新各槽位下一帧的积分间隔 */
+    void UpdateTickIntervals();
+
+    /* ---------------- SoA 数据 ---------------- */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AProjetileActor>> Actors;
+
+    TArray<FVector> Positions;
+    TArray<FVector> Velocities;
+    TArray<float> GravityZ;
+    TArray<float> MaxSpeeds;
+    TArray<float> Bounciness;
+    TArray<float> Radii;
+    TArray<float> RemainingLife;
+    TArray<float> LaunchDelay;
+    TArray<TEnumAsByte<ECollisionChannel>> CollisionChannels;
+    TArray<FCollisionResponseContainer> CollisionResponses;
+
+    /* 积分间隔（帧）、下一次积分的帧号与未积分的累积时间（秒）；随槽位一起交换，压缩后不会错过积分帧 */
+    TArray<uint8> TickIntervals;
+    TArray<uint32> NextStepFrames;
+    TArray<float> PendingTime;
+
+    /* ---------------- 每帧临时数据 ---------------- */
+    TArray<FVector> SweepStarts;
+    TArray<float> StepTimes;
+    TArray<FHitResult> SweepHits;
+    TArray<uint8> SweepBlocked;
+
+    /* 已标记注销、等待压缩的槽位数量 */
+    int32 NumPendingRemove = 0;
+
+    /* 帧计数，与 NextStepFrames 比较决定本帧是否积分 */
+    uint32 FrameCounter = 0;
+};
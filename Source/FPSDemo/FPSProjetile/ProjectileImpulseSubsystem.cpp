@@ -0,0 +1,211 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSProjetile/ProjectileImpulseSubsystem.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/Utilities.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+
+static TAutoConsoleVariable<int32> CVarBatchedImpulses(
+    TEXT("fps.Physics.BatchedImpulses"),
+    1,
+    TEXT("1：子弹命中冲量按刚体合并，在物理线程模拟前批量施加；0：命中时立即调用 AddImpulseAtLocation。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 模拟回调的输入：游戏线程写入，物理线程在对应的步进中读取
+// ------------------------------------------------------------------
+struct FFPSImpulseSimInput : public Chaos::FSimCallbackInput
+{
+    TArray<FFPSBodyImpulse> Impulses;
+
+    /* 施加后回报 PhysicsImpulse 事件的队列，世界没有命中事件总线时为空 */
+    TSharedPtr<FFPSHitEventQueue, ESPMode::ThreadSafe> HitEvents;
+
+    void Reset()
+    {
+        Impulses.Reset();
+        HitEvents.Reset();
+    }
+};
+
+// ------------------------------------------------------------------
+// Chaos 模拟回调：在物理线程每次模拟前施加本批次的冲量
+// ------------------------------------------------------------------
+class FFPSImpulseSimCallback : public Chaos::TSimCallbackObject<FFPSImpulseSimInput, Chaos::FSimCallbackNoOutput, Chaos::ESimCallbackOptions::Presimulate>
+{
+public:
+    virtual FName GetFNameForStatId() const override
+    {
+        static const FLazyName StatName(TEXT("FFPSImpulseSimCallback"));
+        return StatName;
+    }
+
+private:
+    virtual void OnPreSimulate_Internal() override
+    {
+        const FFPSImpulseSimInput* Input = GetConsumerInput_Internal();
+        if (!Input)
+        {
+            return;
+        }
+
+        for (const FFPSBodyImpulse& Impulse : Input->Impulses)
+        {
+            // 排队后刚体已被移出场景时句柄为空
+            Chaos::FRigidBodyHandle_Internal* Rigid = Impulse.Proxy ? Impulse.Proxy->GetPhysicsThreadAPI() : nullptr;
+            if (!Rigid)
+            {
+                continue;
+            }
+
+            const Chaos::EObjectStateType State = Rigid->ObjectState();
+            if (State == Chaos::EObjectStateType::Sleeping)
+            {
+                Rigid->SetObjectState(Chaos::EObjectStateType::Dynamic);
+            }
+            else if (State != Chaos::EObjectStateType::Dynamic)
+            {
+                continue;
+            }
+
+            // 与 AddImpulseAtLocation 相同：冲量换算为速度增量，由求解器在本步积分
+            const Chaos::FMatrix33 WorldInvInertia = Chaos::Utilities::ComputeWorldSpaceInertia(
+                Rigid->GetR() * Rigid->RotationOfMass(), Chaos::FVec3(Rigid->InvI()));
+
+            Rigid->SetLinearImpulseVelocity(Rigid->LinearImpulseVelocity() + Impulse.Linear * Rigid->InvM(), false);
+            Rigid->SetAngularImpulseVelocity(Rigid->AngularImpulseVelocity() + Chaos::Utilities::Multiply(WorldInvInertia, Impulse.Angular), false);
+
+            // 从物理线程直接推入无锁队列，由游戏线程在帧末排出
+            if (Input->HitEvents)
+            {
+                FFPSHitEvent Event;
+                Event.Kind = EFPSHitEventKind::PhysicsImpulse;
+                Event.Source = EFPSHitEventSource::Physics;
+                Event.HitComponent = Impulse.Component;
+                Event.Location = Rigid->GetX();
+                Event.Direction = Impulse.Linear.GetSafeNormal();
+                Event.Magnitude = Impulse.Linear.Size();
+                Input->HitEvents->Push(MoveTemp(Event));
+            }
+        }
+    }
+};
+
+bool UProjectileImpulseSubsystem::IsBatchedImpulsesEnabled()
+{
+    return CVarBatchedImpulses.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UProjectileImpulseSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+// ------------------------------------------------------------------
+// 开始游戏：在物理求解器上注册模拟回调，并在每次步进前提交批次
+// ------------------------------------------------------------------
+void UProjectileImpulseSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    FPhysScene_Chaos* PhysScene = InWorld.GetPhysicsScene();
+    Chaos::FPBDRigidsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr;
+    if (!Solver)
+    {
+        return;
+    }
+
+    SimCallback = Solver->CreateAndRegisterSimCallbackObject_External<FFPSImpulseSimCallback>();
+    PhysScenePreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &UProjectileImpulseSubsystem::FlushPendingImpulses);
+}
+
+void UProjectileImpulseSubsystem::Deinitialize()
+{
+    if (FPhysScene_Chaos* PhysScene = GetWorld()->GetPhysicsScene())
+    {
+        PhysScene->OnPhysScenePreTick.Remove(PhysScenePreTickHandle);
+
+        if (SimCallback)
+        {
+            if (Chaos::FPBDRigidsSolver* Solver = PhysScene->GetSolver())
+            {
+                Solver->UnregisterAndFreeSimCallbackObject_External(SimCallback);
+            }
+        }
+    }
+
+    SimCallback = nullptr;
+    PendingImpulses.Empty();
+    PendingIndices.Empty();
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 排队：按刚体合并线冲量与角冲量（角冲量以排队时的质心计算）
+// ------------------------------------------------------------------
+bool UProjectileImpulseSubsystem::QueueImpulse(UPrimitiveComponent* HitComponent, const FVector& Impulse, const FVector& ImpactPoint)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    if (!SimCallback)
+    {
+        return false;
+    }
+
+    const FBodyInstance* Body = HitComponent->GetBodyInstance();
+    Chaos::FSingleParticlePhysicsProxy* Proxy = Body ? Body->GetPhysicsActorHandle() : nullptr;
+    if (!Proxy)
+    {
+        return false;
+    }
+
+    int32& Index = PendingIndices.FindOrAdd(Proxy, INDEX_NONE);
+    if (Index == INDEX_NONE)
+    {
+        Index = PendingImpulses.AddDefaulted();
+        PendingImpulses[Index].Proxy = Proxy;
+        PendingImpulses[Index].Component = HitComponent;
+    }
+
+    FFPSBodyImpulse& Pending = PendingImpulses[Index];
+    Pending.Linear += Impulse;
+    Pending.Angular += FVector::CrossProduct(ImpactPoint - Body->GetCOMPosition(), Impulse);
+    return true;
+}
+
+// ------------------------------------------------------------------
+// 提交：把本批次追加到模拟回调的输入中，由接下来的物理步进消费
+// ------------------------------------------------------------------
+void UProjectileImpulseSubsystem::FlushPendingImpulses(FPhysScene_Chaos* PhysScene, float DeltaSeconds)
+{
+    if (PendingImpulses.Num() == 0 || !SimCallback)
+    {
+        return;
+    }
+
+    INC_DWORD_STAT_BY(STAT_FPSImpulseBodies, PendingImpulses.Num());
+
+    FFPSImpulseSimInput* Input = SimCallback->GetProducerInputData_External();
+    Input->Impulses.Append(PendingImpulses);
+
+    if (const UFPSHitEventSubsystem* HitEvents = GetWorld()->GetSubsystem<UFPSHitEventSubsystem>())
+    {
+        Input->HitEvents = HitEvents->GetQueue();
+    }
+
+    PendingImpulses.Reset();
+    PendingIndices.Reset();
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileImpulseSubsystem.generated.h"
+
+class FPhysScene_Chaos;
+class FFPSImpulseSimCallback;
+class UPrimitiveComponent;
+
+namespace Chaos
+{
+    class FSingleParticlePhysicsProxy;
+}
+
+/* 合并后作用于同一刚体的冲量（世界空间）。 */
+struct FFPSBodyImpulse
+{
+    Chaos::FSingleParticlePhysicsProxy* Proxy = nullptr;
+
+    /* 所属组件，仅用于回报命中事件，不在物理线程解引用 */
+    TWeakObjectPtr<UPrimitiveComponent> Component;
+
+    /* 线冲量之和 */
+    FVector Linear = FVector::ZeroVector;
+
+    /* 各命中点相对质心产生的角冲量之和 */
+    FVector Angular = FVector::ZeroVector;
+};
+
+/**
+ * UProjectileImpulseSubsystem
+ * 子弹命中冲量的批量提交。
+ * 命中时不再直接调用 AddImpulseAtLocation，而是在游戏线程按刚体合并为一个线冲量与一个角冲量；
+ * 物理场景每次步进前把本批次交给 Chaos 模拟回调，由物理线程在模拟前一次性写入。
+ * 同一帧内多发子弹命中同一刚体时只产生一次写入，且合并顺序固定，结果与命中先后无关。
+ * 物理线程施加后为每个刚体向命中事件总线推入一条 PhysicsImpulse 事件。
+ */
+UCLASS()
+class FPSDEMO_API UProjectileImpulseSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* 是否批量提交冲量（fps.Physics.BatchedImpulses） */
+    static bool IsBatchedImpulsesEnabled();
+
+    /**
+     * 排队一次命中冲量，与同一刚体上已排队的冲量合并。
+     * @param HitComponent 被击中且正在模拟物理的组件
+     * @param Impulse      冲量（世界空间）
+     * @param ImpactPoint  命中点
+     * @return 未能排队（尚未注册模拟回调或组件没有物理代理）时返回 false，由调用方直接施加
+     */
+    bool QueueImpulse(UPrimitiveComponent* HitComponent, const FVector& Impulse, const FVector& ImpactPoint);
+
+    /* 当前排队的刚体数量 */
+    int32 GetNumPendingBodies() const { return PendingImpulses.Num(); }
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 物理场景步进前：把合并后的冲量交给模拟回调 */
+    void FlushPendingImpulses(FPhysScene_Chaos* PhysScene, float DeltaSeconds);
+
+    /* 在物理求解器上注册的模拟回调，由求解器持有 */
+    FFPSImpulseSimCallback* SimCallback = nullptr;
+
+    FDelegateHandle PhysScenePreTickHandle;
+
+    /* 本批次的合并结果，按刚体首次被命中的顺序排列 */
+    TArray<FFPSBodyImpulse> PendingImpulses;
+
+    /* 刚体 -> PendingImpulses 中的下标 */
+    TMap<Chaos::FSingleParticlePhysicsProxy*, int32> PendingIndices;
+};
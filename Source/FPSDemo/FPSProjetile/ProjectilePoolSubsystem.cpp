@@ -0,0 +1,217 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSProjetile/ProjectilePoolSubsystem.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSDemo.h"
+#include "FPSBenchmark/FPSSoakProbes.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.ProjectilePool.Stats
+// 输出当前世界子弹对象池的命中/未命中/峰值等统计
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GProjectilePoolStatsCommand(
+    TEXT("fps.ProjectilePool.Stats"),
+    TEXT("输出子弹对象池统计（命中、未命中、激活数量峰值）。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UProjectilePoolSubsystem* Pool = World ? World->GetSubsystem<UProjectilePoolSubsystem>() : nullptr)
+        {
+            Pool->LogStats();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UProjectilePoolSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UProjectilePoolSubsystem::Deinitialize()
+{
+    LogStats();
+
+    // 世界销毁时池中的 Actor 会随之销毁，这里只需清空引用
+    Buckets.Empty();
+    DEC_DWORD_STAT_BY(STAT_FPSLiveProjectiles, Stats.Active);
+    Stats = FProjectilePoolStats();
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 预热：补足空闲列表，使其至少包含 Count 枚子弹
+// ------------------------------------------------------------------
+void UProjectilePoolSubsystem::Prewarm(TSubclassOf<AProjetileActor> ProjectileClass, int32 Count)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    if (!ProjectileClass)
+    {
+        return;
+    }
+
+    FProjectilePoolBucket& Bucket = Buckets.FindOrAdd(ProjectileClass.Get());
+    Bucket.FreeList.Reserve(Count);
+
+    while (Bucket.FreeList.Num() < Count)
+    {
+        AProjetileActor* Projectile = SpawnPooledProjectile(ProjectileClass.Get());
+        if (!Projectile)
+        {
+            break;
+        }
+
+        Bucket.FreeList.Add(Projectile);
+        ++Stats.Prewarmed;
+    }
+}
+
+// ------------------------------------------------------------------
+// 取出：优先复用空闲子弹，空闲列表为空时才 SpawnActor
+// ------------------------------------------------------------------
+AProjetileActor* UProjectilePoolSubsystem::Acquire(TSubclassOf<AProjetileActor> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Owner, APawn* Instigator)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    if (!ProjectileClass)
+    {
+        return nullptr;
+    }
+
+    FProjectilePoolBucket& Bucket = Buckets.FindOrAdd(ProjectileClass.Get());
+
+    AProjetileActor* Projectile = nullptr;
+    while (!Projectile && Bucket.FreeList.Num() > 0)
+    {
+        // 被外部销毁的子弹（GC 后为空）直接丢弃
+        Projectile = Bucket.FreeList.Pop(EAllowShrinking::No);
+        if (!IsValid(Projectile))
+        {
+            Projectile = nullptr;
+        }
+    }
+
+    if (Projectile)
+    {
+        ++Stats.Hits;
+    }
+    else
+    {
+        Projectile = SpawnPooledProjectile(ProjectileClass.Get());
+        if (!Projectile)
+        {
+            return nullptr;
+        }
+        ++Stats.Misses;
+    }
+
+    // 传送到枪口位置，不扫掠、并重置物理状态
+    Projectile->SetActorLocationAndRotation(Location, Rotation, false, nullptr, ETeleportType::ResetPhysics);
+    Projectile->SetOwner(Owner);
+    Projectile->SetInstigator(Instigator);
+    Projectile->OnAcquiredFromPool();
+
+    ++Stats.Active;
+    INC_DWORD_STAT(STAT_FPSLiveProjectiles);
+    Stats.HighWaterMark = FMath::Max(Stats.HighWaterMark, Stats.Active);
+
+    return Projectile;
+}
+
+// ------------------------------------------------------------------
+// 归还：关闭子弹并放回对应类的空闲列表
+// ------------------------------------------------------------------
+void UProjectilePoolSubsystem::Release(AProjetileActor* Projectile)
+{
+    if (!IsValid(Projectile) || Projectile->IsInPool())
+    {
+        return;
+    }
+
+    Projectile->OnReleasedToPool();
+    Projectile->SetOwner(nullptr);
+    Projectile->SetInstigator(nullptr);
+
+    --Stats.Active;
+    DEC_DWORD_STAT(STAT_FPSLiveProjectiles);
+
+    // 所属类已被清空：不再回收
+    FProjectilePoolBucket* Bucket = Buckets.Find(Projectile->GetClass());
+    if (!Bucket)
+    {
+        Projectile->Destroy();
+        return;
+    }
+
+    Bucket->FreeList.Add(Projectile);
+}
+
+// ------------------------------------------------------------------
+// 清空：销毁空闲子弹并移除该类的空闲列表
+// ------------------------------------------------------------------
+void UProjectilePoolSubsystem::Drain(TSubclassOf<AProjetileActor> ProjectileClass)
+{
+    FProjectilePoolBucket* Bucket = ProjectileClass ? Buckets.Find(ProjectileClass.Get()) : nullptr;
+    if (!Bucket)
+    {
+        return;
+    }
+
+    for (AProjetileActor* Projectile : Bucket->FreeList)
+    {
+        if (IsValid(Projectile))
+        {
+            Projectile->Destroy();
+        }
+    }
+
+    Buckets.Remove(ProjectileClass.Get());
+}
+
+void UProjectilePoolSubsystem::LogStats() const
+{
+    int32 Pooled = 0;
+    for (const TPair<TObjectPtr<UClass>, FProjectilePoolBucket>& Pair : Buckets)
+    {
+        Pooled += Pair.Value.FreeList.Num();
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("ProjectilePool: Hits=%d Misses=%d Prewarmed=%d Active=%d HighWaterMark=%d Pooled=%d"),
+        Stats.Hits, Stats.Misses, Stats.Prewarmed, Stats.Active, Stats.HighWaterMark, Pooled);
+}
+
+// ------------------------------------------------------------------
+// 生成一枚新子弹并立即置为池中状态
+// ------------------------------------------------------------------
+AProjetileActor* UProjectilePoolSubsystem::SpawnPooledProjectile(UClass* ProjectileClass)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    SpawnParams.ObjectFlags |= RF_Transient;
+
+    AProjetileActor* Projectile = nullptr;
+    {
+        FPS_SOAK_PROBE(SpawnActor);
+        FPS_SCOPE_CYCLE_COUNTER(STAT_FPSProjectileSpawn);
+        Projectile = World->SpawnActor<AProjetileActor>(ProjectileClass, FTransform::Identity, SpawnParams);
+    }
+    if (Projectile)
+    {
+        Projectile->OnReleasedToPool();
+    }
+    return Projectile;
+}
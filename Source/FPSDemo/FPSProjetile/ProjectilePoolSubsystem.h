@@ -0,0 +1,88 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectilePoolSubsystem.generated.h"
+
+class AProjetileActor;
+
+/**
+ * 对象池统计数据。
+ * Hits：直接从空闲列表取出的次数；Misses：空闲列表为空、不得不 SpawnActor 的次数；
+ * HighWaterMark：同时处于激活状态的子弹数量峰值。
+ */
+struct FProjectilePoolStats
+{
+    int32 Hits = 0;
+    int32 Misses = 0;
+    int32 Prewarmed = 0;
+    int32 Active = 0;
+    int32 HighWaterMark = 0;
+};
+
+/* 单个子弹类对应的空闲列表。 */
+USTRUCT()
+struct FProjectilePoolBucket
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<TObjectPtr<AProjetileActor>> FreeList;
+};
+
+/**
+ * UProjectilePoolSubsystem
+ * 世界级子弹对象池。
+ * 射击时从池中取出（Acquire）已构建好的子弹 Actor，命中或寿命结束后归还（Release），
+ * 稳定射击状态下不再调用 SpawnActor/Destroy，避免组件构建、物理注册以及 GC 压力。
+ */
+UCLASS()
+class FPSDEMO_API UProjectilePoolSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * 预热：提前生成指定数量的子弹并放入空闲列表。
+     * @param ProjectileClass 子弹类
+     * @param Count           期望空闲列表中至少拥有的数量
+     */
+    void Prewarm(TSubclassOf<AProjetileActor> ProjectileClass, int32 Count);
+
+    /**
+     * 从池中取出一枚子弹并放置到指定位置，空闲列表为空时才会生成新 Actor。
+     * @return 已激活的子弹；生成失败时返回 nullptr
+     */
+    AProjetileActor* Acquire(TSubclassOf<AProjetileActor> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Owner, APawn* Instigator);
+
+    /* 将子弹归还到池中（隐藏、关闭碰撞与移动）。重复归还会被忽略。 */
+    void Release(AProjetileActor* Projectile);
+
+    /**
+     * 清空某个子弹类：销毁其空闲子弹，之后归还的在途子弹也直接销毁（除非该类再次被取出）。
+     * 武器卸下后调用，使子弹类及其资源可以被卸载。
+     */
+    void Drain(TSubclassOf<AProjetileActor> ProjectileClass);
+
+    /* 获取统计数据 */
+    const FProjectilePoolStats& GetStats() const { return Stats; }
+
+    /* 将统计数据输出到日志 */
+    void LogStats() const;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 生成一枚处于池中（未激活）状态的子弹 */
+    AProjetileActor* SpawnPooledProjectile(UClass* ProjectileClass);
+
+    /* 按子弹类划分的空闲列表 */
+    UPROPERTY()
+    TMap<TObjectPtr<UClass>, FProjectilePoolBucket> Buckets;
+
+    FProjectilePoolStats Stats;
+};
@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSProjetile/ProjectileVisualSubsystem.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarInstancedVisuals(
+    TEXT("fps.Projectile.InstancedVisuals"),
+    0,
+    TEXT("1：子弹外观由每个世界共享的实例化网格组件绘制（每帧一次批量更新）；0：每枚子弹使用自身的网格组件。对之后发射的子弹生效。"),
+    ECVF_Default);
+
+bool UProjectileVisualSubsystem::IsInstancedVisualsEnabled()
+{
+    return CVarInstancedVisuals.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UProjectileVisualSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+// ------------------------------------------------------------------
+// 开始游戏：在世界每帧的末尾（弹道子系统移动子弹之后）写入实例变换
+// ------------------------------------------------------------------
+void UProjectileVisualSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UProjectileVisualSubsystem::OnWorldPostActorTick);
+}
+
+void UProjectileVisualSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    for (FProjectileVisualBatch& Batch : Batches)
+    {
+        for (AProjetileActor* Projectile : Batch.Owners)
+        {
+            if (Projectile)
+            {
+                Projectile->VisualBatch = INDEX_NONE;
+                Projectile->VisualSlot = INDEX_NONE;
+            }
+        }
+    }
+
+    Batches.Empty();
+    BatchByMesh.Empty();
+    VisualActor = nullptr;
+    NumInstances = 0;
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 分配槽位：优先复用空闲槽位，否则追加实例
+// ------------------------------------------------------------------
+bool UProjectileVisualSubsystem::Register(AProjetileActor* Projectile)
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    check(Projectile);
+    Unregister(Projectile);
+
+    UStaticMesh* Mesh = Projectile->ProjectileMeshComponent ? Projectile->ProjectileMeshComponent->GetStaticMesh() : nullptr;
+    if (!Mesh || IsRunningDedicatedServer())
+    {
+        return false;
+    }
+
+    const int32 BatchIndex = FindOrAddBatch(Mesh, Projectile);
+    if (BatchIndex == INDEX_NONE)
+    {
+        return false;
+    }
+
+    FProjectileVisualBatch& Batch = Batches[BatchIndex];
+    int32 Slot = INDEX_NONE;
+    if (Batch.FreeSlots.Num() > 0)
+    {
+        Slot = Batch.FreeSlots.Pop(EAllowShrinking::No);
+        Batch.Owners[Slot] = Projectile;
+    }
+    else
+    {
+        // 新实例的变换在本帧末统一写入
+        Slot = Batch.Component->AddInstance(FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector), true);
+        check(Slot == Batch.Owners.Num());
+        Batch.Owners.Add(Projectile);
+    }
+
+    Projectile->VisualBatch = BatchIndex;
+    Projectile->VisualSlot = Slot;
+    ++NumInstances;
+    return true;
+}
+
+void UProjectileVisualSubsystem::Unregister(AProjetileActor* Projectile)
+{
+    if (!Projectile || !Batches.IsValidIndex(Projectile->VisualBatch))
+    {
+        return;
+    }
+
+    FProjectileVisualBatch& Batch = Batches[Projectile->VisualBatch];
+    check(Batch.Owners[Projectile->VisualSlot] == Projectile);
+    Batch.Owners[Projectile->VisualSlot] = nullptr;
+    Batch.FreeSlots.Add(Projectile->VisualSlot);
+    Batch.bDirty = true;
+
+    Projectile->VisualBatch = INDEX_NONE;
+    Projectile->VisualSlot = INDEX_NONE;
+    --NumInstances;
+}
+
+// ------------------------------------------------------------------
+// 批次：每种网格一个实例组件，材质取自第一枚使用该网格的子弹
+// ------------------------------------------------------------------
+int32 UProjectileVisualSubsystem::FindOrAddBatch(UStaticMesh* Mesh, const AProjetileActor* Projectile)
+{
+    if (const int32* Existing = BatchByMesh.Find(Mesh))
+    {
+        return *Existing;
+    }
+
+    UWorld* World = GetWorld();
+    if (!VisualActor)
+    {
+        FActorSpawnParameters SpawnParams;
+        SpawnParams.Name = TEXT("ProjectileVisuals");
+        SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+        SpawnParams.ObjectFlags |= RF_Transient;
+        VisualActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+        if (!VisualActor)
+        {
+            return INDEX_NONE;
+        }
+    }
+
+    const UStaticMeshComponent* Source = Projectile->ProjectileMeshComponent;
+
+    UInstancedStaticMeshComponent* Component = NewObject<UInstancedStaticMeshComponent>(VisualActor, NAME_None, RF_Transient);
+    Component->SetMobility(EComponentMobility::Movable);
+    Component->SetStaticMesh(Mesh);
+    for (int32 MaterialIndex = 0; MaterialIndex < Source->GetNumMaterials(); ++MaterialIndex)
+    {
+        Component->SetMaterial(MaterialIndex, Source->GetMaterial(MaterialIndex));
+    }
+    Component->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    Component->SetCanEverAffectNavigation(false);
+    Component->SetCastShadow(Source->CastShadow);
+    if (!VisualActor->GetRootComponent())
+    {
+        VisualActor->SetRootComponent(Component);
+    }
+    else
+    {
+        Component->SetupAttachment(VisualActor->GetRootComponent());
+    }
+    Component->RegisterComponent();
+    VisualActor->AddInstanceComponent(Component);
+
+    FProjectileVisualBatch& Batch = Batches.AddDefaulted_GetRef();
+    Batch.Component = Component;
+
+    const int32 BatchIndex = Batches.Num() - 1;
+    BatchByMesh.Add(Mesh, BatchIndex);
+    return BatchIndex;
+}
+
+// ------------------------------------------------------------------
+// 每帧末：每个批次一次 BatchUpdateInstancesTransforms，空闲槽位缩放为 0
+// ------------------------------------------------------------------
+void UProjectileVisualSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld != GetWorld() || Batches.Num() == 0)
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSProjectileVisualUpdate);
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+    FPS_ALLOC_SCOPE(Shot);
+
+    const FTransform HiddenTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector);
+
+    for (FProjectileVisualBatch& Batch : Batches)
+    {
+        const int32 NumSlots = Batch.Owners.Num();
+        if (!Batch.Component || NumSlots == 0 || (NumSlots == Batch.FreeSlots.Num() && !Batch.bDirty))
+        {
+            continue;
+        }
+
+        Batch.Transforms.SetNumUninitialized(NumSlots, EAllowShrinking::No);
+        for (int32 Slot = 0; Slot < NumSlots; ++Slot)
+        {
+            const AProjetileActor* Projectile = Batch.Owners[Slot];
+
+            // 网格组件已注销，其世界变换不再更新，需由 Actor 变换与相对变换合成
+            Batch.Transforms[Slot] = Projectile
+                ? Projectile->ProjectileMeshComponent->GetRelativeTransform() * Projectile->GetActorTransform()
+                : HiddenTransform;
+        }
+
+        Batch.Component->BatchUpdateInstancesTransforms(0, Batch.Transforms, true, true, false);
+        Batch.bDirty = false;
+    }
+
+    SET_DWORD_STAT(STAT_FPSProjectileVisualInstances, NumInstances);
+}
@@ -0,0 +1,96 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProjectileVisualSubsystem.generated.h"
+
+class AActor;
+class AProjetileActor;
+class UInstancedStaticMeshComponent;
+class UStaticMesh;
+
+/* 使用同一网格的子弹共享的实例化组件及其槽位。 */
+USTRUCT()
+struct FProjectileVisualBatch
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TObjectPtr<UInstancedStaticMeshComponent> Component;
+
+    /* 每个实例槽位对应的子弹，空闲槽位为空 */
+    UPROPERTY()
+    TArray<TObjectPtr<AProjetileActor>> Owners;
+
+    /* 可复用的空闲槽位 */
+    TArray<int32> FreeSlots;
+
+    /* 每帧复用的实例变换 */
+    TArray<FTransform> Transforms;
+
+    /* 有槽位被释放，需要在下一次更新中把它缩放为 0 */
+    bool bDirty = false;
+};
+
+/**
+ * UProjectileVisualSubsystem
+ * 子弹外观的实例化渲染路径（fps.Projectile.InstancedVisuals）。
+ * 每个世界为每种子弹网格持有一个 UInstancedStaticMeshComponent，发射的子弹占用其中一个实例槽位，
+ * 自身的 ProjectileMeshComponent 注销且不再创建场景代理。每帧末一次性批量写入所有实例变换；
+ * 子弹回收时槽位缩放为 0 并放入空闲列表，供下一发子弹复用，实例数量只增不减，不会触发实例重排。
+ * 专用服务器上不创建实例组件，子弹保持原有组件。
+ *
+ * 度量（-nullrhi 下同样有效）：stat FPSDemo 中的 Projectile Visual Update（批量更新耗时）、
+ * Projectile Visibility Toggle 与 Projectile Render State Changes（逐子弹组件的渲染状态重建）。
+ */
+UCLASS()
+class FPSDEMO_API UProjectileVisualSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* 子弹外观是否使用实例化渲染（fps.Projectile.InstancedVisuals） */
+    static bool IsInstancedVisualsEnabled();
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    /**
+     * 为子弹分配实例槽位。已占用槽位的子弹先释放旧槽位（网格可能已随弹道配置改变）。
+     * @return 是否由实例组件显示；返回 false 时子弹应使用自身的网格组件
+     */
+    bool Register(AProjetileActor* Projectile);
+
+    /* 释放子弹的实例槽位 */
+    void Unregister(AProjetileActor* Projectile);
+
+    /* 当前占用的实例数量 */
+    int32 GetNumInstances() const { return NumInstances; }
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /* 每帧末：批量写入实例变换 */
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+    /* 查找或创建某个网格的批次 */
+    int32 FindOrAddBatch(UStaticMesh* Mesh, const AProjetileActor* Projectile);
+
+    /* 承载实例组件的 Actor，按需生成 */
+    UPROPERTY(Transient)
+    TObjectPtr<AActor> VisualActor;
+
+    UPROPERTY(Transient)
+    TArray<FProjectileVisualBatch> Batches;
+
+    /* 网格到批次下标 */
+    UPROPERTY(Transient)
+    TMap<TObjectPtr<UStaticMesh>, int32> BatchByMesh;
+
+    int32 NumInstances = 0;
+
+    FDelegateHandle PostActorTickHandle;
+};
@@ -2,15 +2,35 @@
 
 #include "FPSProjetile/ProjetileActor.h"
 #include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/ProjectileMovementComponent.h"
+#include "FPSProjetile/ProjectilePoolSubsystem.h"
+#include "FPSProjetile/ProjectileBallisticsSubsystem.h"
+#include "FPSProjetile/ProjectileImpulseSubsystem.h"
+#include "FPSProjetile/ProjectileVisualSubsystem.h"
+#include "FPSSignificance/FPSTickSignificanceSubsystem.h"
+#include "FPSWeapon/FPSBallisticProfile.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSBenchmark/FPSSoakProbes.h"
+#include "FPSDemoStats.h"
+#include "FPSDemoMemory.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "TimerManager.h"
 
 // ------------------------------------------------------------------
 // 构造函数：初始化默认组件与属性
 // ------------------------------------------------------------------
 AProjetileActor::AProjetileActor()
 {
-    // 允许 Tick 函数每帧调用；若不需要可关闭以提升性能
-    PrimaryActorTick.bCanEverTick = true;
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+
+    // 子弹本身没有逐帧逻辑，关闭 Actor Tick；运动由移动组件或弹道子系统驱动
+    PrimaryActorTick.bCanEverTick = false;
+
+    // 子弹不作为 Actor 复制：服务器与各客户端根据开火批次 RPC 各自从本地对象池生成
+    bReplicates = false;
 
     /* ---------------- 碰撞组件 ---------------- */
     if (!CollisionComponent)
@@ -56,6 +76,8 @@ AProjetileActor::AProjetileActor()
     }
 
     /* ---------------- 网格组件 ---------------- */
+    // 纯外观组件：服务器版本不创建（非服务器版本以 -server 运行时在 PostInitializeComponents 中移除）
+#if !UE_SERVER
     ProjectileMeshComponent = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("ProjectileMeshComponent"));
 
     // 网格默认缩放：略小于单位大小（9%）
@@ -63,9 +85,24 @@ AProjetileActor::AProjetileActor()
 
     // 将网格附加到根组件（碰撞球体）
     ProjectileMeshComponent->SetupAttachment(RootComponent);
+#endif
+
+    // 生命周期：子弹激活 3 秒后自动回收到对象池，防止残留
+    ProjectileLifeSpan = 3.0f;
+}
+
+// ------------------------------------------------------------------
+// 生命周期：专用服务器上不渲染，移除网格组件（对象池中的子弹只在生成时做一次）
+// ------------------------------------------------------------------
+void AProjetileActor::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
 
-    // 生命周期：子弹生成 3 秒后自动销毁，防止残留
-    InitialLifeSpan = 3.0f;
+    if (ProjectileMeshComponent && IsNetMode(NM_DedicatedServer))
+    {
+        ProjectileMeshComponent->DestroyComponent();
+        ProjectileMeshComponent = nullptr;
+    }
 }
 
 // ------------------------------------------------------------------
@@ -77,11 +114,21 @@ void AProjetileActor::BeginPlay()
 }
 
 // ------------------------------------------------------------------
-// 每帧调用，可在此实现持续逻辑（尾迹、计时器等）
+// 生命周期：销毁或关卡结束时调用
 // ------------------------------------------------------------------
-void AProjetileActor::Tick(float DeltaTime)
+void AProjetileActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-    Super::Tick(DeltaTime);
+    UnregisterTickSignificance();
+
+    if (VisualBatch != INDEX_NONE)
+    {
+        if (UProjectileVisualSubsystem* Visuals = GetWorld()->GetSubsystem<UProjectileVisualSubsystem>())
+        {
+            Visuals->Unregister(this);
+        }
+    }
+
+    Super::EndPlay(EndPlayReason);
 }
 
 // ------------------------------------------------------------------
@@ -90,7 +137,43 @@ void AProjetileActor::Tick(float DeltaTime)
 // ------------------------------------------------------------------
 void AProjetileActor::ShootInDirection(const FVector& ShootDirection)
 {
+    ShootInDirectionAt(ShootDirection, GetWorld()->GetTimeSeconds());
+}
+
+// ------------------------------------------------------------------
+// 发射接口：带开火时间戳
+// @param ShootDirection 归一化的方向向量
+// @param LaunchTime     开火时的世界时间
+// ------------------------------------------------------------------
+void AProjetileActor::ShootInDirectionAt(const FVector& ShootDirection, double LaunchTime)
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSProjectileShootInDirection);
+
     ProjectileMovementComponent->Velocity = ShootDirection * ProjectileMovementComponent->InitialSpeed;
+
+    UpdateVisualMode();
+
+    // 启用批量弹道时，交由子系统积分与扫掠，关闭自身移动组件；寿命也改由子系统统一倒计时
+    if (UProjectileBallisticsSubsystem::IsBatchedBallisticsEnabled())
+    {
+        if (UProjectileBallisticsSubsystem* Ballistics = GetWorld()->GetSubsystem<UProjectileBallisticsSubsystem>())
+        {
+            ProjectileMovementComponent->Deactivate();
+            GetWorldTimerManager().ClearTimer(LifeSpanTimerHandle);
+            Ballistics->Unregister(this);
+            Ballistics->Register(this, ProjectileMovementComponent->Velocity, ProjectileLifeSpan, LaunchTime);
+        }
+    }
+
+    // 由自身移动组件驱动时，其 Tick 频率交给重要度子系统调度（批量弹道在子系统内按槽位降频）
+    if (BallisticsSlot == INDEX_NONE && !bTickSignificance)
+    {
+        if (UFPSTickSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>())
+        {
+            Significance->RegisterProjectile(this);
+            bTickSignificance = true;
+        }
+    }
 }
 
 // ------------------------------------------------------------------
@@ -103,13 +186,237 @@ void AProjetileActor::ShootInDirection(const FVector& ShootDirection)
 // ------------------------------------------------------------------
 void AProjetileActor::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit)
 {
-    // 避免自身碰撞；若被击中组件具有物理模拟，则施加冲击力
-    if (OtherActor != this && OtherComponent->IsSimulatingPhysics())
+    FPS_SOAK_PROBE(OnHit);
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSProjectileOnHit);
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+    FPS_ALLOC_SCOPE(Shot);
+    INC_DWORD_STAT(STAT_FPSHits);
+
+    // 避免自身碰撞；若被击中组件具有物理模拟，则施加冲击力（纯表现子弹不施加）
+    if (OtherActor != this && !bCosmeticOnly)
+    {
+        ApplyHitImpulse(OtherComponent, ProjectileMovementComponent->Velocity, Hit.ImpactPoint);
+    }
+
+    // 伤害、得分与表现由命中事件总线在帧末整批处理；纯表现子弹的事件只用于表现
+    if (OtherActor != this)
+    {
+        const FVector& Velocity = ProjectileMovementComponent->Velocity;
+
+        FFPSHitEvent Event;
+        Event.Kind = Cast<APawn>(OtherActor) ? EFPSHitEventKind::CharacterHit : EFPSHitEventKind::WorldHit;
+        Event.Source = EFPSHitEventSource::Projectile;
+        Event.bCosmetic = bCosmeticOnly;
+        Event.Instigator = GetInstigator();
+        Event.HitActor = OtherActor;
+        Event.HitComponent = OtherComponent;
+        Event.BoneName = Hit.BoneName;
+        Event.Location = Hit.ImpactPoint;
+        Event.Direction = Velocity.GetSafeNormal();
+        Event.Magnitude = Velocity.Size();
+        Event.Damage = HitDamage;
+        UFPSHitEventSubsystem::Push(GetWorld(), MoveTemp(Event));
+    }
+
+    // 命中后无论是否造成伤害，均立即回收子弹
+    ReturnToPool();
+}
+
+// ------------------------------------------------------------------
+// 命中冲量：使用速度向量作为冲量方向，乘以 HitImpulseScale 作为力度
+// 默认交给冲量子系统按刚体合并，在物理线程批量施加
+// ------------------------------------------------------------------
+void AProjetileActor::ApplyHitImpulse(UPrimitiveComponent* HitComponent, const FVector& Velocity, const FVector& ImpactPoint)
+{
+    if (!HitComponent || !HitComponent->IsSimulatingPhysics())
+    {
+        return;
+    }
+
+    INC_DWORD_STAT(STAT_FPSImpulsesApplied);
+    const FVector Impulse = Velocity * HitImpulseScale;
+
+    if (UProjectileImpulseSubsystem::IsBatchedImpulsesEnabled())
+    {
+        UProjectileImpulseSubsystem* Impulses = HitComponent->GetWorld()->GetSubsystem<UProjectileImpulseSubsystem>();
+        if (Impulses && Impulses->QueueImpulse(HitComponent, Impulse, ImpactPoint))
+        {
+            return;
+        }
+    }
+
+    HitComponent->AddImpulseAtLocation(Impulse, ImpactPoint);
+}
+
+// ------------------------------------------------------------------
+// 对象池回调：激活子弹
+// ------------------------------------------------------------------
+void AProjetileActor::OnAcquiredFromPool()
+{
+    bInPool = false;
+
+    SetPooledVisibility(true);
+    SetActorEnableCollision(true);
+
+    // 重置弹跳状态：恢复弹道配置（或类默认）的弹跳参数，并重新绑定被 StopSimulating 清空的更新组件
+    const AProjetileActor* Defaults = GetClass()->GetDefaultObject<AProjetileActor>();
+    ProjectileMovementComponent->bShouldBounce = BallisticProfile ? BallisticProfile->bShouldBounce : Defaults->ProjectileMovementComponent->bShouldBounce;
+    ProjectileMovementComponent->Bounciness = BallisticProfile ? BallisticProfile->Bounciness : Defaults->ProjectileMovementComponent->Bounciness;
+    ProjectileMovementComponent->SetUpdatedComponent(CollisionComponent);
+    ProjectileMovementComponent->Velocity = FVector::ZeroVector;
+    ProjectileMovementComponent->Activate(true);
+
+    // 寿命到期后回收
+    GetWorldTimerManager().SetTimer(LifeSpanTimerHandle, this, &AProjetileActor::ReturnToPool, ProjectileLifeSpan, false);
+}
+
+// ------------------------------------------------------------------
+// 对象池回调：关闭子弹
+// ------------------------------------------------------------------
+void AProjetileActor::OnReleasedToPool()
+{
+    bInPool = true;
+    bCosmeticOnly = false;
+
+    GetWorldTimerManager().ClearTimer(LifeSpanTimerHandle);
+
+    if (BallisticsSlot != INDEX_NONE)
+    {
+        GetWorld()->GetSubsystem<UProjectileBallisticsSubsystem>()->Unregister(this);
+    }
+
+    UnregisterTickSignificance();
+
+    // 停止移动并关闭组件；若正处于移动组件的 Tick 中（OnHit），HasStoppedSimulation() 会让其立即退出
+    ProjectileMovementComponent->StopMovementImmediately();
+    ProjectileMovementComponent->Deactivate();
+
+    if (VisualBatch != INDEX_NONE)
+    {
+        GetWorld()->GetSubsystem<UProjectileVisualSubsystem>()->Unregister(this);
+    }
+
+    SetActorEnableCollision(false);
+    SetPooledVisibility(false);
+}
+
+// ------------------------------------------------------------------
+// 从重要度子系统注销，恢复移动组件每帧 Tick
+// ------------------------------------------------------------------
+void AProjetileActor::UnregisterTickSignificance()
+{
+    if (!bTickSignificance)
+    {
+        return;
+    }
+
+    if (UFPSTickSignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UFPSTickSignificanceSubsystem>())
+    {
+        Significance->UnregisterProjectile(this);
+    }
+    bTickSignificance = false;
+}
+
+// ------------------------------------------------------------------
+// 外观模式：实例化时注销自身网格组件（不再有场景代理），否则确保其已注册
+// 网格组件在池中保持注销状态，之后的取出/归还不再重建其渲染状态
+// ------------------------------------------------------------------
+void AProjetileActor::UpdateVisualMode()
+{
+    if (!ProjectileMeshComponent)
+    {
+        return;
+    }
+
+    UProjectileVisualSubsystem* Visuals = UProjectileVisualSubsystem::IsInstancedVisualsEnabled()
+        ? GetWorld()->GetSubsystem<UProjectileVisualSubsystem>()
+        : nullptr;
+
+    if (Visuals && Visuals->Register(this))
+    {
+        if (ProjectileMeshComponent->IsRegistered())
+        {
+            ProjectileMeshComponent->UnregisterComponent();
+        }
+        return;
+    }
+
+    if (VisualBatch != INDEX_NONE)
+    {
+        GetWorld()->GetSubsystem<UProjectileVisualSubsystem>()->Unregister(this);
+    }
+    if (!ProjectileMeshComponent->IsRegistered())
+    {
+        ProjectileMeshComponent->RegisterComponent();
+    }
+}
+
+void AProjetileActor::SetPooledVisibility(bool bVisible)
+{
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSProjectileVisibility);
+
+    // 已注册的网格组件会随隐藏状态的改变销毁并重建场景代理
+    if (ProjectileMeshComponent && ProjectileMeshComponent->IsRegistered())
+    {
+        INC_DWORD_STAT(STAT_FPSProjectileRenderStateChanges);
+    }
+
+    SetActorHiddenInGame(!bVisible);
+}
+
+// ------------------------------------------------------------------
+// 结束子弹：优先归还对象池
+// ------------------------------------------------------------------
+void AProjetileActor::ReturnToPool()
+{
+    LLM_SCOPE_BYTAG(FPSDemo_Projectile);
+    FPS_ALLOC_SCOPE(Shot);
+
+    if (UProjectilePoolSubsystem* Pool = GetWorld()->GetSubsystem<UProjectilePoolSubsystem>())
+    {
+        Pool->Release(this);
+    }
+    else
+    {
+        Destroy();
+    }
+}
+
+// ------------------------------------------------------------------
+// 弹道配置：覆盖构造函数中的默认值；配置为空时恢复类默认值
+// ------------------------------------------------------------------
+void AProjetileActor::ApplyBallisticProfile(const UFPSBallisticProfile* Profile)
+{
+    if (Profile == BallisticProfile)
+    {
+        return;
+    }
+    BallisticProfile = Profile;
+
+    const AProjetileActor* Defaults = GetClass()->GetDefaultObject<AProjetileActor>();
+    const UProjectileMovementComponent* DefaultMovement = Defaults->ProjectileMovementComponent;
+
+    ProjectileMovementComponent->InitialSpeed = Profile ? Profile->InitialSpeed : DefaultMovement->InitialSpeed;
+    ProjectileMovementComponent->MaxSpeed = Profile ? Profile->MaxSpeed : DefaultMovement->MaxSpeed;
+    ProjectileMovementComponent->ProjectileGravityScale = Profile ? Profile->GravityScale : DefaultMovement->ProjectileGravityScale;
+    ProjectileMovementComponent->bShouldBounce = Profile ? Profile->bShouldBounce : DefaultMovement->bShouldBounce;
+    ProjectileMovementComponent->Bounciness = Profile ? Profile->Bounciness : DefaultMovement->Bounciness;
+    ProjectileLifeSpan = Profile ? Profile->LifeSpan : Defaults->ProjectileLifeSpan;
+    HitDamage = Profile ? Profile->Damage : Defaults->HitDamage;
+
+    CollisionComponent->SetSphereRadius(Profile ? Profile->CollisionRadius : Defaults->CollisionComponent->GetUnscaledSphereRadius());
+
+    // 网格由武器的 "Equipped" 资产包加载；未配置或尚未加载时保留类自身的网格
+    if (ProjectileMeshComponent && Defaults->ProjectileMeshComponent)
     {
-        // 使用当前速度向量作为冲量方向，乘以 100 作为力度
-        OtherComponent->AddImpulseAtLocation(ProjectileMovementComponent->Velocity * 100.0f, Hit.ImpactPoint);
+        UStaticMesh* Mesh = Profile ? Profile->Mesh.Get() : nullptr;
+        ProjectileMeshComponent->SetStaticMesh(Mesh ? Mesh : Defaults->ProjectileMeshComponent->GetStaticMesh().Get());
+        ProjectileMeshComponent->SetRelativeScale3D(Profile ? Profile->MeshScale : Defaults->ProjectileMeshComponent->GetRelativeScale3D());
     }
 
-    // 命中后无论是否造成伤害，均立即销毁子弹
-    Destroy();
-}
\ No newline at end of file
+    // 寿命计时器已按旧寿命启动时重新计时
+    if (GetWorldTimerManager().IsTimerActive(LifeSpanTimerHandle))
+    {
+        GetWorldTimerManager().SetTimer(LifeSpanTimerHandle, this, &AProjetileActor::ReturnToPool, ProjectileLifeSpan, false);
+    }
+}
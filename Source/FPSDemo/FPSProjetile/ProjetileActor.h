@@ -6,6 +6,8 @@
 #include "GameFramework/Actor.h"
 #include "ProjetileActor.generated.h"
 
+class UFPSBallisticProfile;
+
 /**
  * AProjetileActor
  * 负责表现一枚可发射的子弹（Projectile）。
@@ -28,17 +30,19 @@ public:
     UPROPERTY(VisibleAnywhere, Category = "Components")
     class UProjectileMovementComponent* ProjectileMovementComponent;
 
-    /* 静态网格组件，负责子弹的外观表现。可在蓝图内替换为任意模型。 */
+    /* 静态网格组件，负责子弹的外观表现。可在蓝图内替换为任意模型。专用服务器上为空。 */
     UPROPERTY(EditAnywhere, Category = "Components")
     class UStaticMeshComponent* ProjectileMeshComponent;
 
 protected:
+    /* 生命周期函数：组件初始化完成后调用，专用服务器上在此移除外观组件。 */
+    virtual void PostInitializeComponents() override;
+
     /* 生命周期函数：当Actor生成或关卡开始时调用。 */
     virtual void BeginPlay() override;
 
-public:
-    /* 每帧调用，用于持续逻辑（如轨迹特效、计时器等）。 */
-    virtual void Tick(float DeltaTime) override;
+    /* 生命周期函数：销毁或关卡结束时释放实例化外观的槽位。 */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
     /**
@@ -48,6 +52,14 @@ public:
     UFUNCTION()
     void ShootInDirection(const FVector& ShootDirection);
 
+    /**
+     * 以指定的开火时间发射子弹。
+     * 同一帧内由开火调度器补发的子弹，开火时间早于本帧结束，弹道子系统会补足这段已飞行的时间。
+     * @param ShootDirection 归一化的发射方向向量。
+     * @param LaunchTime     开火时的世界时间（秒）。
+     */
+    void ShootInDirectionAt(const FVector& ShootDirection, double LaunchTime);
+
     /**
      * 碰撞回调：当子弹击中世界中的某个对象时触发。
      * @param HitComp      子弹自身的碰撞组件。
@@ -58,4 +70,90 @@ public:
      */
     UFUNCTION()
     void OnHit(class UPrimitiveComponent* HitComp, AActor* OtherActor, class UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
+
+public:
+    /* 命中冲量系数：冲量 = 子弹速度 × 该系数 */
+    static constexpr float HitImpulseScale = 100.0f;
+
+    /**
+     * 对被击中的组件施加子弹冲量（仅对模拟物理的组件生效）。
+     * 子弹命中与即时命中（Hitscan）共用，保证两种开火方式的物理表现一致。
+     * 启用 fps.Physics.BatchedImpulses 时冲量在下一次物理步进前才生效。
+     * @param HitComponent 被击中的组件
+     * @param Velocity     命中时的子弹速度
+     * @param ImpactPoint  命中点
+     */
+    static void ApplyHitImpulse(UPrimitiveComponent* HitComponent, const FVector& Velocity, const FVector& ImpactPoint);
+
+    /* 对象池回调：从池中取出时调用，恢复显示、碰撞、移动并开始寿命计时。 */
+    void OnAcquiredFromPool();
+
+    /* 对象池回调：归还到池中时调用，隐藏并关闭碰撞、移动与寿命计时。 */
+    void OnReleasedToPool();
+
+    /* 结束这枚子弹：存在对象池时归还，否则直接销毁。 */
+    void ReturnToPool();
+
+    /* 当前是否处于池中（未激活）状态 */
+    bool IsInPool() const { return bInPool; }
+
+    /**
+     * 设为纯表现子弹：客户端本地预测或根据服务器广播生成的子弹只负责显示，命中时不施加冲量，
+     * 权威的命中结果由服务器上的同一发子弹产生。归还对象池时自动清除。
+     */
+    void SetCosmeticOnly(bool bInCosmeticOnly) { bCosmeticOnly = bInCosmeticOnly; }
+    bool IsCosmeticOnly() const { return bCosmeticOnly; }
+
+    /**
+     * 应用弹道配置（速度、重力、反弹、半径、寿命、伤害与网格），为空时恢复子弹类的默认值。
+     * 与当前配置相同时直接返回，因此可在每次从对象池取出后调用。须在 ShootInDirection 之前调用。
+     */
+    void ApplyBallisticProfile(const UFPSBallisticProfile* Profile);
+
+protected:
+    /* 子弹寿命（秒）。由对象池计时回收，不使用 InitialLifeSpan（其到期会直接 Destroy）。 */
+    UPROPERTY(EditAnywhere, Category = "Projectile")
+    float ProjectileLifeSpan;
+
+public:
+    float GetProjectileLifeSpan() const { return ProjectileLifeSpan; }
+
+    /* 每次命中造成的伤害，由命中事件总线的 Damage 阶段结算 */
+    UPROPERTY(EditAnywhere, Category = "Projectile", meta = (ClampMin = "0.0"))
+    float HitDamage = 10.0f;
+
+private:
+    /* 寿命计时器 */
+    FTimerHandle LifeSpanTimerHandle;
+
+    /* 在 UProjectileBallisticsSubsystem 中的槽位，INDEX_NONE 表示由自身移动组件驱动 */
+    int32 BallisticsSlot = INDEX_NONE;
+    friend class UProjectileBallisticsSubsystem;
+
+    /* 在 UProjectileVisualSubsystem 中的批次与实例槽位，INDEX_NONE 表示由自身网格组件显示 */
+    int32 VisualBatch = INDEX_NONE;
+    int32 VisualSlot = INDEX_NONE;
+    friend class UProjectileVisualSubsystem;
+
+    /* 是否已登记到 UFPSTickSignificanceSubsystem（由自身移动组件驱动时） */
+    bool bTickSignificance = false;
+
+    /* 从 UFPSTickSignificanceSubsystem 注销 */
+    void UnregisterTickSignificance();
+
+    /* 按 fps.Projectile.InstancedVisuals 选择外观：实例槽位或自身网格组件 */
+    void UpdateVisualMode();
+
+    /* 显示/隐藏 Actor，并统计逐子弹网格组件的渲染状态重建 */
+    void SetPooledVisibility(bool bVisible);
+
+    /* 是否处于池中 */
+    bool bInPool = false;
+
+    /* 是否为纯表现子弹 */
+    bool bCosmeticOnly = false;
+
+    /* 当前应用的弹道配置，为空表示使用类默认值 */
+    UPROPERTY(Transient)
+    TObjectPtr<const UFPSBallisticProfile> BallisticProfile;
 };
\ No newline at end of file
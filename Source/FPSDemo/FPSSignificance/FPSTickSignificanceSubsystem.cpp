@@ -0,0 +1,468 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSSignificance/FPSTickSignificanceSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarSignificance(
+    TEXT("fps.Significance.Enable"),
+    1,
+    TEXT("1：按与视角的距离和可见性为角色与子弹分配 Tick 档位（每帧 / 每 N 帧 / 休眠）；0：全部每帧 Tick。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceNearDistance(
+    TEXT("fps.Significance.NearDistance"),
+    2000.0f,
+    TEXT("重要度距离小于该值（cm）的实体每帧 Tick。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceFarDistance(
+    TEXT("fps.Significance.FarDistance"),
+    6000.0f,
+    TEXT("重要度距离小于该值（cm）的实体每 fps.Significance.MidInterval 帧 Tick，更远的每 fps.Significance.FarInterval 帧。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceDormantDistance(
+    TEXT("fps.Significance.DormantDistance"),
+    12000.0f,
+    TEXT("重要度距离超过该值（cm）的模拟代理角色休眠：关闭 Actor Tick，移动组件按 fps.Significance.FarInterval 降频，位置仍由复制更新。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceOutOfViewScale(
+    TEXT("fps.Significance.OutOfViewScale"),
+    2.0f,
+    TEXT("视锥外的实体，其重要度距离为实际距离乘以该系数。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSignificanceViewCone(
+    TEXT("fps.Significance.ViewConeDegrees"),
+    100.0f,
+    TEXT("判定可见的视锥全角（度）。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceMidInterval(
+    TEXT("fps.Significance.MidInterval"),
+    2,
+    TEXT("中距离档位的 Tick 间隔（帧）。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSignificanceFarInterval(
+    TEXT("fps.Significance.FarInterval"),
+    4,
+    TEXT("远距离档位的 Tick 间隔（帧）。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Significance.Report
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GSignificanceReportCommand(
+    TEXT("fps.Significance.Report"),
+    TEXT("输出 Tick 重要度调度：各档位的实体数量、每帧 Tick 次数（对比全部每帧时）与 Actor Tick 阶段耗时。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSTickSignificanceSubsystem* Significance = World ? World->GetSubsystem<UFPSTickSignificanceSubsystem>() : nullptr)
+        {
+            Significance->LogReport();
+        }
+    }));
+
+bool UFPSTickSignificanceSubsystem::IsSignificanceEnabled()
+{
+    return CVarSignificance.GetValueOnGameThread() != 0;
+}
+
+// ------------------------------------------------------------------
+// 视角：本地玩家取相机；服务器上的远端玩家取其角色的眼睛位置与朝向（靠近玩家的实体更可能被看到或射击）
+// ------------------------------------------------------------------
+void UFPSTickSignificanceSubsystem::GatherViewpoints(const UWorld* World, TArray<FFPSViewpoint, TInlineAllocator<4>>& OutViewpoints)
+{
+    OutViewpoints.Reset();
+    if (!World)
+    {
+        return;
+    }
+
+    for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+    {
+        const APlayerController* PlayerController = It->Get();
+        if (!PlayerController)
+        {
+            continue;
+        }
+
+        if (PlayerController->IsLocalController())
+        {
+            if (PlayerController->PlayerCameraManager)
+            {
+                FFPSViewpoint& Viewpoint = OutViewpoints.AddDefaulted_GetRef();
+                Viewpoint.Location = PlayerController->PlayerCameraManager->GetCameraLocation();
+                Viewpoint.Direction = PlayerController->PlayerCameraManager->GetCameraRotation().Vector();
+            }
+        }
+        else if (const APawn* Pawn = PlayerController->GetPawn())
+        {
+            FFPSViewpoint& Viewpoint = OutViewpoints.AddDefaulted_GetRef();
+            Viewpoint.Location = Pawn->GetPawnViewLocation();
+            Viewpoint.Direction = Pawn->GetViewRotation().Vector();
+        }
+    }
+}
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UFPSTickSignificanceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UFPSTickSignificanceSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &UFPSTickSignificanceSubsystem::OnWorldPreActorTick);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UFPSTickSignificanceSubsystem::OnWorldPostActorTick);
+}
+
+void UFPSTickSignificanceSubsystem::Deinitialize()
+{
+    FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+
+    Characters.Empty();
+    CharacterStates.Empty();
+    Projectiles.Empty();
+    ProjectileIntervals.Empty();
+
+    Super::Deinitialize();
+}
+
+TStatId UFPSTickSignificanceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UFPSTickSignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UFPSTickSignificanceSubsystem::RegisterCharacter(AFPSCharacter* Character)
+{
+    if (Character && !Characters.Contains(Character))
+    {
+        Characters.Add(Character);
+        CharacterStates.AddDefaulted();
+    }
+}
+
+void UFPSTickSignificanceSubsystem::UnregisterCharacter(AFPSCharacter* Character)
+{
+    const int32 Index = Characters.Find(Character);
+    if (Index != INDEX_NONE)
+    {
+        Characters.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+        CharacterStates.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    }
+}
+
+void UFPSTickSignificanceSubsystem::RegisterProjectile(AProjetileActor* Projectile)
+{
+    if (Projectile && !Projectiles.Contains(Projectile))
+    {
+        Projectiles.Add(Projectile);
+        ProjectileIntervals.Add(1);
+    }
+}
+
+// 子弹会回到对象池再次使用：注销时恢复每帧 Tick，下一次发射从全速开始
+void UFPSTickSignificanceSubsystem::UnregisterProjectile(AProjetileActor* Projectile)
+{
+    const int32 Index = Projectiles.Find(Projectile);
+    if (Index == INDEX_NONE)
+    {
+        return;
+    }
+
+    if (UProjectileMovementComponent* Movement = Projectile->ProjectileMovementComponent)
+    {
+        ApplyInterval(Movement->PrimaryComponentTick, ProjectileIntervals[Index], 1, true);
+    }
+
+    Projectiles.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+    ProjectileIntervals.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+// ------------------------------------------------------------------
+// 档位：取各视角中最小的重要度距离（视锥外的距离放大），按阈值分档
+// ------------------------------------------------------------------
+uint8 UFPSTickSignificanceSubsystem::GetTickInterval(const FVector& Location, bool bAllowDormant) const
+{
+    if (!bActive || Viewpoints.Num() == 0)
+    {
+        return 1;
+    }
+
+    float Score = TNumericLimits<float>::Max();
+    for (const FFPSViewpoint& Viewpoint : Viewpoints)
+    {
+        const FVector Delta = Location - Viewpoint.Location;
+        const float Distance = Delta.Size();
+        const bool bInView = (Delta | Viewpoint.Direction) >= Settings.CosHalfViewCone * Distance;
+        Score = FMath::Min(Score, bInView ? Distance : Distance * Settings.OutOfViewScale);
+    }
+
+    if (Score < Settings.NearDistance)
+    {
+        return 1;
+    }
+    if (Score < Settings.FarDistance)
+    {
+        return Settings.MidInterval;
+    }
+    if (Score < Settings.DormantDistance || !bAllowDormant)
+    {
+        return Settings.FarInterval;
+    }
+    return DormantInterval;
+}
+
+void UFPSTickSignificanceSubsystem::AddBatchedTicks(int32 NumStepped, int32 NumTotal)
+{
+    PendingBatchedStepped += NumStepped;
+    PendingBatchedTotal += NumTotal;
+}
+
+// ------------------------------------------------------------------
+// 降频：TickInterval 取 (N - 0.5) 帧，提前半帧以免帧时间抖动时多等一帧；
+// 引擎把距上次 Tick 的累积时间作为 DeltaTime 传入，移动组件按其子步长补齐
+// ------------------------------------------------------------------
+float UFPSTickSignificanceSubsystem::ApplyInterval(FTickFunction& TickFunction, uint8 PreviousInterval, uint8 Interval, bool bForce) const
+{
+    if (Interval == DormantInterval)
+    {
+        if (PreviousInterval != DormantInterval)
+        {
+            TickFunction.SetTickFunctionEnable(false);
+        }
+        return 0.0f;
+    }
+
+    if (PreviousInterval == DormantInterval)
+    {
+        TickFunction.SetTickFunctionEnable(true);
+    }
+
+    if (Interval != PreviousInterval || bForce)
+    {
+        TickFunction.UpdateTickIntervalAndCoolDown(Interval > 1 ? (Interval - 0.5f) * AppliedFrameSeconds : 0.0f);
+    }
+
+    return 1.0f / Interval;
+}
+
+void UFPSTickSignificanceSubsystem::ResetAll()
+{
+    for (int32 Index = 0; Index < Characters.Num(); ++Index)
+    {
+        AFPSCharacter* Character = Characters[Index];
+        if (!Character)
+        {
+            continue;
+        }
+
+        FCharacterTickState& State = CharacterStates[Index];
+        if (Character->PrimaryActorTick.bCanEverTick)
+        {
+            ApplyInterval(Character->PrimaryActorTick, State.ActorInterval, 1, true);
+        }
+        if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+        {
+            ApplyInterval(Movement->PrimaryComponentTick, State.MovementInterval, 1, true);
+        }
+        State = FCharacterTickState();
+    }
+
+    for (int32 Index = 0; Index < Projectiles.Num(); ++Index)
+    {
+        if (UProjectileMovementComponent* Movement = Projectiles[Index] ? Projectiles[Index]->ProjectileMovementComponent : nullptr)
+        {
+            ApplyInterval(Movement->PrimaryComponentTick, ProjectileIntervals[Index], 1, true);
+        }
+        ProjectileIntervals[Index] = 1;
+    }
+
+    Viewpoints.Reset();
+    LastIntervalHistogram.Reset();
+    LastTicks = 0.0f;
+    LastFullRateTicks = 0;
+}
+
+// ------------------------------------------------------------------
+// 每帧：收集视角 -> 为每个实体选择档位 -> 写入 Tick 函数 -> 统计
+// ------------------------------------------------------------------
+void UFPSTickSignificanceSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (!IsSignificanceEnabled())
+    {
+        if (bActive)
+        {
+            ResetAll();
+            bActive = false;
+        }
+        PendingBatchedStepped = 0;
+        PendingBatchedTotal = 0;
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSSignificance);
+    bActive = true;
+
+    Settings.NearDistance = CVarSignificanceNearDistance.GetValueOnGameThread();
+    Settings.FarDistance = FMath::Max(Settings.NearDistance, CVarSignificanceFarDistance.GetValueOnGameThread());
+    Settings.DormantDistance = FMath::Max(Settings.FarDistance, CVarSignificanceDormantDistance.GetValueOnGameThread());
+    Settings.OutOfViewScale = FMath::Max(1.0f, CVarSignificanceOutOfViewScale.GetValueOnGameThread());
+    Settings.CosHalfViewCone = FMath::Cos(FMath::DegreesToRadians(0.5f * FMath::Clamp(CVarSignificanceViewCone.GetValueOnGameThread(), 0.0f, 360.0f)));
+    Settings.MidInterval = static_cast<uint8>(FMath::Clamp(CVarSignificanceMidInterval.GetValueOnGameThread(), 1, 255));
+    Settings.FarInterval = static_cast<uint8>(FMath::Clamp(CVarSignificanceFarInterval.GetValueOnGameThread(), static_cast<int32>(Settings.MidInterval), 255));
+
+    GatherViewpoints(GetWorld(), Viewpoints);
+
+    // 帧时间变化超过四分之一时按新的帧时间重写所有降频的 TickInterval
+    SmoothedFrameSeconds = FMath::Lerp(SmoothedFrameSeconds, FMath::Max(DeltaTime, UE_KINDA_SMALL_NUMBER), 0.1f);
+    const bool bFrameTimeChanged = FMath::Abs(SmoothedFrameSeconds - AppliedFrameSeconds) > 0.25f * AppliedFrameSeconds;
+    if (bFrameTimeChanged)
+    {
+        AppliedFrameSeconds = SmoothedFrameSeconds;
+    }
+
+    float Ticks = 0.0f;
+    int32 FullRateTicks = 0;
+    LastIntervalHistogram.Reset();
+
+    for (int32 Index = 0; Index < Characters.Num(); ++Index)
+    {
+        AFPSCharacter* Character = Characters[Index];
+        if (!Character)
+        {
+            continue;
+        }
+
+        uint8 Interval = 1;
+        uint8 ActorInterval = 1;
+        uint8 MovementInterval = 1;
+        if (!Character->IsLocallyControlled() || !Character->IsPlayerControlled())
+        {
+            // 只有模拟代理可以休眠；本机驱动的角色（AI、服务器上的远端玩家）不休眠
+            Interval = GetTickInterval(Character->GetActorLocation(), Character->GetLocalRole() == ROLE_SimulatedProxy);
+
+            // 休眠只关闭 Actor Tick：模拟代理的网格平滑（SmoothClientPosition）在移动组件的 Tick 中执行，
+            // 关闭后网格会停在上次的平滑偏移上，因此移动组件保持最远的降频档位
+            MovementInterval = Interval == DormantInterval ? Settings.FarInterval : Interval;
+
+            // 本机 AI 的 Actor Tick 驱动开火调度，保持每帧
+            ActorInterval = Character->IsLocallyControlled() ? 1 : Interval;
+        }
+
+        FCharacterTickState& State = CharacterStates[Index];
+        if (Character->PrimaryActorTick.bCanEverTick)
+        {
+            Ticks += ApplyInterval(Character->PrimaryActorTick, State.ActorInterval, ActorInterval, bFrameTimeChanged);
+            ++FullRateTicks;
+        }
+        if (UCharacterMovementComponent* Movement = Character->GetCharacterMovement())
+        {
+            Ticks += ApplyInterval(Movement->PrimaryComponentTick, State.MovementInterval, MovementInterval, bFrameTimeChanged);
+            ++FullRateTicks;
+        }
+
+        State.ActorInterval = ActorInterval;
+        State.MovementInterval = MovementInterval;
+        ++LastIntervalHistogram.FindOrAdd(Interval, 0);
+    }
+
+    for (int32 Index = 0; Index < Projectiles.Num(); ++Index)
+    {
+        const AProjetileActor* Projectile = Projectiles[Index];
+        UProjectileMovementComponent* Movement = Projectile ? Projectile->ProjectileMovementComponent : nullptr;
+        if (!Movement)
+        {
+            continue;
+        }
+
+        const uint8 Interval = GetTickInterval(Projectile->GetActorLocation(), false);
+        Ticks += ApplyInterval(Movement->PrimaryComponentTick, ProjectileIntervals[Index], Interval, bFrameTimeChanged);
+        ++FullRateTicks;
+
+        ProjectileIntervals[Index] = Interval;
+        ++LastIntervalHistogram.FindOrAdd(Interval, 0);
+    }
+
+    // 批量弹道在自身 Tick 中按槽位降频，计数晚一帧计入
+    LastBatchedStepped = PendingBatchedStepped;
+    LastBatchedTotal = PendingBatchedTotal;
+    Ticks += PendingBatchedStepped;
+    FullRateTicks += PendingBatchedTotal;
+    PendingBatchedStepped = 0;
+    PendingBatchedTotal = 0;
+
+    LastTicks = Ticks;
+    LastFullRateTicks = FullRateTicks;
+
+    const int32 RoundedTicks = FMath::CeilToInt32(Ticks);
+    SET_DWORD_STAT(STAT_FPSSignificanceTicks, RoundedTicks);
+    SET_DWORD_STAT(STAT_FPSSignificanceSkippedTicks, FMath::Max(0, FullRateTicks - RoundedTicks));
+}
+
+// ------------------------------------------------------------------
+// Actor Tick 阶段（所有 Actor 与组件 Tick）的耗时，与 fps.Significance.Enable 0 对比即为节省的时间
+// ------------------------------------------------------------------
+void UFPSTickSignificanceSubsystem::OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        ActorTickPhaseStartSeconds = FPlatformTime::Seconds();
+    }
+}
+
+void UFPSTickSignificanceSubsystem::OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds)
+{
+    if (InWorld != GetWorld() || ActorTickPhaseStartSeconds <= 0.0)
+    {
+        return;
+    }
+
+    const double PhaseMs = (FPlatformTime::Seconds() - ActorTickPhaseStartSeconds) * 1000.0;
+    ActorTickPhaseMs = ActorTickPhaseMs > 0.0 ? FMath::Lerp(ActorTickPhaseMs, PhaseMs, 0.05) : PhaseMs;
+    ActorTickPhaseStartSeconds = 0.0;
+}
+
+void UFPSTickSignificanceSubsystem::LogReport() const
+{
+    FString Histogram;
+    for (const TPair<int32, int32>& Pair : LastIntervalHistogram)
+    {
+        Histogram += Pair.Key == DormantInterval
+            ? FString::Printf(TEXT(" dormant:%d"), Pair.Value)
+            : FString::Printf(TEXT(" 1/%d:%d"), Pair.Key, Pair.Value);
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("Significance: %s Viewpoints=%d Characters=%d Projectiles=%d BatchedStepped=%d/%d Ticks/frame=%.1f (full rate %d, skipped %.1f) ActorTickPhase=%.3fms Buckets:%s"),
+        bActive ? TEXT("on") : TEXT("off"),
+        Viewpoints.Num(),
+        Characters.Num(),
+        Projectiles.Num(),
+        LastBatchedStepped,
+        LastBatchedTotal,
+        LastTicks,
+        LastFullRateTicks,
+        FMath::Max(0.0f, LastFullRateTicks - LastTicks),
+        ActorTickPhaseMs,
+        *Histogram);
+}
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSTickSignificanceSubsystem.generated.h"
+
+class AFPSCharacter;
+class AProjetileActor;
+
+/* 一个视角：客户端/单机为本地玩家的相机，专用服务器为各玩家角色的眼睛 */
+struct FFPSViewpoint
+{
+    FVector Location = FVector::ZeroVector;
+    FVector Direction = FVector::ForwardVector;
+};
+
+/**
+ * UFPSTickSignificanceSubsystem
+ * 按重要度调度角色与子弹的 Tick 频率。
+ * 每帧按与各视角的距离和是否在视锥内（视锥外的距离按 fps.Significance.OutOfViewScale 放大）为每个实体选择档位：
+ *   每帧 / 每 fps.Significance.MidInterval 帧 / 每 fps.Significance.FarInterval 帧 / 休眠。
+ * 降频通过 TickInterval 实现（按平滑后的帧时间换算），引擎把两次 Tick 之间累积的时间作为 DeltaTime 传入，
+ * 移动组件据此补齐跳过的时间。休眠只用于远离且不可见的模拟代理角色（位置由复制更新）：关闭 Actor Tick，
+ * 移动组件保持 FarInterval，使网格平滑（SmoothClientPosition）继续收敛。
+ *
+ *   角色：Actor 与 CharacterMovement 使用同一档位（休眠时移动组件为 FarInterval）；本地玩家始终每帧，本机 AI 的 Actor Tick（开火调度）保持每帧。
+ *   子弹：批量弹道（UProjectileBallisticsSubsystem）按槽位降频积分，跳过的时间累积到下一次积分；
+ *         未启用批量弹道时调度子弹的 ProjectileMovementComponent。子弹不休眠。
+ *
+ * 度量：stat FPSDemo（Significance / Significance Ticks / Significance Skipped Ticks）、
+ * fps.Significance.Report（各档位数量、每帧 Tick 次数与 Actor Tick 阶段耗时，可切换 fps.Significance.Enable 对比）。
+ */
+UCLASS()
+class FPSDEMO_API UFPSTickSignificanceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /* 休眠档位 */
+    static constexpr uint8 DormantInterval = 0;
+
+    /* 是否启用（fps.Significance.Enable） */
+    static bool IsSignificanceEnabled();
+
+    /* 收集世界中的视角 */
+    static void GatherViewpoints(const UWorld* World, TArray<FFPSViewpoint, TInlineAllocator<4>>& OutViewpoints);
+
+    void RegisterCharacter(AFPSCharacter* Character);
+    void UnregisterCharacter(AFPSCharacter* Character);
+
+    /* 由 ProjectileMovementComponent 驱动的子弹（未启用批量弹道时） */
+    void RegisterProjectile(AProjetileActor* Projectile);
+    void UnregisterProjectile(AProjetileActor* Projectile);
+
+    /**
+     * 某个位置的实体本帧应使用的 Tick 间隔（帧）。未启用或没有视角时为 1。
+     * @param bAllowDormant 为 false 时最远档位为 FarInterval，否则可返回 DormantInterval
+     */
+    uint8 GetTickInterval(const FVector& Location, bool bAllowDormant) const;
+
+    /* 批量弹道本帧积分的槽位数与总槽位数，计入每帧 Tick 统计 */
+    void AddBatchedTicks(int32 NumStepped, int32 NumTotal);
+
+    /* 输出各档位的数量、每帧 Tick 次数与 Actor Tick 阶段耗时 */
+    void LogReport() const;
+
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 角色当前写入的档位 */
+    struct FCharacterTickState
+    {
+        uint8 ActorInterval = 1;
+        uint8 MovementInterval = 1;
+    };
+
+    /* 本帧的档位参数（从控制台变量读取） */
+    struct FBucketSettings
+    {
+        float NearDistance = 0.0f;
+        float FarDistance = 0.0f;
+        float DormantDistance = 0.0f;
+        float OutOfViewScale = 1.0f;
+        float CosHalfViewCone = 0.0f;
+        uint8 MidInterval = 2;
+        uint8 FarInterval = 4;
+    };
+
+    /**
+     * 把档位写入 Tick 函数。只在档位变化（或帧时间明显变化）时修改；进入休眠时关闭 Tick，离开时重新开启。
+     * @return 本帧预估执行的 Tick 次数（1/间隔，休眠为 0）
+     */
+    float ApplyInterval(FTickFunction& TickFunction, uint8 PreviousInterval, uint8 Interval, bool bForce) const;
+
+    /* 恢复每帧 Tick */
+    void ResetAll();
+
+    /* Actor Tick 阶段的耗时（所有 Actor 与组件） */
+    void OnWorldPreActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+
+    /* 已注册的角色（在 EndPlay 中注销），与 CharacterStates 一一对应 */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AFPSCharacter>> Characters;
+    TArray<FCharacterTickState> CharacterStates;
+
+    /* 由移动组件驱动的子弹（归还对象池时注销），与 ProjectileIntervals 一一对应 */
+    UPROPERTY(Transient)
+    TArray<TObjectPtr<AProjetileActor>> Projectiles;
+    TArray<uint8> ProjectileIntervals;
+
+    /* 本帧的视角与档位参数 */
+    TArray<FFPSViewpoint, TInlineAllocator<4>> Viewpoints;
+    FBucketSettings Settings;
+
+    /* 平滑后的帧时间，用于把帧间隔换算为 TickInterval；AppliedFrameSeconds 为上次写入时使用的值 */
+    float SmoothedFrameSeconds = 1.0f / 60.0f;
+    float AppliedFrameSeconds = 1.0f / 60.0f;
+
+    /* 批量弹道上报的计数，在下一次 Tick 中计入统计 */
+    int32 PendingBatchedStepped = 0;
+    int32 PendingBatchedTotal = 0;
+
+    /* 上一帧的结果，用于报告 */
+    TMap<int32, int32> LastIntervalHistogram;
+    float LastTicks = 0.0f;
+    int32 LastFullRateTicks = 0;
+    int32 LastBatchedStepped = 0;
+    int32 LastBatchedTotal = 0;
+
+    /* Actor Tick 阶段耗时（毫秒，指数平滑） */
+    double ActorTickPhaseMs = 0.0;
+    double ActorTickPhaseStartSeconds = 0.0;
+
+    bool bActive = false;
+
+    FDelegateHandle PreActorTickHandle;
+    FDelegateHandle PostActorTickHandle;
+};
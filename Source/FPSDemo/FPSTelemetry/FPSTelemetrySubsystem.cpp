@@ -0,0 +1,197 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSTelemetry/FPSTelemetrySubsystem.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+
+static TAutoConsoleVariable<int32> CVarTelemetryEnable(
+    TEXT("fps.Telemetry.Enable"),
+    0,
+    TEXT("1：创建遥测子系统，记录每一发射击与每一次命中（在世界创建时读取；命令行 -FPSTelemetry 同样启用）。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTelemetryBufferRecords(
+    TEXT("fps.Telemetry.BufferRecords"),
+    65536,
+    TEXT("遥测环形缓冲容量（记录数，每条 64 字节，向上取整为 2 的幂）。写满时新记录被丢弃。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTelemetryMaxFileMB(
+    TEXT("fps.Telemetry.MaxFileMB"),
+    64,
+    TEXT("单个遥测文件的大小上限（MB），达到后切换到下一个文件。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTelemetryMaxFiles(
+    TEXT("fps.Telemetry.MaxFiles"),
+    16,
+    TEXT("保留的遥测文件数量，超出时删除最早的文件；0 表示不限。"),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarTelemetryFlushIntervalMs(
+    TEXT("fps.Telemetry.FlushIntervalMs"),
+    250,
+    TEXT("遥测后台线程写文件的最长间隔（毫秒）；缓冲过半时会提前写出。"),
+    ECVF_Default);
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Telemetry.Stats
+// ------------------------------------------------------------------
+static FAutoConsoleCommandWithWorld GTelemetryStatsCommand(
+    TEXT("fps.Telemetry.Stats"),
+    TEXT("输出遥测统计（已写入、已丢弃的记录数，字节数与文件数）。"),
+    FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+    {
+        if (const UFPSTelemetrySubsystem* Telemetry = World ? World->GetSubsystem<UFPSTelemetrySubsystem>() : nullptr)
+        {
+            Telemetry->LogStats();
+        }
+    }));
+
+// ------------------------------------------------------------------
+// 仅在命令行带 -FPSTelemetry 或 fps.Telemetry.Enable=1 时创建
+// ------------------------------------------------------------------
+bool UFPSTelemetrySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+    return Super::ShouldCreateSubsystem(Outer)
+        && (FParse::Param(FCommandLine::Get(), TEXT("FPSTelemetry")) || CVarTelemetryEnable.GetValueOnGameThread() != 0);
+}
+
+bool UFPSTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+// ------------------------------------------------------------------
+// 开始游戏：启动写入器并订阅命中事件
+// ------------------------------------------------------------------
+void UFPSTelemetrySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    FFPSTelemetryWriterSettings Settings;
+    if (!FParse::Value(FCommandLine::Get(), TEXT("FPSTelemetry="), Settings.Directory))
+    {
+        Settings.Directory = FPaths::ProjectSavedDir() / TEXT("Telemetry");
+    }
+
+    // PIE 的多个世界各写各的文件
+    const int32 PIEInstance = InWorld.GetOutermost()->GetPIEInstanceID();
+    Settings.BaseName = PIEInstance != INDEX_NONE
+        ? FString::Printf(TEXT("Telemetry_%s_PIE%d"), *FDateTime::Now().ToString(), PIEInstance)
+        : FString::Printf(TEXT("Telemetry_%s"), *FDateTime::Now().ToString());
+
+    Settings.BufferRecords = CVarTelemetryBufferRecords.GetValueOnGameThread();
+    Settings.MaxFileBytes = static_cast<int64>(CVarTelemetryMaxFileMB.GetValueOnGameThread()) * 1024 * 1024;
+    Settings.MaxFiles = CVarTelemetryMaxFiles.GetValueOnGameThread();
+    Settings.FlushIntervalMs = static_cast<uint32>(FMath::Max(CVarTelemetryFlushIntervalMs.GetValueOnGameThread(), 1));
+
+    if (!Writer.Start(Settings))
+    {
+        UE_LOG(LogFPSDemo, Error, TEXT("Telemetry: failed to start writer in %s"), *Settings.Directory);
+        return;
+    }
+
+    if (UFPSHitEventSubsystem* HitEvents = InWorld.GetSubsystem<UFPSHitEventSubsystem>())
+    {
+        HitEventBatchHandle = HitEvents->OnBatch(EFPSHitEventPhase::Analytics).AddUObject(this, &UFPSTelemetrySubsystem::OnHitEventBatch);
+    }
+}
+
+void UFPSTelemetrySubsystem::Deinitialize()
+{
+    if (UFPSHitEventSubsystem* HitEvents = GetWorld()->GetSubsystem<UFPSHitEventSubsystem>())
+    {
+        HitEvents->OnBatch(EFPSHitEventPhase::Analytics).Remove(HitEventBatchHandle);
+    }
+
+    if (Writer.GetRecordsDropped() > 0)
+    {
+        UE_LOG(LogFPSDemo, Warning, TEXT("Telemetry: %llu records were dropped because the buffer was full; raise fps.Telemetry.BufferRecords"),
+            Writer.GetRecordsDropped());
+    }
+
+    // 写出剩余记录并等待后台线程退出
+    Writer.Shutdown();
+
+    Super::Deinitialize();
+}
+
+// ------------------------------------------------------------------
+// 射击记录
+// ------------------------------------------------------------------
+void UFPSTelemetrySubsystem::RecordShot(const APawn* Shooter, const FVector& Origin, const FVector& Direction, double Time, bool bHitscan)
+{
+    FFPSTelemetryRecord Record;
+    Record.Time = Time;
+    Record.FrameNumber = static_cast<uint32>(GFrameCounter);
+    Record.Type = EFPSTelemetryRecordType::Shot;
+    Record.Flags = (bHitscan ? FPSTelemetryFlag_Hitscan : 0) | (Shooter && !Shooter->IsPlayerControlled() ? FPSTelemetryFlag_BotShooter : 0);
+    Record.ShooterId = Shooter ? Shooter->GetUniqueID() : 0;
+    Record.Origin = FVector3f(Origin);
+    Record.Direction = FVector3f(Direction);
+    WriteRecord(Record);
+}
+
+// ------------------------------------------------------------------
+// 命中记录：只记录权威端的非表现命中，与伤害结算一致
+// ------------------------------------------------------------------
+void UFPSTelemetrySubsystem::OnHitEventBatch(const FFPSHitEventBatch& Batch)
+{
+    if (!Batch.bAuthority)
+    {
+        return;
+    }
+
+    for (const EFPSHitEventKind Kind : { EFPSHitEventKind::CharacterHit, EFPSHitEventKind::WorldHit })
+    {
+        for (const FFPSHitEvent& Event : Batch.GetEvents(Kind))
+        {
+            if (Event.bCosmetic)
+            {
+                continue;
+            }
+
+            const APawn* Shooter = Cast<APawn>(Event.Instigator.Get());
+            const AActor* Target = Event.HitActor.Get();
+
+            FFPSTelemetryRecord Record;
+            Record.Time = Event.Time;
+            Record.FrameNumber = static_cast<uint32>(Batch.FrameNumber);
+            Record.Type = EFPSTelemetryRecordType::Hit;
+            Record.Flags = (Event.Source == EFPSHitEventSource::Hitscan ? FPSTelemetryFlag_Hitscan : 0)
+                | (Shooter && !Shooter->IsPlayerControlled() ? FPSTelemetryFlag_BotShooter : 0)
+                | (Kind == EFPSHitEventKind::CharacterHit ? FPSTelemetryFlag_CharacterTarget : 0);
+            Record.ShooterId = Shooter ? Shooter->GetUniqueID() : 0;
+            Record.TargetId = Target ? Target->GetUniqueID() : 0;
+            Record.Origin = Shooter ? FVector3f(Shooter->GetActorLocation()) : FVector3f::ZeroVector;
+            Record.Direction = FVector3f(Event.Direction);
+            Record.ImpactPoint = FVector3f(Event.Location);
+            WriteRecord(Record);
+        }
+    }
+}
+
+void UFPSTelemetrySubsystem::WriteRecord(const FFPSTelemetryRecord& Record)
+{
+    if (Writer.Write(Record))
+    {
+        INC_DWORD_STAT(STAT_FPSTelemetryRecords);
+    }
+    else
+    {
+        INC_DWORD_STAT(STAT_FPSTelemetryDropped);
+    }
+}
+
+void UFPSTelemetrySubsystem::LogStats() const
+{
+    UE_LOG(LogFPSDemo, Log, TEXT("Telemetry: Records=%llu Dropped=%llu Bytes=%lld Files=%d"),
+        Writer.GetRecordsWritten(), Writer.GetRecordsDropped(), Writer.GetBytesWritten(), Writer.GetFileCount());
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FPSTelemetry/FPSTelemetryWriter.h"
+#include "FPSTelemetrySubsystem.generated.h"
+
+class APawn;
+struct FFPSHitEventBatch;
+
+/**
+ * UFPSTelemetrySubsystem
+ * 供数值平衡分析的逐发射击与逐次命中遥测。
+ * 权威端的每一发射击（AFPSCharacter::FireShots）与每一次非表现命中（通过命中事件总线的 Analytics 阶段，
+ * 覆盖子弹 OnHit 与即时命中）各写入一条 64 字节的定长记录，由 FFPSTelemetryWriter 在后台线程写入文件。
+ *
+ * 命令行带 -FPSTelemetry[=目录] 或 fps.Telemetry.Enable=1 时创建，默认写入 Saved/Telemetry。
+ * 控制台：fps.Telemetry.Stats
+ */
+UCLASS()
+class FPSDEMO_API UFPSTelemetrySubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+    virtual void Deinitialize() override;
+
+    /**
+     * 记录一发射击。
+     * @param Shooter   开火者
+     * @param Origin    枪口位置
+     * @param Direction 归一化的射击方向
+     * @param Time      开火时的世界时间
+     * @param bHitscan  是否为即时命中射击
+     */
+    void RecordShot(const APawn* Shooter, const FVector& Origin, const FVector& Direction, double Time, bool bHitscan);
+
+    /* 缓冲溢出而丢弃的记录数 */
+    uint64 GetRecordsDropped() const { return Writer.GetRecordsDropped(); }
+
+    void LogStats() const;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+    /* 命中事件总线 Analytics 阶段：整批写入命中记录 */
+    void OnHitEventBatch(const FFPSHitEventBatch& Batch);
+
+    void WriteRecord(const FFPSTelemetryRecord& Record);
+
+    FFPSTelemetryWriter Writer;
+
+    FDelegateHandle HitEventBatchHandle;
+};
@@ -0,0 +1,263 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSTelemetry/FPSTelemetryWriter.h"
+#include "FPSDemo.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Paths.h"
+
+namespace FPSTelemetryWriter
+{
+    /* 文件打开或写入失败后重试打开的退避间隔（秒） */
+    constexpr double MinReopenDelay = 1.0;
+    constexpr double MaxReopenDelay = 30.0;
+}
+
+FFPSTelemetryWriter::FFPSTelemetryWriter()
+{
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+}
+
+FFPSTelemetryWriter::~FFPSTelemetryWriter()
+{
+    Shutdown();
+
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+}
+
+// ------------------------------------------------------------------
+// 启动：一次性分配并触碰整个环形缓冲，之后的写入不再分配内存
+// ------------------------------------------------------------------
+bool FFPSTelemetryWriter::Start(const FFPSTelemetryWriterSettings& InSettings)
+{
+    Shutdown();
+
+    Settings = InSettings;
+    Settings.MaxFileBytes = FMath::Max<int64>(Settings.MaxFileBytes, 1024 * 1024);
+
+    const uint32 Capacity = FMath::RoundUpToPowerOfTwo(static_cast<uint32>(FMath::Clamp(Settings.BufferRecords, 1024, 1 << 24)));
+    Ring.SetNumZeroed(Capacity);
+    RingMask = Capacity - 1;
+    WakeThreshold = Capacity / 2;
+
+    WriteIndex.store(0);
+    ReadIndex.store(0);
+    RecordsWritten.store(0);
+    RecordsDropped.store(0);
+    BytesWritten.store(0);
+    FileCount.store(0);
+    bStopRequested.store(false);
+    NextFileIndex = 0;
+    OpenedFiles.Reset();
+    NextReopenTime = 0.0;
+    ReopenDelay = 0.0;
+
+    if (!IFileManager::Get().MakeDirectory(*Settings.Directory, true) || !OpenNextFile())
+    {
+        Ring.Empty();
+        return false;
+    }
+
+    Thread = FRunnableThread::Create(this, TEXT("FPSTelemetryWriter"), 0, TPri_BelowNormal);
+    if (!Thread)
+    {
+        File.Reset();
+        Ring.Empty();
+        return false;
+    }
+
+    UE_LOG(LogFPSDemo, Log, TEXT("Telemetry: writing %s/%s_*.fpstl (buffer %u records, %.1f MB)"),
+        *Settings.Directory, *Settings.BaseName, Capacity, Capacity * sizeof(FFPSTelemetryRecord) / (1024.0 * 1024.0));
+    return true;
+}
+
+void FFPSTelemetryWriter::Shutdown()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    // 后台线程退出前会写出剩余记录
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+
+    File.Reset();
+    Ring.Empty();
+
+    UE_LOG(LogFPSDemo, Log, TEXT("Telemetry: closed, records=%llu dropped=%llu bytes=%lld files=%d"),
+        GetRecordsWritten(), GetRecordsDropped(), GetBytesWritten(), GetFileCount());
+}
+
+// ------------------------------------------------------------------
+// 生产者：复制到环形缓冲的下一个槽位后发布写入下标
+// ------------------------------------------------------------------
+bool FFPSTelemetryWriter::Write(const FFPSTelemetryRecord& Record)
+{
+    if (!Thread)
+    {
+        return false;
+    }
+
+    const uint64 Write = WriteIndex.load(std::memory_order_relaxed);
+    const uint64 Read = ReadIndex.load(std::memory_order_acquire);
+    const uint64 Pending = Write - Read;
+
+    if (Pending > RingMask)
+    {
+        RecordsDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    FFPSTelemetryRecord& Slot = Ring[static_cast<int32>(Write & RingMask)];
+    Slot = Record;
+    Slot.Sequence = static_cast<uint32>(Write);
+
+    WriteIndex.store(Write + 1, std::memory_order_release);
+
+    // 积压刚好达到阈值时唤醒后台线程，不必等到下一个间隔
+    if (Pending + 1 == WakeThreshold)
+    {
+        WakeEvent->Trigger();
+    }
+    return true;
+}
+
+// ------------------------------------------------------------------
+// 后台线程：按间隔或被唤醒时写出已提交的记录
+// ------------------------------------------------------------------
+uint32 FFPSTelemetryWriter::Run()
+{
+    while (!bStopRequested.load(std::memory_order_acquire))
+    {
+        WakeEvent->Wait(Settings.FlushIntervalMs);
+        FlushCommitted();
+    }
+
+    FlushCommitted();
+    if (File)
+    {
+        File->Flush();
+    }
+    return 0;
+}
+
+void FFPSTelemetryWriter::Stop()
+{
+    bStopRequested.store(true, std::memory_order_release);
+    WakeEvent->Trigger();
+}
+
+void FFPSTelemetryWriter::FlushCommitted()
+{
+    const uint64 Write = WriteIndex.load(std::memory_order_acquire);
+    const uint64 Read = ReadIndex.load(std::memory_order_relaxed);
+    if (Write == Read)
+    {
+        return;
+    }
+
+    // 环形缓冲中最多两段连续内存，各自一次顺序写入
+    const uint64 Capacity = RingMask + 1;
+    const uint64 Start = Read & RingMask;
+    const uint64 Count = Write - Read;
+    const uint64 FirstCount = FMath::Min(Count, Capacity - Start);
+
+    int32 NumWritten = WriteRecords(&Ring[static_cast<int32>(Start)], static_cast<int32>(FirstCount));
+    if (FirstCount < Count)
+    {
+        NumWritten += WriteRecords(&Ring[0], static_cast<int32>(Count - FirstCount));
+    }
+
+    RecordsWritten.fetch_add(NumWritten, std::memory_order_relaxed);
+
+    // 写完后才释放槽位给生产者
+    ReadIndex.store(Write, std::memory_order_release);
+}
+
+int32 FFPSTelemetryWriter::WriteRecords(const FFPSTelemetryRecord* Records, int32 Count)
+{
+    int32 NumWritten = 0;
+    while (Count > 0)
+    {
+        if (File && CurrentFileBytes >= Settings.MaxFileBytes)
+        {
+            OpenNextFile();
+        }
+        else if (!File && FPlatformTime::Seconds() >= NextReopenTime)
+        {
+            // 之前打开或写入失败：到了重试时间就换一个新文件继续写
+            OpenNextFile();
+        }
+        if (!File)
+        {
+            // 无法打开文件（磁盘已满等），且未到重试时间：这些记录计为丢弃
+            RecordsDropped.fetch_add(Count, std::memory_order_relaxed);
+            return NumWritten;
+        }
+
+        // 只写到当前文件的上限为止，其余记录进入下一个文件
+        const int64 Remaining = Settings.MaxFileBytes - CurrentFileBytes;
+        const int32 Chunk = static_cast<int32>(FMath::Clamp<int64>(Remaining / sizeof(FFPSTelemetryRecord), 1, Count));
+        const int64 ChunkBytes = Chunk * static_cast<int64>(sizeof(FFPSTelemetryRecord));
+
+        if (!File->Write(reinterpret_cast<const uint8*>(Records), ChunkBytes))
+        {
+            UE_LOG(LogFPSDemo, Warning, TEXT("Telemetry: write failed, closing current file"));
+            File.Reset();
+            ScheduleReopen();
+            continue;
+        }
+
+        // 写入成功才清除退避，打开成功但持续写入失败时重试间隔仍会增长
+        ReopenDelay = 0.0;
+        CurrentFileBytes += ChunkBytes;
+        BytesWritten.fetch_add(ChunkBytes, std::memory_order_relaxed);
+        Records += Chunk;
+        Count -= Chunk;
+        NumWritten += Chunk;
+    }
+    return NumWritten;
+}
+
+bool FFPSTelemetryWriter::OpenNextFile()
+{
+    File.Reset();
+
+    const FString Filename = Settings.Directory / FString::Printf(TEXT("%s_%03u.fpstl"), *Settings.BaseName, NextFileIndex);
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Filename));
+    if (!File)
+    {
+        UE_LOG(LogFPSDemo, Error, TEXT("Telemetry: failed to create %s"), *Filename);
+        ScheduleReopen();
+        return false;
+    }
+
+    FFPSTelemetryFileHeader Header;
+    Header.FileIndex = NextFileIndex++;
+    File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+    CurrentFileBytes = sizeof(Header);
+    BytesWritten.fetch_add(sizeof(Header), std::memory_order_relaxed);
+    FileCount.fetch_add(1, std::memory_order_relaxed);
+
+    // 轮换：只保留最近的 MaxFiles 个文件
+    OpenedFiles.Add(Filename);
+    while (Settings.MaxFiles > 0 && OpenedFiles.Num() > Settings.MaxFiles)
+    {
+        FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*OpenedFiles[0]);
+        OpenedFiles.RemoveAt(0);
+    }
+    return true;
+}
+
+void FFPSTelemetryWriter::ScheduleReopen()
+{
+    ReopenDelay = FMath::Clamp(ReopenDelay * 2.0, FPSTelemetryWriter::MinReopenDelay, FPSTelemetryWriter::MaxReopenDelay);
+    NextReopenTime = FPlatformTime::Seconds() + ReopenDelay;
+}
@@ -0,0 +1,173 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include <atomic>
+
+class FEvent;
+class FRunnableThread;
+class IFileHandle;
+
+/* 遥测记录类型 */
+enum class EFPSTelemetryRecordType : uint8
+{
+    Shot = 1,
+    Hit = 2,
+};
+
+/* 遥测记录标志 */
+enum EFPSTelemetryRecordFlags : uint8
+{
+    FPSTelemetryFlag_Hitscan         = 1 << 0, // 即时命中射击（否则为实体子弹）
+    FPSTelemetryFlag_BotShooter      = 1 << 1, // 开火者不是玩家控制
+    FPSTelemetryFlag_CharacterTarget = 1 << 2, // 命中目标为角色
+};
+
+/**
+ * 定长遥测记录（64 字节，小端，直接按内存布局写入文件）。
+ * 对象以 UObject::GetUniqueID() 标识，仅在同一次运行内有效。
+ *   Shot：Origin 为枪口位置，Direction 为射击方向，TargetId / ImpactPoint 为 0
+ *   Hit ：Origin 为命中时开火者的位置，Direction 为命中方向，ImpactPoint 为命中点
+ */
+struct FFPSTelemetryRecord
+{
+    /* 世界时间（秒） */
+    double Time = 0.0;
+
+    /* 写入序号，由写入器填写；文件中出现跳号即表示有记录被丢弃 */
+    uint32 Sequence = 0;
+
+    uint32 FrameNumber = 0;
+
+    EFPSTelemetryRecordType Type = EFPSTelemetryRecordType::Shot;
+    uint8 Flags = 0;
+    uint16 Reserved = 0;
+
+    uint32 ShooterId = 0;
+    uint32 TargetId = 0;
+
+    FVector3f Origin = FVector3f::ZeroVector;
+    FVector3f Direction = FVector3f::ZeroVector;
+    FVector3f ImpactPoint = FVector3f::ZeroVector;
+};
+static_assert(sizeof(FFPSTelemetryRecord) == 64, "FFPSTelemetryRecord 的文件格式固定为 64 字节");
+
+/* 遥测文件头（16 字节），其后紧跟连续的 FFPSTelemetryRecord */
+struct FFPSTelemetryFileHeader
+{
+    static constexpr uint32 Magic = 0x54535046; // "FPST"
+    static constexpr uint16 CurrentVersion = 1;
+
+    uint32 FileMagic = Magic;
+    uint16 Version = CurrentVersion;
+    uint16 RecordSize = sizeof(FFPSTelemetryRecord);
+
+    /* 本次运行中的文件序号，从 0 开始 */
+    uint32 FileIndex = 0;
+    uint32 Reserved = 0;
+};
+static_assert(sizeof(FFPSTelemetryFileHeader) == 16, "FFPSTelemetryFileHeader 的文件格式固定为 16 字节");
+
+/* 写入器配置 */
+struct FFPSTelemetryWriterSettings
+{
+    /* 输出目录与文件名前缀：<Directory>/<BaseName>_<序号>.fpstl */
+    FString Directory;
+    FString BaseName;
+
+    /* 环形缓冲容量（记录数，向上取整为 2 的幂） */
+    int32 BufferRecords = 65536;
+
+    /* 单个文件的大小上限，达到后切换到下一个文件 */
+    int64 MaxFileBytes = 64 * 1024 * 1024;
+
+    /* 保留的文件数量，超出时删除最早的文件；0 表示不限 */
+    int32 MaxFiles = 16;
+
+    /* 后台线程的最长等待间隔（毫秒） */
+    uint32 FlushIntervalMs = 250;
+};
+
+/**
+ * FFPSTelemetryWriter
+ * 单生产者、单消费者的异步遥测写入器。
+ * 游戏线程把定长记录复制进启动时预分配的环形缓冲（热路径上没有任何内存分配与锁），
+ * 后台线程定期（或缓冲过半时被唤醒）把已提交的记录以大块顺序写入本地文件，并按大小轮换文件。
+ * 缓冲写满时新记录被丢弃并计数，不会阻塞游戏线程。
+ */
+class FPSDEMO_API FFPSTelemetryWriter : public FRunnable
+{
+public:
+    FFPSTelemetryWriter();
+    virtual ~FFPSTelemetryWriter() override;
+
+    /* 分配缓冲、打开第一个文件并启动后台线程 */
+    bool Start(const FFPSTelemetryWriterSettings& InSettings);
+
+    /* 写出剩余记录并停止后台线程 */
+    void Shutdown();
+
+    bool IsRunning() const { return Thread != nullptr; }
+
+    /**
+     * 追加一条记录（仅限同一个生产者线程调用）。
+     * @return 缓冲已满、记录被丢弃时返回 false
+     */
+    bool Write(const FFPSTelemetryRecord& Record);
+
+    uint64 GetRecordsWritten() const { return RecordsWritten.load(std::memory_order_relaxed); }
+    uint64 GetRecordsDropped() const { return RecordsDropped.load(std::memory_order_relaxed); }
+    int64 GetBytesWritten() const { return BytesWritten.load(std::memory_order_relaxed); }
+    int32 GetFileCount() const { return FileCount.load(std::memory_order_relaxed); }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    /* 把缓冲中已提交的记录全部写入文件（后台线程） */
+    void FlushCommitted();
+
+    /* 写入一段连续记录，必要时先轮换文件；返回成功写入的记录数 */
+    int32 WriteRecords(const FFPSTelemetryRecord* Records, int32 Count);
+
+    /* 关闭当前文件并打开下一个，删除超出保留数量的旧文件 */
+    bool OpenNextFile();
+
+    /* 打开或写入失败后，按指数退避推迟下一次打开文件的时间 */
+    void ScheduleReopen();
+
+    FFPSTelemetryWriterSettings Settings;
+
+    /* 预分配的环形缓冲 */
+    TArray<FFPSTelemetryRecord> Ring;
+    uint64 RingMask = 0;
+
+    /* 缓冲中积压达到该数量时唤醒后台线程 */
+    uint64 WakeThreshold = 0;
+
+    /* 生产者与消费者各自推进的下标，分处不同缓存行避免伪共享 */
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> WriteIndex{ 0 };
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> ReadIndex{ 0 };
+
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> RecordsWritten{ 0 };
+    std::atomic<uint64> RecordsDropped{ 0 };
+    std::atomic<int64> BytesWritten{ 0 };
+    std::atomic<int32> FileCount{ 0 };
+    std::atomic<bool> bStopRequested{ false };
+
+    FEvent* WakeEvent = nullptr;
+    FRunnableThread* Thread = nullptr;
+
+    /* 以下仅由后台线程访问（Start 中的首次打开除外） */
+    TUniquePtr<IFileHandle> File;
+    int64 CurrentFileBytes = 0;
+    uint32 NextFileIndex = 0;
+    TArray<FString> OpenedFiles;
+
+    /* 没有可用文件时下一次尝试打开的时间（FPlatformTime::Seconds）与当前退避间隔 */
+    double NextReopenTime = 0.0;
+    double ReopenDelay = 0.0;
+};
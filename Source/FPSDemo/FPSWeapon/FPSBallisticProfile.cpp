@@ -0,0 +1,10 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSWeapon/FPSBallisticProfile.h"
+
+const FPrimaryAssetType UFPSBallisticProfile::PrimaryAssetType = TEXT("FPSBallisticProfile");
+
+FPrimaryAssetId UFPSBallisticProfile::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
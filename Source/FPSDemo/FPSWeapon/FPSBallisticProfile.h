@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "FPSBallisticProfile.generated.h"
+
+class UStaticMesh;
+
+/**
+ * UFPSBallisticProfile
+ * 子弹弹道与外观参数（主数据资产）。
+ * 应用到对象池中的 AProjetileActor 上，覆盖其构造函数中的默认值；调参无需重新编译。
+ * 网格为软引用，随所属武器的 "Equipped" 资产包异步加载。
+ */
+UCLASS(BlueprintType)
+class FPSDEMO_API UFPSBallisticProfile : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /* 主资产类型，对应 DefaultGame.ini 中的 PrimaryAssetTypesToScan */
+    static const FPrimaryAssetType PrimaryAssetType;
+
+    virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+    /* 初速（cm/s） */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.0"))
+    float InitialSpeed = 3000.0f;
+
+    /* 最大速度（cm/s），0 表示不限速 */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.0"))
+    float MaxSpeed = 3000.0f;
+
+    /* 重力缩放，0 表示不受重力影响 */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics")
+    float GravityScale = 0.0f;
+
+    /* 是否反弹 */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics")
+    bool bShouldBounce = true;
+
+    /* 反弹系数 */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.0", ClampMax = "1.0", EditCondition = "bShouldBounce"))
+    float Bounciness = 0.3f;
+
+    /* 碰撞球半径（cm） */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.1"))
+    float CollisionRadius = 15.0f;
+
+    /* 每次命中造成的伤害 */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.0"))
+    float Damage = 10.0f;
+
+    /* 寿命（秒） */
+    UPROPERTY(EditDefaultsOnly, Category = "Ballistics", meta = (ClampMin = "0.1"))
+    float LifeSpan = 3.0f;
+
+    /* 子弹网格，为空时保留子弹类自身的网格 */
+    UPROPERTY(EditDefaultsOnly, Category = "Visual", meta = (AssetBundles = "Equipped"))
+    TSoftObjectPtr<UStaticMesh> Mesh;
+
+    /* 网格缩放 */
+    UPROPERTY(EditDefaultsOnly, Category = "Visual")
+    FVector MeshScale = FVector(0.09f, 0.09f, 0.09f);
+};
@@ -0,0 +1,601 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSWeapon/FPSBallistics.h"
+#include "FPSWeapon/FPSBallisticProfile.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSCollision/FPSStaticCollisionBVH.h"
+#include "FPSDemo.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/ProjectileMovementComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Math/VectorRegister.h"
+
+namespace FPSBallistics
+{
+    /* 仰角搜索范围、粗扫描段数与二分次数（二分后的仰角误差约 0.003°） */
+    static constexpr float MaxAimPitchDegrees = 85.0f;
+    static constexpr int32 NumAimScanSteps = 16;
+    static constexpr int32 NumAimBisectSteps = 12;
+
+    /* 移动目标：命中时间的不动点迭代 */
+    static constexpr int32 MaxInterceptIterations = 8;
+    static constexpr float InterceptTolerance = 1.0e-3f;
+
+    /* 第一次命中：有重力时每段弦覆盖的时间 */
+    static constexpr float ImpactSegmentSeconds = 1.0f / 30.0f;
+    static constexpr int32 MaxImpactSegments = 128;
+
+    /* 与逐帧积分相同：超过 MaxSpeed 的初速在第一帧即被限制 */
+    static float GetLaunchSpeed(const FFPSBallisticParams& Params)
+    {
+        return Params.MaxSpeed > 0.0f ? FMath::Min(Params.InitialSpeed, Params.MaxSpeed) : Params.InitialSpeed;
+    }
+
+    static float GetAngleDegrees(const FVector& Direction, const FVector& LineOfSight)
+    {
+        const FVector LineOfSightDirection = LineOfSight.GetSafeNormal();
+        return LineOfSightDirection.IsZero()
+            ? 0.0f
+            : static_cast<float>(FMath::RadiansToDegrees(FMath::Acos(FMath::Clamp(Direction | LineOfSightDirection, -1.0, 1.0))));
+    }
+}
+
+// ------------------------------------------------------------------
+// 弹道参数：与 AProjetileActor::ApplyBallisticProfile 相同的取值
+// ------------------------------------------------------------------
+FFPSBallisticParams FFPSBallisticParams::Make(const AProjetileActor& ProjectileDefaults, const UFPSBallisticProfile* Profile, float WorldGravityZ)
+{
+    const UProjectileMovementComponent* Movement = ProjectileDefaults.ProjectileMovementComponent;
+    const USphereComponent* Collision = ProjectileDefaults.CollisionComponent;
+
+    FFPSBallisticParams Params;
+    Params.InitialSpeed = Profile ? Profile->InitialSpeed : Movement->InitialSpeed;
+    Params.MaxSpeed = Profile ? Profile->MaxSpeed : Movement->MaxSpeed;
+    Params.GravityZ = WorldGravityZ * (Profile ? Profile->GravityScale : Movement->ProjectileGravityScale);
+    const bool bShouldBounce = Profile ? Profile->bShouldBounce : Movement->bShouldBounce;
+    Params.Bounciness = bShouldBounce ? (Profile ? Profile->Bounciness : Movement->Bounciness) : -1.0f;
+    Params.LifeSpan = Profile ? Profile->LifeSpan : ProjectileDefaults.GetProjectileLifeSpan();
+    Params.Radius = Profile ? Profile->CollisionRadius : Collision->GetScaledSphereRadius();
+    Params.CollisionChannel = Collision->GetCollisionObjectType();
+    return Params;
+}
+
+// ------------------------------------------------------------------
+// 构造：计算抛物线阶段的结束时间与限速阶段的常量
+// ------------------------------------------------------------------
+FFPSTrajectory::FFPSTrajectory(const FFPSBallisticParams& Params, const FVector& InOrigin, const FVector& Direction)
+    : Origin(InOrigin)
+    , LaunchVelocity(FVector3f(Direction.GetSafeNormal()) * FPSBallistics::GetLaunchSpeed(Params))
+    , GravityZ(Params.GravityZ)
+    , DownZ(Params.GravityZ > 0.0f ? 1.0f : -1.0f)
+{
+    const double Gravity = FMath::Abs(GravityZ);
+    if (Params.MaxSpeed <= 0.0f || Gravity <= 0.0)
+    {
+        return;
+    }
+
+    // |v0 + g·t| = MaxSpeed 的非负根；初速不超过 MaxSpeed，因此恰有一个
+    const double B = static_cast<double>(LaunchVelocity.Z) * GravityZ;
+    const double C = FMath::Min(static_cast<double>(LaunchVelocity.SizeSquared()) - FMath::Square(static_cast<double>(Params.MaxSpeed)), 0.0);
+    const double GravitySquared = Gravity * Gravity;
+    LimitTime = static_cast<float>(FMath::Max((-B + FMath::Sqrt(B * B - GravitySquared * C)) / GravitySquared, 0.0));
+
+    // 此时速度正在增大（与重力夹角不超过 90°），θ1 ∈ [0, π/2]
+    const FVector3f Velocity1 = LaunchVelocity + FVector3f(0.0f, 0.0f, GravityZ * LimitTime);
+    const FVector2f Horizontal(Velocity1.X, Velocity1.Y);
+    const float HorizontalSpeed = Horizontal.Size();
+    LimitDirection = HorizontalSpeed > UE_KINDA_SMALL_NUMBER ? Horizontal / HorizontalSpeed : FVector2f::ZeroVector;
+
+    LimitSpeed = Params.MaxSpeed;
+    K = static_cast<float>(Gravity / LimitSpeed);
+    TurnRadius = LimitSpeed / K;
+    Theta1 = FMath::Atan2(HorizontalSpeed, Velocity1.Z * DownZ);
+    U1 = FMath::Tan(0.5f * Theta1);
+    LogU1 = FMath::Loge(1.0f + U1 * U1);
+}
+
+FVector FFPSTrajectory::GetLocation(float Time) const
+{
+    const float ParabolaTime = FMath::Min(Time, LimitTime);
+    FVector3f Location = LaunchVelocity * ParabolaTime;
+    Location.Z += 0.5f * GravityZ * ParabolaTime * ParabolaTime;
+
+    // 限速阶段：水平位移 R·(θ1 - θ)，沿重力方向位移 V·τ - R·ln((1 + u1²) / (1 + u²))，其中 u = u1·e^(-kτ)
+    const float LimitedTime = Time - LimitTime;
+    if (LimitedTime > 0.0f)
+    {
+        const float U = U1 * FMath::Exp(-K * LimitedTime);
+        const float Turn = TurnRadius * (Theta1 - 2.0f * FMath::Atan(U));
+        const float Drop = LimitSpeed * LimitedTime - TurnRadius * (LogU1 - FMath::Loge(1.0f + U * U));
+        Location.X += LimitDirection.X * Turn;
+        Location.Y += LimitDirection.Y * Turn;
+        Location.Z += DownZ * Drop;
+    }
+
+    return Origin + FVector(Location);
+}
+
+FVector FFPSTrajectory::GetVelocity(float Time) const
+{
+    if (Time <= LimitTime)
+    {
+        return FVector(LaunchVelocity + FVector3f(0.0f, 0.0f, GravityZ * Time));
+    }
+
+    // 速率保持 MaxSpeed，与重力方向的夹角 θ = 2·atan(u)
+    const float U = U1 * FMath::Exp(-K * (Time - LimitTime));
+    const float InvDenominator = 1.0f / (1.0f + U * U);
+    const float Sin = 2.0f * U * InvDenominator;
+    const float Cos = (1.0f - U * U) * InvDenominator;
+    return FVector(LimitDirection.X * Sin * LimitSpeed, LimitDirection.Y * Sin * LimitSpeed, DownZ * Cos * LimitSpeed);
+}
+
+bool FFPSTrajectory::GetTimeAtHorizontalDistance(float Distance, float& OutTime) const
+{
+    if (Distance <= 0.0f)
+    {
+        OutTime = 0.0f;
+        return true;
+    }
+
+    const float HorizontalSpeed = FVector2f(LaunchVelocity.X, LaunchVelocity.Y).Size();
+    if (HorizontalSpeed <= UE_KINDA_SMALL_NUMBER)
+    {
+        return false;
+    }
+
+    // 抛物线阶段水平速度不变
+    const float ParabolaTime = Distance / HorizontalSpeed;
+    if (ParabolaTime <= LimitTime)
+    {
+        OutTime = ParabolaTime;
+        return true;
+    }
+
+    // 限速阶段：由水平位移反求 θ，再由 u = u1·e^(-kτ) 反求时间
+    const float Theta = Theta1 - (Distance - HorizontalSpeed * LimitTime) / TurnRadius;
+    if (Theta <= UE_KINDA_SMALL_NUMBER)
+    {
+        return false;
+    }
+
+    OutTime = LimitTime + FMath::Loge(U1 / FMath::Tan(0.5f * Theta)) / K;
+    return true;
+}
+
+// ------------------------------------------------------------------
+// 批量弹道
+// ------------------------------------------------------------------
+void FFPSTrajectoryBatch::Reset()
+{
+    Origins.Reset();
+    VelocityX.Reset();
+    VelocityY.Reset();
+    VelocityZ.Reset();
+    GravityZ.Reset();
+    LimitTime.Reset();
+    LimitDirectionX.Reset();
+    LimitDirectionY.Reset();
+    DownZ.Reset();
+    LimitSpeed.Reset();
+    K.Reset();
+    TurnRadius.Reset();
+    Theta1.Reset();
+    U1.Reset();
+    LogU1.Reset();
+}
+
+void FFPSTrajectoryBatch::Reserve(int32 InNum)
+{
+    Origins.Reserve(InNum);
+    VelocityX.Reserve(InNum);
+    VelocityY.Reserve(InNum);
+    VelocityZ.Reserve(InNum);
+    GravityZ.Reserve(InNum);
+    LimitTime.Reserve(InNum);
+    LimitDirectionX.Reserve(InNum);
+    LimitDirectionY.Reserve(InNum);
+    DownZ.Reserve(InNum);
+    LimitSpeed.Reserve(InNum);
+    K.Reserve(InNum);
+    TurnRadius.Reserve(InNum);
+    Theta1.Reserve(InNum);
+    U1.Reserve(InNum);
+    LogU1.Reserve(InNum);
+}
+
+int32 FFPSTrajectoryBatch::Add(const FFPSTrajectory& Trajectory)
+{
+    const int32 Index = Origins.Add(Trajectory.Origin);
+    VelocityX.Add(Trajectory.LaunchVelocity.X);
+    VelocityY.Add(Trajectory.LaunchVelocity.Y);
+    VelocityZ.Add(Trajectory.LaunchVelocity.Z);
+    GravityZ.Add(Trajectory.GravityZ);
+    LimitTime.Add(Trajectory.LimitTime);
+    LimitDirectionX.Add(Trajectory.LimitDirection.X);
+    LimitDirectionY.Add(Trajectory.LimitDirection.Y);
+    DownZ.Add(Trajectory.DownZ);
+    LimitSpeed.Add(Trajectory.LimitSpeed);
+    K.Add(Trajectory.K);
+    TurnRadius.Add(Trajectory.TurnRadius);
+    Theta1.Add(Trajectory.Theta1);
+    U1.Add(Trajectory.U1);
+    LogU1.Add(Trajectory.LogU1);
+    return Index;
+}
+
+void FFPSTrajectoryBatch::EvaluateLocations(TConstArrayView<float> Times, TArrayView<FVector> OutLocations) const
+{
+    const int32 Count = Num();
+    check(Times.Num() == Count && OutLocations.Num() == Count);
+
+    ParabolaTime.SetNumUninitialized(Count, EAllowShrinking::No);
+    LimitedTime.SetNumUninitialized(Count, EAllowShrinking::No);
+    Turn.SetNumUninitialized(Count, EAllowShrinking::No);
+    Drop.SetNumUninitialized(Count, EAllowShrinking::No);
+
+    // 两端的循环只做乘加，只访问连续的数组且无分支，由编译器向量化
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        ParabolaTime[Index] = FMath::Min(Times[Index], LimitTime[Index]);
+        LimitedTime[Index] = FMath::Max(Times[Index] - LimitTime[Index], 0.0f);
+    }
+
+    // 限速阶段含 exp / atan / log，编译器不会向量化标量库函数，这里每次显式处理 4 条弹道。
+    // 不限速或尚未进入限速阶段的弹道：τ = 0 且 u = u1，两项均为 0
+    const VectorRegister4Float Two = VectorSetFloat1(2.0f);
+    int32 First = 0;
+    for (; First + 4 <= Count; First += 4)
+    {
+        const VectorRegister4Float Tau = VectorLoad(&LimitedTime[First]);
+        const VectorRegister4Float Radius = VectorLoad(&TurnRadius[First]);
+        const VectorRegister4Float U = VectorMultiply(VectorLoad(&U1[First]), VectorExp(VectorNegate(VectorMultiply(VectorLoad(&K[First]), Tau))));
+        const VectorRegister4Float Angle = VectorSubtract(VectorLoad(&Theta1[First]), VectorMultiply(Two, VectorATan(U)));
+        const VectorRegister4Float LogU = VectorLog(VectorMultiplyAdd(U, U, VectorOne()));
+        VectorStore(VectorMultiply(Radius, Angle), &Turn[First]);
+        VectorStore(VectorSubtract(VectorMultiply(VectorLoad(&LimitSpeed[First]), Tau), VectorMultiply(Radius, VectorSubtract(VectorLoad(&LogU1[First]), LogU))), &Drop[First]);
+    }
+
+    // 不足 4 条的尾部
+    for (int32 Index = First; Index < Count; ++Index)
+    {
+        const float U = U1[Index] * FMath::Exp(-K[Index] * LimitedTime[Index]);
+        Turn[Index] = TurnRadius[Index] * (Theta1[Index] - 2.0f * FMath::Atan(U));
+        Drop[Index] = LimitSpeed[Index] * LimitedTime[Index] - TurnRadius[Index] * (LogU1[Index] - FMath::Loge(1.0f + U * U));
+    }
+
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const float Time = ParabolaTime[Index];
+        OutLocations[Index] = Origins[Index] + FVector(
+            VelocityX[Index] * Time + LimitDirectionX[Index] * Turn[Index],
+            VelocityY[Index] * Time + LimitDirectionY[Index] * Turn[Index],
+            VelocityZ[Index] * Time + 0.5f * GravityZ[Index] * Time * Time + DownZ[Index] * Drop[Index]);
+    }
+}
+
+// ------------------------------------------------------------------
+// 瞄准：静止目标
+// ------------------------------------------------------------------
+bool FPSBallistics::SolveAim(const FFPSBallisticParams& Params, const FVector& Origin, const FVector& Target, bool bHighArc, FFPSBallisticSolution& OutSolution)
+{
+    const float Speed = GetLaunchSpeed(Params);
+    if (Speed <= 0.0f)
+    {
+        return false;
+    }
+
+    const FVector Delta = Target - Origin;
+    const FVector2D HorizontalDelta(Delta.X, Delta.Y);
+    const float Distance = static_cast<float>(HorizontalDelta.Size());
+    const float Height = static_cast<float>(Delta.Z);
+    OutSolution.AimLocation = Target;
+
+    // 无重力时直线飞行；目标几乎在正上/下方时同样直接瞄准（忽略竖直方向的加减速）
+    if (Params.GravityZ == 0.0f || Distance < 1.0f)
+    {
+        OutSolution.Direction = Delta.GetSafeNormal(UE_SMALL_NUMBER, FVector::ForwardVector);
+        OutSolution.Time = static_cast<float>(Delta.Size()) / Speed;
+        OutSolution.LeadAngleDegrees = 0.0f;
+        return OutSolution.Time <= Params.LifeSpan;
+    }
+
+    // 在竖直平面内以仰角为自变量：到达目标水平距离时的高度（达不到时视为无穷低）
+    auto HeightAtPitch = [&Params, Distance](float Pitch, float& OutTime)
+    {
+        float SinPitch, CosPitch;
+        FMath::SinCos(&SinPitch, &CosPitch, Pitch);
+        const FFPSTrajectory Trajectory(Params, FVector::ZeroVector, FVector(CosPitch, 0.0f, SinPitch));
+        return Trajectory.GetTimeAtHorizontalDistance(Distance, OutTime)
+            ? static_cast<float>(Trajectory.GetLocation(OutTime).Z)
+            : TNumericLimits<float>::Lowest();
+    };
+
+    // 低伸解自下而上、高抛解自上而下扫描，找到第一个不低于目标的仰角后二分
+    const float MaxPitch = FMath::DegreesToRadians(MaxAimPitchDegrees);
+    const float PitchStep = (bHighArc ? -2.0f : 2.0f) * MaxPitch / NumAimScanSteps;
+
+    float PrevPitch = bHighArc ? MaxPitch : -MaxPitch;
+    float Time = 0.0f;
+    float SampleHeight = HeightAtPitch(PrevPitch, Time);
+    float BestPitch = PrevPitch;
+    float BestHeight = SampleHeight;
+    bool bFound = SampleHeight >= Height;
+    float SolutionPitch = PrevPitch;
+
+    for (int32 Step = 1; Step <= NumAimScanSteps && !bFound; ++Step)
+    {
+        const float Pitch = PrevPitch + PitchStep;
+        SampleHeight = HeightAtPitch(Pitch, Time);
+        if (SampleHeight > BestHeight)
+        {
+            BestHeight = SampleHeight;
+            BestPitch = Pitch;
+        }
+
+        if (SampleHeight >= Height)
+        {
+            // Below 一侧低于目标，Above 一侧不低于目标
+            float Below = PrevPitch;
+            float Above = Pitch;
+            for (int32 Bisect = 0; Bisect < NumAimBisectSteps; ++Bisect)
+            {
+                const float Mid = 0.5f * (Below + Above);
+                if (HeightAtPitch(Mid, Time) >= Height)
+                {
+                    Above = Mid;
+                }
+                else
+                {
+                    Below = Mid;
+                }
+            }
+            SolutionPitch = Above;
+            bFound = true;
+        }
+
+        PrevPitch = Pitch;
+    }
+
+    // 射程不足时给出能达到的最高点方向
+    if (!bFound)
+    {
+        SolutionPitch = BestPitch;
+    }
+    HeightAtPitch(SolutionPitch, Time);
+
+    float SinPitch, CosPitch;
+    FMath::SinCos(&SinPitch, &CosPitch, SolutionPitch);
+    const FVector2D Heading = HorizontalDelta / Distance;
+    OutSolution.Direction = FVector(Heading.X * CosPitch, Heading.Y * CosPitch, SinPitch);
+    OutSolution.Time = Time;
+    OutSolution.LeadAngleDegrees = GetAngleDegrees(OutSolution.Direction, Delta);
+    return bFound && Time <= Params.LifeSpan;
+}
+
+// ------------------------------------------------------------------
+// 瞄准：匀速移动目标
+// ------------------------------------------------------------------
+bool FPSBallistics::SolveIntercept(const FFPSBallisticParams& Params, const FVector& Origin, const FVector& TargetLocation, const FVector& TargetVelocity,
+    bool bHighArc, FFPSBallisticSolution& OutSolution)
+{
+    const float Speed = GetLaunchSpeed(Params);
+    if (Speed <= 0.0f)
+    {
+        return false;
+    }
+
+    const FVector Delta = TargetLocation - Origin;
+    bool bSolved = false;
+
+    if (Params.GravityZ == 0.0f)
+    {
+        // |Delta + Vt·t| = S·t  =>  (Vt·Vt - S²)·t² + 2(Delta·Vt)·t + Delta·Delta = 0，取最小正根
+        const double A = (TargetVelocity | TargetVelocity) - FMath::Square(static_cast<double>(Speed));
+        const double B = 2.0 * (Delta | TargetVelocity);
+        const double C = Delta | Delta;
+
+        double Time = -1.0;
+        if (FMath::Abs(A) < UE_KINDA_SMALL_NUMBER)
+        {
+            Time = B < 0.0 ? -C / B : -1.0;
+        }
+        else if (const double Discriminant = B * B - 4.0 * A * C; Discriminant >= 0.0)
+        {
+            const double Sqrt = FMath::Sqrt(Discriminant);
+            const double Root0 = (-B - Sqrt) / (2.0 * A);
+            const double Root1 = (-B + Sqrt) / (2.0 * A);
+            Time = Root0 > 0.0 && (Root1 <= 0.0 || Root0 < Root1) ? Root0 : Root1;
+        }
+
+        if (Time <= 0.0)
+        {
+            return false;
+        }
+
+        OutSolution.AimLocation = TargetLocation + TargetVelocity * Time;
+        OutSolution.Direction = (OutSolution.AimLocation - Origin).GetSafeNormal(UE_SMALL_NUMBER, FVector::ForwardVector);
+        OutSolution.Time = static_cast<float>(Time);
+        bSolved = OutSolution.Time <= Params.LifeSpan;
+    }
+    else
+    {
+        // 命中时间的不动点迭代：目标慢于子弹时收敛
+        float Time = static_cast<float>(Delta.Size()) / Speed;
+        for (int32 Iteration = 0; Iteration < MaxInterceptIterations; ++Iteration)
+        {
+            if (!SolveAim(Params, Origin, TargetLocation + TargetVelocity * Time, bHighArc, OutSolution))
+            {
+                break;
+            }
+
+            const bool bConverged = FMath::Abs(OutSolution.Time - Time) < InterceptTolerance;
+            Time = OutSolution.Time;
+            if (bConverged)
+            {
+                bSolved = true;
+                break;
+            }
+        }
+    }
+
+    OutSolution.LeadAngleDegrees = GetAngleDegrees(OutSolution.Direction, Delta);
+    return bSolved;
+}
+
+// ------------------------------------------------------------------
+// 第一次命中：沿弹道的弦逐段查询静态碰撞 BVH
+// ------------------------------------------------------------------
+bool FPSBallistics::FindFirstImpact(const FFPSTrajectory& Trajectory, const FFPSBallisticParams& Params, const FFPSStaticCollisionBVH& StaticCollision,
+    FFPSBallisticImpact& OutImpact)
+{
+    const int32 NumSegments = Trajectory.IsStraight()
+        ? 1
+        : FMath::Clamp(FMath::CeilToInt32(Params.LifeSpan / ImpactSegmentSeconds), 1, MaxImpactSegments);
+
+    FVector Start = Trajectory.GetOrigin();
+    float StartTime = 0.0f;
+    for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+    {
+        const float EndTime = Params.LifeSpan * Segment / NumSegments;
+        const FVector End = Trajectory.GetLocation(EndTime);
+
+        if (StaticCollision.SweepSphere(Start, End, Params.Radius, Params.CollisionChannel, OutImpact.Hit, FCollisionQueryParams::DefaultQueryParam))
+        {
+            OutImpact.Time = FMath::Lerp(StartTime, EndTime, OutImpact.Hit.Time);
+            OutImpact.Velocity = Trajectory.GetVelocity(OutImpact.Time);
+
+            // 与弹道子系统相同：按反弹系数反射法向速度
+            const FVector& Normal = OutImpact.Hit.Normal;
+            const double NormalSpeed = OutImpact.Velocity | Normal;
+            OutImpact.BounceVelocity = Params.Bounciness >= 0.0f && NormalSpeed < 0.0
+                ? OutImpact.Velocity - (1.0f + Params.Bounciness) * NormalSpeed * Normal
+                : FVector::ZeroVector;
+            return true;
+        }
+
+        Start = End;
+        StartTime = EndTime;
+    }
+
+    return false;
+}
+
+// ------------------------------------------------------------------
+// 控制台命令：fps.Ballistics.Benchmark [数量]
+// 随机弹道（受世界重力、限速 3000），对比固定步长积分的精度，并统计批量求值与瞄准求解的耗时
+// ------------------------------------------------------------------
+static void RunBallisticsBenchmark(const UWorld* World, int32 Count)
+{
+    FFPSBallisticParams Params;
+    Params.GravityZ = World->GetGravityZ();
+
+    FRandomStream Random(0x5EED);
+    FFPSTrajectoryBatch Batch;
+    Batch.Reserve(Count);
+    TArray<FFPSTrajectory> Trajectories;
+    TArray<float> Times;
+    TArray<FVector> Locations;
+    TArray<FVector> TargetVelocities;
+    Trajectories.Reserve(Count);
+    Times.Reserve(Count);
+    TargetVelocities.Reserve(Count);
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        const FVector Origin(Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(-5000.0f, 5000.0f), Random.FRandRange(0.0f, 1000.0f));
+        Batch.Add(Trajectories.Emplace_GetRef(Params, Origin, Random.GetUnitVector()));
+        Times.Add(Random.FRandRange(0.0f, Params.LifeSpan));
+        TargetVelocities.Add(FVector(Random.FRandRange(-300.0f, 300.0f), Random.FRandRange(-300.0f, 300.0f), 0.0f));
+    }
+    Locations.SetNumUninitialized(Count);
+
+    // 精度：与 UProjectileBallisticsSubsystem 相同的逐帧积分（先加重力再限速），步长 1/240 s
+    constexpr float StepSeconds = 1.0f / 240.0f;
+    double MaxStepError = 0.0;
+    for (int32 Index = 0; Index < FMath::Min(Count, 64); ++Index)
+    {
+        FVector Position = Trajectories[Index].GetOrigin();
+        FVector Velocity = Trajectories[Index].GetVelocity(0.0f);
+        for (float Elapsed = 0.0f; Elapsed < Times[Index]; Elapsed += StepSeconds)
+        {
+            const float Step = FMath::Min(StepSeconds, Times[Index] - Elapsed);
+            Velocity.Z += Params.GravityZ * Step;
+            Velocity = Velocity.GetClampedToMaxSize(Params.MaxSpeed);
+            Position += Velocity * Step;
+        }
+        MaxStepError = FMath::Max(MaxStepError, FVector::Dist(Position, Trajectories[Index].GetLocation(Times[Index])));
+    }
+
+    constexpr int32 NumRepeats = 20;
+    const double BatchStart = FPlatformTime::Seconds();
+    for (int32 Repeat = 0; Repeat < NumRepeats; ++Repeat)
+    {
+        Batch.EvaluateLocations(Times, Locations);
+    }
+    const double BatchSeconds = (FPlatformTime::Seconds() - BatchStart) / NumRepeats;
+
+    double MaxBatchError = 0.0;
+    const double ScalarStart = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        MaxBatchError = FMath::Max(MaxBatchError, FVector::Dist(Locations[Index], Trajectories[Index].GetLocation(Times[Index])));
+    }
+    const double ScalarSeconds = FPlatformTime::Seconds() - ScalarStart;
+
+    // 瞄准：以弹道上的点为目标（保证可达），用求出的方向重新求值检查误差
+    int32 NumAimSolved = 0;
+    double MaxAimError = 0.0;
+    const double AimStart = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        FFPSBallisticSolution Solution;
+        if (FPSBallistics::SolveAim(Params, Trajectories[Index].GetOrigin(), Locations[Index], false, Solution))
+        {
+            ++NumAimSolved;
+            const FFPSTrajectory Check(Params, Trajectories[Index].GetOrigin(), Solution.Direction);
+            MaxAimError = FMath::Max(MaxAimError, FVector::Dist(Check.GetLocation(Solution.Time), Locations[Index]));
+        }
+    }
+    const double AimSeconds = FPlatformTime::Seconds() - AimStart;
+
+    int32 NumInterceptSolved = 0;
+    double MaxInterceptError = 0.0;
+    const double InterceptStart = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        FFPSBallisticSolution Solution;
+        if (FPSBallistics::SolveIntercept(Params, Trajectories[Index].GetOrigin(), Locations[Index], TargetVelocities[Index], false, Solution))
+        {
+            ++NumInterceptSolved;
+            const FFPSTrajectory Check(Params, Trajectories[Index].GetOrigin(), Solution.Direction);
+            MaxInterceptError = FMath::Max(MaxInterceptError,
+                FVector::Dist(Check.GetLocation(Solution.Time), Locations[Index] + TargetVelocities[Index] * Solution.Time));
+        }
+    }
+    const double InterceptSeconds = FPlatformTime::Seconds() - InterceptStart;
+
+    UE_LOG(LogFPSDemo, Log, TEXT("Ballistics: %d trajectories (gravity %.0f, speed %.0f/%.0f)"), Count, Params.GravityZ, Params.InitialSpeed, Params.MaxSpeed);
+    UE_LOG(LogFPSDemo, Log, TEXT("  Max error vs 240 Hz stepping : %.2f cm"), MaxStepError);
+    UE_LOG(LogFPSDemo, Log, TEXT("  Batch evaluate   : %8.2f us  (%.1f ns each, max diff to scalar %.4f cm)"),
+        BatchSeconds * 1.0e6, BatchSeconds * 1.0e9 / Count, MaxBatchError);
+    UE_LOG(LogFPSDemo, Log, TEXT("  Scalar evaluate  : %8.2f us  (%.1f ns each)"), ScalarSeconds * 1.0e6, ScalarSeconds * 1.0e9 / Count);
+    UE_LOG(LogFPSDemo, Log, TEXT("  SolveAim         : %8.2f us  (%.2f us each, %d/%d solved, max miss %.2f cm)"),
+        AimSeconds * 1.0e6, AimSeconds * 1.0e6 / Count, NumAimSolved, Count, MaxAimError);
+    UE_LOG(LogFPSDemo, Log, TEXT("  SolveIntercept   : %8.2f us  (%.2f us each, %d/%d solved, max miss %.2f cm)"),
+        InterceptSeconds * 1.0e6, InterceptSeconds * 1.0e6 / Count, NumInterceptSolved, Count, MaxInterceptError);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GBallisticsBenchmarkCommand(
+    TEXT("fps.Ballistics.Benchmark"),
+    TEXT("测试解析弹道的精度（对比逐帧积分）与批量求值、瞄准求解的耗时。参数：弹道数量（默认 512）。"),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+    {
+        if (World)
+        {
+            RunBallisticsBenchmark(World, FMath::Max(Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 512, 1));
+        }
+    }));
@@ -0,0 +1,219 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Engine/HitResult.h"
+
+class AProjetileActor;
+class UFPSBallisticProfile;
+class FFPSStaticCollisionBVH;
+
+/**
+ * 一类子弹的弹道参数，与 AProjetileActor::ApplyBallisticProfile 的取值一致。
+ */
+struct FFPSBallisticParams
+{
+    /* 初速（cm/s） */
+    float InitialSpeed = 3000.0f;
+
+    /* 最大速度（cm/s），0 表示不限速 */
+    float MaxSpeed = 3000.0f;
+
+    /* 重力加速度（cm/s²，已乘重力缩放），0 表示直线飞行 */
+    float GravityZ = 0.0f;
+
+    /* 反弹系数，负数表示不反弹 */
+    float Bounciness = -1.0f;
+
+    /* 寿命（秒） */
+    float LifeSpan = 3.0f;
+
+    /* 碰撞球半径（cm） */
+    float Radius = 15.0f;
+
+    /* 碰撞对象类型 */
+    TEnumAsByte<ECollisionChannel> CollisionChannel = ECC_WorldDynamic;
+
+    /**
+     * 从子弹类默认值与弹道配置构造。
+     * @param ProjectileDefaults 子弹类的默认对象
+     * @param Profile            武器的弹道配置，为空时使用子弹类默认值
+     * @param WorldGravityZ      世界重力（UWorld::GetGravityZ）
+     */
+    static FFPSBallisticParams Make(const AProjetileActor& ProjectileDefaults, const UFPSBallisticProfile* Profile, float WorldGravityZ);
+};
+
+/**
+ * FFPSTrajectory
+ * 一发子弹的解析弹道，与 UProjectileBallisticsSubsystem 的逐帧积分（先加重力、再把速度限制到 MaxSpeed）一致：
+ *   第一阶段：速度低于 MaxSpeed，标准抛物线 p = v0·t + ½·g·t²；
+ *   第二阶段：速度达到 MaxSpeed 后保持该速率，重力只让速度方向转向下方。
+ *             记 θ 为速度与重力方向的夹角、k = |g| / MaxSpeed，则 tan(θ/2) 按 e^(-k·τ) 衰减，
+ *             水平与竖直位移均有闭式解。
+ * 构造时计算两阶段的常量，之后任意时刻的位置、速度都是 O(1) 求值，不经过物理场景。
+ * 不含碰撞：第一次命中由 FPSBallistics::FindFirstImpact 求出。
+ */
+class FPSDEMO_API FFPSTrajectory
+{
+public:
+    /**
+     * @param Params    弹道参数
+     * @param Origin    发射位置
+     * @param Direction 发射方向（无需归一化）
+     */
+    FFPSTrajectory(const FFPSBallisticParams& Params, const FVector& Origin, const FVector& Direction);
+
+    /* 发射后 Time 秒的位置 */
+    FVector GetLocation(float Time) const;
+
+    /* 发射后 Time 秒的速度 */
+    FVector GetVelocity(float Time) const;
+
+    /**
+     * 水平飞行距离达到 Distance 的时间。水平速度不会反向，因此结果唯一。
+     * @return 永远达不到（竖直发射，或限速阶段水平位移的渐近线不足 Distance）时返回 false
+     */
+    bool GetTimeAtHorizontalDistance(float Distance, float& OutTime) const;
+
+    /* 是否为直线（无重力） */
+    bool IsStraight() const { return GravityZ == 0.0f; }
+
+    const FVector& GetOrigin() const { return Origin; }
+
+private:
+    friend class FFPSTrajectoryBatch;
+
+    FVector Origin;
+
+    /* 第一阶段：初速度与重力 */
+    FVector3f LaunchVelocity;
+    float GravityZ = 0.0f;
+
+    /* 进入限速阶段的时间，不限速时为 float 最大值 */
+    float LimitTime = TNumericLimits<float>::Max();
+
+    /* 第二阶段：水平方向（单位向量，Z 为 0）与重力方向（±1） */
+    FVector2f LimitDirection = FVector2f::ZeroVector;
+    float DownZ = -1.0f;
+
+    /* 第二阶段：速率、k、MaxSpeed / k、进入时的 θ、tan(θ/2) 与 ln(1 + tan²(θ/2))；不限速时全为 0 */
+    float LimitSpeed = 0.0f;
+    float K = 0.0f;
+    float TurnRadius = 0.0f;
+    float Theta1 = 0.0f;
+    float U1 = 0.0f;
+    float LogU1 = 0.0f;
+};
+
+/**
+ * FFPSTrajectoryBatch
+ * 多条弹道的结构数组（SoA）形式，用于每帧大量求值（AI 瞄准、命中预览、服务器校验）。
+ * 两个阶段合并为一个无分支公式：抛物线部分取 min(t, LimitTime)，限速部分取 max(t - LimitTime, 0)，
+ * 不限速的弹道其第二阶段常量全为 0，贡献为 0。限速阶段的 exp / atan / log 以 VectorRegister4Float 每次求 4 条，
+ * 其余循环只访问连续数组，由编译器向量化。耗时与标量逐条求值的对比见 fps.Ballistics.Benchmark。
+ */
+class FPSDEMO_API FFPSTrajectoryBatch
+{
+public:
+    void Reset();
+    void Reserve(int32 Num);
+
+    /* 追加一条弹道，返回其下标 */
+    int32 Add(const FFPSTrajectory& Trajectory);
+
+    int32 Num() const { return Origins.Num(); }
+
+    /**
+     * 批量求位置：OutLocations[i] 为第 i 条弹道在 Times[i] 时刻的位置。
+     * Times 与 OutLocations 的长度须等于 Num()。
+     */
+    void EvaluateLocations(TConstArrayView<float> Times, TArrayView<FVector> OutLocations) const;
+
+private:
+    TArray<FVector> Origins;
+    TArray<float> VelocityX;
+    TArray<float> VelocityY;
+    TArray<float> VelocityZ;
+    TArray<float> GravityZ;
+    TArray<float> LimitTime;
+    TArray<float> LimitDirectionX;
+    TArray<float> LimitDirectionY;
+    TArray<float> DownZ;
+    TArray<float> LimitSpeed;
+    TArray<float> K;
+    TArray<float> TurnRadius;
+    TArray<float> Theta1;
+    TArray<float> U1;
+    TArray<float> LogU1;
+
+    /* 每次求值复用 */
+    mutable TArray<float> ParabolaTime;
+    mutable TArray<float> LimitedTime;
+    mutable TArray<float> Turn;
+    mutable TArray<float> Drop;
+};
+
+/* 瞄准求解的结果 */
+struct FFPSBallisticSolution
+{
+    /* 发射方向（单位向量） */
+    FVector Direction = FVector::ForwardVector;
+
+    /* 命中时间（秒） */
+    float Time = 0.0f;
+
+    /* 命中位置（移动目标为其预测位置） */
+    FVector AimLocation = FVector::ZeroVector;
+
+    /* 提前量：发射方向与当前视线（发射点指向目标当前位置）的夹角（度），包含重力下坠补偿 */
+    float LeadAngleDegrees = 0.0f;
+};
+
+/* 弹道与静态碰撞的第一次命中 */
+struct FFPSBallisticImpact
+{
+    FHitResult Hit;
+
+    /* 命中时间（秒） */
+    float Time = 0.0f;
+
+    /* 命中前的速度 */
+    FVector Velocity = FVector::ZeroVector;
+
+    /* 按反弹系数反射后的速度，不反弹时为 0 */
+    FVector BounceVelocity = FVector::ZeroVector;
+};
+
+/**
+ * 弹道预测接口：全部基于 FFPSTrajectory 的闭式解，不逐步模拟、不查询物理场景。
+ * 用法示例：AI 提前量瞄准、HUD 落点预览、服务器端射击校验。
+ * 统计与精度校验：fps.Ballistics.Benchmark。
+ */
+namespace FPSBallistics
+{
+    /**
+     * 求命中静止目标的发射方向。
+     * 无重力时直接指向目标；有重力时在发射点与目标所在的竖直平面内，对仰角做粗扫描 + 二分，
+     * 每次试探都是闭式求值（约 30 次）。
+     * 逐个目标求解，不做批量版本；单次耗时见 fps.Ballistics.Benchmark。
+     * @param bHighArc 取高抛解（默认取低伸解）
+     * @return 射程不足或命中时间超过寿命时返回 false，此时 OutSolution 为能达到的最高点方向
+     */
+    FPSDEMO_API bool SolveAim(const FFPSBallisticParams& Params, const FVector& Origin, const FVector& Target, bool bHighArc, FFPSBallisticSolution& OutSolution);
+
+    /**
+     * 求命中匀速移动目标的发射方向（提前量）。
+     * 无重力时为一元二次方程的解析解；有重力时对命中时间做不动点迭代，每次迭代调用 SolveAim。
+     */
+    FPSDEMO_API bool SolveIntercept(const FFPSBallisticParams& Params, const FVector& Origin, const FVector& TargetLocation, const FVector& TargetVelocity,
+        bool bHighArc, FFPSBallisticSolution& OutSolution);
+
+    /**
+     * 弹道在寿命内与静态关卡碰撞的第一次命中（落点 / 第一次反弹）。
+     * 弹道按时间切成若干弦（无重力时只有一段），每段用静态碰撞 BVH 做球形扫掠；不检测角色等动态物体。
+     */
+    FPSDEMO_API bool FindFirstImpact(const FFPSTrajectory& Trajectory, const FFPSBallisticParams& Params, const FFPSStaticCollisionBVH& StaticCollision,
+        FFPSBallisticImpact& OutImpact);
+}
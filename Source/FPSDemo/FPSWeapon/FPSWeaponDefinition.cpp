@@ -0,0 +1,11 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSWeapon/FPSWeaponDefinition.h"
+
+const FPrimaryAssetType UFPSWeaponDefinition::PrimaryAssetType = TEXT("FPSWeapon");
+const FName UFPSWeaponDefinition::EquippedBundle = TEXT("Equipped");
+
+FPrimaryAssetId UFPSWeaponDefinition::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(PrimaryAssetType, GetFName());
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "FPSWeapon/FPSWeaponTypes.h"
+#include "FPSWeaponDefinition.generated.h"
+
+class AProjetileActor;
+class UFPSBallisticProfile;
+
+/**
+ * UFPSWeaponDefinition
+ * 武器定义（主数据资产）：射速、开火方式、枪口偏移，以及子弹类与弹道配置的软引用。
+ * 装备时通过 UAssetManager 按 "Equipped" 资产包异步加载子弹类、弹道配置及其网格，卸下后释放。
+ */
+UCLASS(BlueprintType)
+class FPSDEMO_API UFPSWeaponDefinition : public UPrimaryDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /* 主资产类型，对应 DefaultGame.ini 中的 PrimaryAssetTypesToScan */
+    static const FPrimaryAssetType PrimaryAssetType;
+
+    /* 装备时加载的资产包 */
+    static const FName EquippedBundle;
+
+    virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+    /* 射击速率（每秒发射的子弹数） */
+    UPROPERTY(EditDefaultsOnly, Category = "Shoot", meta = (ClampMin = "0.1"))
+    float FireRate = 2.0f;
+
+    /* 开火方式 */
+    UPROPERTY(EditDefaultsOnly, Category = "Shoot")
+    EFPSFireMode FireMode = EFPSFireMode::Projectile;
+
+    /* 即时命中的最大射程（cm） */
+    UPROPERTY(EditDefaultsOnly, Category = "Shoot", meta = (EditCondition = "FireMode == EFPSFireMode::Hitscan"))
+    float HitscanRange = 10000.0f;
+
+    /* 即时命中的球形扫掠半径，0 表示使用射线 */
+    UPROPERTY(EditDefaultsOnly, Category = "Shoot", meta = (EditCondition = "FireMode == EFPSFireMode::Hitscan"))
+    float HitscanRadius = 0.0f;
+
+    /* 相对摄像机的枪口偏移 */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile")
+    FVector MuzzleOffset = FVector(100.0f, 0.0f, 0.0f);
+
+    /* 子弹类 */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (AssetBundles = "Equipped"))
+    TSoftClassPtr<AProjetileActor> ProjectileClass;
+
+    /* 弹道配置，为空时使用子弹类的默认值 */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (AssetBundles = "Equipped"))
+    TSoftObjectPtr<UFPSBallisticProfile> BallisticProfile;
+
+    /* 装备时预热到对象池中的子弹数量 */
+    UPROPERTY(EditDefaultsOnly, Category = "Projectile", meta = (ClampMin = "0"))
+    int32 PoolPrewarmCount = 16;
+};
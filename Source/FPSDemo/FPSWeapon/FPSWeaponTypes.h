@@ -0,0 +1,18 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FPSWeaponTypes.generated.h"
+
+/**
+ * 开火方式。
+ * Projectile：发射实体子弹（AProjetileActor）；
+ * Hitscan：通过异步射线/球形扫掠即时判定命中，不生成子弹。
+ */
+UENUM(BlueprintType)
+enum class EFPSFireMode : uint8
+{
+    Projectile  UMETA(DisplayName = "Projectile"),
+    Hitscan     UMETA(DisplayName = "Hitscan"),
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSWeapon/FireScheduler.h"
+
+// ------------------------------------------------------------------
+// 推进调度器：累积本帧欠下的全部射击
+// ------------------------------------------------------------------
+int32 FFireScheduler::Advance(double FrameStartTime, double FrameEndTime, double FireInterval, bool bTriggerHeld, TArray<double, TInlineAllocator<8>>& OutShotTimes)
+{
+    if (!bTriggerHeld || FireInterval <= 0.0)
+    {
+        // 松开扳机时保留 NextShotTime，冷却时间依然有效
+        bWasTriggerHeld = false;
+        return 0;
+    }
+
+    // 新一次按下扳机：按下的具体时刻未知，统一视为在本帧结束时开第一枪（冷却未结束则等待冷却）
+    if (!bWasTriggerHeld)
+    {
+        NextShotTime = FMath::Max(NextShotTime, FrameEndTime);
+    }
+    bWasTriggerHeld = true;
+
+    // 持续按住：发射区间 (.., FrameEndTime] 内所有到期的射击，剩余时间留给下一帧
+    int32 NumShots = 0;
+    while (NextShotTime <= FrameEndTime && NumShots < MaxShotsPerFrame)
+    {
+        OutShotTimes.Add(FMath::Max(NextShotTime, FrameStartTime));
+        NextShotTime += FireInterval;
+        ++NumShots;
+    }
+
+    // 超出单帧上限时放弃积压的射击，避免卡顿后的连锁补发
+    if (NextShotTime <= FrameEndTime)
+    {
+        NextShotTime = FrameEndTime + FireInterval;
+    }
+
+    return NumShots;
+}
+
+void FFireScheduler::Reset()
+{
+    NextShotTime = -UE_BIG_NUMBER;
+    bWasTriggerHeld = false;
+}
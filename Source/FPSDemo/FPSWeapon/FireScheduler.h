@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 一发待结算的射击。
+ * 同一帧内的多发射击各自拥有插值后的枪口变换与精确的开火时间戳。
+ */
+struct FFPSFireShot
+{
+    /* 枪口位置（按开火时间在上一帧与本帧之间插值） */
+    FVector MuzzleLocation;
+
+    /* 枪口朝向（按开火时间在上一帧与本帧之间球面插值） */
+    FRotator MuzzleRotation;
+
+    /* 开火时间（世界时间，秒） */
+    double Timestamp;
+
+    /* 服务器校验客户端射击时，射手开火时所看到的世界时间；0 表示不做延迟补偿 */
+    double RewindTime = 0.0;
+};
+
+/**
+ * FFireScheduler
+ * 与帧率无关的固定步长开火调度器。
+ * 以绝对时间记录下一发的开火时刻，每帧把 [帧开始, 帧结束] 区间内应发射的所有子弹一次性结算，
+ * 帧间剩余时间不会丢失，因此任意 Tick 频率下的实际射速都精确等于 FireRate。
+ */
+class FPSDEMO_API FFireScheduler
+{
+public:
+    /* 单帧最多结算的射击数量，防止长时间卡顿后一次性补发过多 */
+    static constexpr int32 MaxShotsPerFrame = 64;
+
+    /**
+     * 推进到本帧结束。
+     * @param FrameStartTime 本帧开始时的世界时间
+     * @param FrameEndTime   本帧结束时的世界时间
+     * @param FireInterval   两发之间的间隔（秒），即 1 / FireRate
+     * @param bTriggerHeld   本帧扳机是否按下
+     * @param OutShotTimes   追加本帧应发射的每一发的开火时间
+     * @return 本帧发射的数量
+     */
+    int32 Advance(double FrameStartTime, double FrameEndTime, double FireInterval, bool bTriggerHeld, TArray<double, TInlineAllocator<8>>& OutShotTimes);
+
+    /* 清空状态（例如切换武器时） */
+    void Reset();
+
+private:
+    /* 下一发允许开火的时间 */
+    double NextShotTime = -UE_BIG_NUMBER;
+
+    /* 上一帧扳机是否按下 */
+    bool bWasTriggerHeld = false;
+};
@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "FPSWeapon/HitscanTraceSubsystem.h"
+#include "FPSProjetile/ProjetileActor.h"
+#include "FPSNet/FPSLagCompensationSubsystem.h"
+#include "FPSEvents/FPSHitEventSubsystem.h"
+#include "FPSCharacter/FPSCharacter.h"
+#include "FPSDemo.h"
+#include "FPSDemoStats.h"
+#include "FPSBenchmark/FPSAllocationTracker.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/World.h"
+
+// ------------------------------------------------------------------
+// 仅在游戏世界（含 PIE）中创建
+// ------------------------------------------------------------------
+bool UHitscanTraceSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+    return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UHitscanTraceSubsystem::Deinitialize()
+{
+    PendingShots.Empty();
+    Super::Deinitialize();
+}
+
+TStatId UHitscanTraceSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UHitscanTraceSubsystem, STATGROUP_Tickables);
+}
+
+// ------------------------------------------------------------------
+// 排队：射线在帧末由引擎分发到工作线程执行，结果下一帧可取；
+// 需要延迟补偿时角色只按回溯后的命中盒判定，世界射线忽略 Pawn，只负责找出挡在前面的场景物体
+// ------------------------------------------------------------------
+void UHitscanTraceSubsystem::QueueShot(AActor* Shooter, const FVector& Start, const FVector& Direction, const FHitscanShotParams& Params)
+{
+    UWorld* World = GetWorld();
+    const FVector End = Start + Direction * Params.Range;
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FPSHitscan), false, Shooter);
+    const bool bRewind = Params.RewindTime > 0.0 && UFPSLagCompensationSubsystem::IsLagCompensationEnabled();
+
+    FPendingShot& Shot = PendingShots.AddDefaulted_GetRef();
+    Shot.Shooter = Shooter;
+    Shot.Start = Start;
+    Shot.Direction = Direction;
+    Shot.Range = Params.Range;
+    Shot.ImpactSpeed = Params.ImpactSpeed;
+    Shot.Damage = Params.Damage;
+    Shot.RewindTime = bRewind ? Params.RewindTime : 0.0;
+
+    // 与按预设检测相同的通道与响应，只是把 Pawn 改为忽略
+    FCollisionResponseTemplate Profile;
+    if (bRewind && UCollisionProfile::Get()->GetProfileTemplate(Params.CollisionProfile, Profile))
+    {
+        FCollisionResponseParams ResponseParams(Profile.ResponseToChannels);
+        ResponseParams.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore);
+
+        if (Params.Radius > 0.0f)
+        {
+            Shot.Handle = World->AsyncSweepByChannel(EAsyncTraceType::Single, Start, End, FQuat::Identity, Profile.ObjectType,
+                FCollisionShape::MakeSphere(Params.Radius), QueryParams, ResponseParams);
+        }
+        else
+        {
+            Shot.Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Start, End, Profile.ObjectType, QueryParams, ResponseParams);
+        }
+        return;
+    }
+
+    if (Params.Radius > 0.0f)
+    {
+        Shot.Handle = World->AsyncSweepByProfile(EAsyncTraceType::Single, Start, End, FQuat::Identity, Params.CollisionProfile,
+            FCollisionShape::MakeSphere(Params.Radius), QueryParams);
+    }
+    else
+    {
+        Shot.Handle = World->AsyncLineTraceByProfile(EAsyncTraceType::Single, Start, End, Params.CollisionProfile, QueryParams);
+    }
+}
+
+// ------------------------------------------------------------------
+// 每帧：一次性取回上一帧排队的全部结果
+// ------------------------------------------------------------------
+void UHitscanTraceSubsystem::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    if (PendingShots.Num() == 0)
+    {
+        return;
+    }
+
+    FPS_SCOPE_CYCLE_COUNTER(STAT_FPSHitscanResolve);
+    FPS_ALLOC_SCOPE(Shot);
+
+    UWorld* World = GetWorld();
+
+    int32 NumKept = 0;
+    for (int32 Index = 0; Index < PendingShots.Num(); ++Index)
+    {
+        const FPendingShot& Shot = PendingShots[Index];
+
+        if (World->QueryTraceData(Shot.Handle, TraceDataScratch))
+        {
+            ResolveShot(TraceDataScratch, Shot);
+        }
+        else if (World->IsTraceHandleValid(Shot.Handle, false))
+        {
+            // 本帧刚排队的射击，结果下一帧才可用，保留（原地紧凑排列）
+            PendingShots[NumKept++] = Shot;
+        }
+        // 其余为已过期的句柄，直接丢弃
+    }
+
+    PendingShots.SetNum(NumKept, EAllowShrinking::No);
+}
+
+// ------------------------------------------------------------------
+// 处理命中：与子弹 OnHit 相同，按“速度 × 冲量系数”对模拟物理的组件施加冲量，并推入命中事件；
+// 需要延迟补偿时，先检测回溯后的角色是否挡在世界命中点之前；此时世界命中不会是角色，
+// 当前位置的角色既不截断回溯射线，也不会被当作命中
+// ------------------------------------------------------------------
+void UHitscanTraceSubsystem::ResolveShot(const FTraceDatum& TraceData, const FPendingShot& Shot)
+{
+    const bool bRewind = Shot.RewindTime > 0.0;
+    const FHitResult* WorldHit = TraceData.OutHits.FindByPredicate([bRewind](const FHitResult& Hit)
+    {
+        // 网格体等非 Pawn 通道的组件仍可能被检测到，回溯时一并排除
+        return Hit.bBlockingHit && !(bRewind && Cast<APawn>(Hit.GetActor()));
+    });
+
+    if (bRewind)
+    {
+        if (const UFPSLagCompensationSubsystem* LagComp = GetWorld()->GetSubsystem<UFPSLagCompensationSubsystem>())
+        {
+            const FVector End = WorldHit ? WorldHit->Location : Shot.Start + Shot.Direction * Shot.Range;
+
+            FFPSRewindHit RewindHit;
+            if (LagComp->RewindLineTrace(Shot.Start, End, Shot.RewindTime, Shot.Shooter.Get(), RewindHit))
+            {
+                INC_DWORD_STAT(STAT_FPSHits);
+                INC_DWORD_STAT(STAT_FPSLagCompHits);
+                UE_LOG(LogFPSDemo, Verbose, TEXT("Hitscan: rewound hit on %s (%s) at %.1fcm, rewind %.1fms"),
+                    *GetNameSafe(RewindHit.Character), *RewindHit.BoneName.ToString(), RewindHit.Distance,
+                    (GetWorld()->GetTimeSeconds() - Shot.RewindTime) * 1000.0);
+
+                FFPSHitEvent Event;
+                Event.Kind = EFPSHitEventKind::CharacterHit;
+                Event.Source = EFPSHitEventSource::Hitscan;
+                Event.Instigator = Shot.Shooter;
+                Event.HitActor = RewindHit.Character;
+                Event.HitComponent = RewindHit.Character->GetCapsuleComponent();
+                Event.BoneName = RewindHit.BoneName;
+                Event.Location = RewindHit.Location;
+                Event.Direction = Shot.Direction;
+                Event.Magnitude = Shot.ImpactSpeed;
+                Event.Damage = Shot.Damage;
+                UFPSHitEventSubsystem::Push(GetWorld(), MoveTemp(Event));
+                return;
+            }
+        }
+    }
+
+    if (WorldHit)
+    {
+        INC_DWORD_STAT(STAT_FPSHits);
+        AProjetileActor::ApplyHitImpulse(WorldHit->GetComponent(), Shot.Direction * Shot.ImpactSpeed, WorldHit->ImpactPoint);
+
+        AActor* HitActor = WorldHit->GetActor();
+
+        FFPSHitEvent Event;
+        Event.Kind = Cast<APawn>(HitActor) ? EFPSHitEventKind::CharacterHit : EFPSHitEventKind::WorldHit;
+        Event.Source = EFPSHitEventSource::Hitscan;
+        Event.Instigator = Shot.Shooter;
+        Event.HitActor = HitActor;
+        Event.HitComponent = WorldHit->GetComponent();
+        Event.BoneName = WorldHit->BoneName;
+        Event.Location = WorldHit->ImpactPoint;
+        Event.Direction = Shot.Direction;
+        Event.Magnitude = Shot.ImpactSpeed;
+        Event.Damage = Shot.Damage;
+        UFPSHitEventSubsystem::Push(GetWorld(), MoveTemp(Event));
+    }
+}
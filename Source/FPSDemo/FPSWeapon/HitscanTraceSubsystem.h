@@ -0,0 +1,90 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "WorldCollision.h"
+#include "HitscanTraceSubsystem.generated.h"
+
+/**
+ * 即时命中（Hitscan）射击参数。
+ */
+struct FHitscanShotParams
+{
+    /* 最大射程（cm） */
+    float Range = 10000.0f;
+
+    /* 球形扫掠半径，0 表示使用射线 */
+    float Radius = 0.0f;
+
+    /* 计算命中冲量时使用的速度大小，与子弹初速一致才能得到相同的物理表现 */
+    float ImpactSpeed = 3000.0f;
+
+    /* 每次命中造成的伤害 */
+    float Damage = 10.0f;
+
+    /* 使用的碰撞预设，默认与子弹相同 */
+    FName CollisionProfile = TEXT("Projectile");
+
+    /* 大于 0 时，在该世界时间回溯角色命中盒做延迟补偿检测（服务器校验客户端射击时使用） */
+    double RewindTime = 0.0;
+};
+
+/**
+ * UHitscanTraceSubsystem
+ * 即时命中射击的批处理子系统。
+ * 开火时通过引擎的异步射线 API 排队（在工作线程上执行物理查询），
+ * 下一帧在本子系统的 Tick 中一次性取回所有结果并统一处理命中冲量，命中事件推入命中事件总线。
+ * 无论开火次数多少，游戏线程上的开销基本保持恒定。
+ */
+UCLASS()
+class FPSDEMO_API UHitscanTraceSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * 排队一次即时命中射击。
+     * @param Shooter   开火者，会被射线忽略
+     * @param Start     起点（枪口位置）
+     * @param Direction 归一化的射击方向
+     * @param Params    射程、半径等参数
+     */
+    void QueueShot(AActor* Shooter, const FVector& Start, const FVector& Direction, const FHitscanShotParams& Params);
+
+    /* 尚未取回结果的射击数量 */
+    int32 GetNumPendingShots() const { return PendingShots.Num(); }
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+protected:
+    virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+    virtual void Deinitialize() override;
+
+private:
+    /* 已排队、等待结果的射击 */
+    struct FPendingShot
+    {
+        FTraceHandle Handle;
+        TWeakObjectPtr<AActor> Shooter;
+        FVector Start;
+        FVector Direction;
+        float Range;
+        float ImpactSpeed;
+        float Damage;
+
+        /* 回溯时间，0 表示不做延迟补偿（排队时已按 fps.LagComp.Enable 决定） */
+        double RewindTime;
+    };
+
+    /* 处理一次射击的结果 */
+    void ResolveShot(const FTraceDatum& TraceData, const FPendingShot& Shot);
+
+    TArray<FPendingShot> PendingShots;
+
+    /* 复用的结果缓存，避免每次查询分配 */
+    FTraceDatum TraceDataScratch;
+};